@@ -0,0 +1,180 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_AUTOTUNE_HPP
+#define PIRANHA_AUTOTUNE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "exceptions.hpp"
+#include "runtime_info.hpp"
+#include "series.hpp"
+#include "settings.hpp"
+#include "tuning.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+template <typename Series>
+using autotune_enabler = typename std::enable_if<is_series<Series>::value && is_multipliable<Series>::value, int>::type;
+
+// Candidate block sizes for the terms of type Term. On top of a few fixed values, for each cache level
+// we consider the largest power of two such that two blocks of terms fit in the cache.
+template <typename Term>
+inline std::vector<unsigned long> autotune_block_sizes()
+{
+    std::vector<unsigned long> retval{64u, 128u, 256u, 512u, 1024u};
+    for (unsigned level = 1u; level <= 3u; ++level) {
+        const auto cs = runtime_info::get_cache_size(level);
+        if (!cs) {
+            continue;
+        }
+        unsigned long bs = 16u;
+        while (bs < 4096u && bs * 2u * 2u * sizeof(Term) <= cs) {
+            bs *= 2u;
+        }
+        retval.push_back(bs);
+    }
+    std::sort(retval.begin(), retval.end());
+    retval.erase(std::unique(retval.begin(), retval.end()), retval.end());
+    return retval;
+}
+
+// Best wall clock time (in seconds) of n_trials multiplications of s1 by s2.
+template <typename Series>
+inline double autotune_time(const Series &s1, const Series &s2, unsigned n_trials)
+{
+    double retval = std::numeric_limits<double>::max();
+    for (unsigned i = 0u; i < n_trials; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto res = s1 * s2;
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        // NOTE: use the result, so that the multiplication is not optimised away.
+        if (res.size() != std::numeric_limits<decltype(res.size())>::max()) {
+            retval = std::min(retval, elapsed.count());
+        }
+    }
+    return retval;
+}
+}
+
+/// Autotune the multiplication parameters.
+/**
+ * \note
+ * This function is enabled only if \p Series satisfies piranha::is_series and piranha::is_multipliable.
+ *
+ * This function will micro-benchmark the multiplication of \p s1 by \p s2, which should be representative of the
+ * multiplications that will be performed by the program, for different values of the tuning parameters, and it will
+ * then set the values yielding the best performance:
+ * - the multiplication block size for the term type of \p Series (see
+ *   piranha::tuning::get_multiplication_block_size()), chosen among a set of fixed values and the values that fit
+ *   the block in each level of the data cache,
+ * - if multiple threads are in use (see piranha::settings::get_n_threads()), the zone multiplier
+ *   (see piranha::tuning::get_multiplication_zone_multiplier()).
+ *
+ * Each configuration is timed \p n_trials times, and the best timing is retained. The chosen values can be saved
+ * with piranha::tuning::save_parameters(), so that later runs can load them without repeating the benchmark.
+ *
+ * In case of errors, the tuning parameters are reset to their original values.
+ *
+ * @param s1 the first operand.
+ * @param s2 the second operand.
+ * @param n_trials the number of times each configuration is timed.
+ *
+ * @return a pair containing the chosen block size and zone multiplier.
+ *
+ * @throws std::invalid_argument if \p n_trials is zero.
+ * @throws unspecified any exception thrown by the multiplication of \p s1 by \p s2, or by the methods of
+ * piranha::tuning.
+ */
+template <typename Series, autotune_enabler<Series> = 0>
+inline std::pair<unsigned long, unsigned long> autotune_multiplication(const Series &s1, const Series &s2,
+                                                                       unsigned n_trials = 3u)
+{
+    using term_type = typename Series::term_type;
+    if (unlikely(n_trials == 0u)) {
+        piranha_throw(std::invalid_argument, "the number of trials in the autotuning must be nonzero");
+    }
+    // NOTE: record also if a block size specific to term_type was set, so that in case of errors
+    // we do not leave behind a per-type value which was not there before.
+    const auto had_type_bs = tuning::has_multiplication_block_size<term_type>();
+    const auto old_bs = tuning::get_multiplication_block_size<term_type>();
+    const auto old_zm = tuning::get_multiplication_zone_multiplier();
+    try {
+        // Block size.
+        auto best_bs = old_bs;
+        auto best_time = std::numeric_limits<double>::max();
+        for (const auto &bs : autotune_block_sizes<term_type>()) {
+            tuning::set_multiplication_block_size<term_type>(bs);
+            const auto t = autotune_time(s1, s2, n_trials);
+            if (t < best_time) {
+                best_time = t;
+                best_bs = bs;
+            }
+        }
+        tuning::set_multiplication_block_size<term_type>(best_bs);
+        // Zone multiplier, used only in multithreaded mode.
+        auto best_zm = old_zm;
+        if (settings::get_n_threads() > 1u) {
+            best_time = std::numeric_limits<double>::max();
+            for (const unsigned long zm : {2u, 5u, 10u, 20u, 40u}) {
+                tuning::set_multiplication_zone_multiplier(zm);
+                const auto t = autotune_time(s1, s2, n_trials);
+                if (t < best_time) {
+                    best_time = t;
+                    best_zm = zm;
+                }
+            }
+        }
+        tuning::set_multiplication_zone_multiplier(best_zm);
+        return std::make_pair(best_bs, best_zm);
+    } catch (...) {
+        if (had_type_bs) {
+            tuning::set_multiplication_block_size<term_type>(old_bs);
+        } else {
+            tuning::reset_multiplication_block_size<term_type>();
+        }
+        tuning::set_multiplication_zone_multiplier(old_zm);
+        throw;
+    }
+}
+}
+
+#endif
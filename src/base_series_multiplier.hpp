@@ -37,6 +37,7 @@ see https://www.gnu.org/licenses/. */
 #include <iterator>
 #include <limits>
 #include <mutex>
+#include <numeric>
 #include <random>
 #include <stdexcept>
 #include <type_traits>
@@ -45,8 +46,8 @@ see https://www.gnu.org/licenses/. */
 
 #include "config.hpp"
 #include "detail/atomic_flag_array.hpp"
-#include "detail/atomic_lock_guard.hpp"
 #include "exceptions.hpp"
+#include "flat_hash_set.hpp"
 #include "key_is_multipliable.hpp"
 #include "math.hpp"
 #include "mp_integer.hpp"
@@ -240,6 +241,21 @@ public:
     using size_type = typename v_ptr::size_type;
     /// The size type of \p Series.
     using bucket_size_type = typename Series::size_type;
+    /// Estimate of the size of a series multiplication.
+    /**
+     * The structure holds a point estimate and the bounds of an approximate 95% confidence interval. The interval
+     * accounts only for the sampling error of an estimate which is biased low when the terms of the result are not
+     * generated with the same frequency (see base_series_multiplier::estimate_final_series_size_interval()): the
+     * lower bound is a conservative bound for the true size, but the true size can exceed the upper bound.
+     */
+    struct size_estimate {
+        /// Point estimate.
+        bucket_size_type estimate;
+        /// Lower bound of the confidence interval.
+        bucket_size_type lower;
+        /// Upper bound of the confidence interval.
+        bucket_size_type upper;
+    };
 
 private:
     // The default limit functor: it will include all terms in the second series.
@@ -253,6 +269,71 @@ private:
         }
         const size_type m_size2;
     };
+    // Estimate the number of distinct terms in the result of a multiplication from the (n_terms, n_coll) statistics of
+    // the sampling streams. The estimate D is the solution of sum_s (n_s - D * (1 - (1 - 1 / D)^n_s)) = c, that is,
+    // the number of equally-likely distinct terms which would produce on average c collisions in the streams.
+    static size_estimate estimate_from_stats(const std::vector<std::pair<size_type, size_type>> &stats,
+                                             const integer &n_tot_terms)
+    {
+        // NOTE: this will throw if the total number of terms does not fit in bucket_size_type.
+        const auto cap = static_cast<bucket_size_type>(n_tot_terms);
+        const double d_cap = static_cast<double>(cap);
+        // Expected number of collisions given d distinct terms.
+        auto exp_coll = [&stats](double d) -> double {
+            double retval = 0.;
+            for (const auto &p : stats) {
+                const double n = static_cast<double>(p.first);
+                retval += n + d * std::expm1(n * std::log1p(-1. / d));
+            }
+            return retval;
+        };
+        // Solve exp_coll(d) = c for d in [1, cap], via bisection in logarithmic scale.
+        auto solve = [&exp_coll, cap, d_cap](double c) -> bucket_size_type {
+            if (!(c > exp_coll(d_cap))) {
+                return cap;
+            }
+            if (!(c < exp_coll(1.))) {
+                return 1u;
+            }
+            double lo = 0., hi = std::log(d_cap);
+            for (int i = 0; i < 100 && hi - lo > 1E-9; ++i) {
+                const double mid = (lo + hi) / 2.;
+                // exp_coll is decreasing in d.
+                if (exp_coll(std::exp(mid)) > c) {
+                    lo = mid;
+                } else {
+                    hi = mid;
+                }
+            }
+            const double retval = std::round(std::exp((lo + hi) / 2.));
+            if (retval >= d_cap) {
+                return cap;
+            }
+            return retval < 1. ? bucket_size_type(1u) : static_cast<bucket_size_type>(retval);
+        };
+        double c = 0.;
+        for (const auto &p : stats) {
+            c += static_cast<double>(p.second);
+        }
+        // Approximate 95% confidence interval for the mean of a Poisson distribution with observed value c.
+        // NOTE: more collisions mean less distinct terms, hence the upper collision bound gives the lower size bound.
+        const double z = 1.96, delta = z * std::sqrt(c + z * z / 4.);
+        const auto upper = solve(c + z * z / 2. - delta), lower = solve(c + z * z / 2. + delta);
+        // No collisions observed: return the maximum number of terms.
+        const auto estimate = (c == 0.) ? cap : solve(c);
+        return size_estimate{estimate, (std::min)(lower, estimate), (std::max)(upper, estimate)};
+    }
+    // Rehash container if its load factor exceeds the maximum one. This is used at the end of the multiplication
+    // routines which insert terms via the low-level interface of hash_set, and which hence never grow the table.
+    static void grow_table(container_type &container, unsigned n_threads)
+    {
+        if (container.bucket_count() && container.load_factor() > container.max_load_factor()) {
+            container.rehash(
+                boost::numeric_cast<bucket_size_type>(
+                    std::ceil(static_cast<double>(container.size()) / container.max_load_factor())),
+                n_threads);
+        }
+    }
     // The purpose of this helper is to move in a coefficient series during insertion. For series,
     // we know that moves leave the series in a valid state, and series multiplications do not benefit
     // from an already-constructed destination - hence it is convenient to move them rather than copy.
@@ -269,7 +350,7 @@ private:
     // Implementation of finalise().
     template <typename T,
               typename std::enable_if<detail::is_mp_rational<typename T::term_type::cf_type>::value, int>::type = 0>
-    void finalise_impl(T &s) const
+    void finalise_impl(T &s, unsigned n_threads) const
     {
         // Nothing to do if the lcm is unitary.
         if (math::is_unitary(this->m_lcm)) {
@@ -280,7 +361,7 @@ private:
         const auto l2 = this->m_lcm * this->m_lcm;
         auto &container = s._container();
         // Single thread implementation.
-        if (m_n_threads == 1u) {
+        if (n_threads == 1u) {
             for (const auto &t : container) {
                 t.m_cf._set_den(l2);
                 t.m_cf.canonicalise();
@@ -289,15 +370,15 @@ private:
         }
         // Multi-thread implementation.
         // Buckets per thread.
-        const bucket_size_type bpt = static_cast<bucket_size_type>(container.bucket_count() / m_n_threads);
-        auto thread_func = [l2, &container, this, bpt](unsigned t_idx) {
+        const bucket_size_type bpt = static_cast<bucket_size_type>(container.bucket_count() / n_threads);
+        auto thread_func = [l2, &container, n_threads, bpt](unsigned t_idx) {
             bucket_size_type start_idx = static_cast<bucket_size_type>(t_idx * bpt);
             // Special handling for the last thread.
-            const bucket_size_type end_idx = t_idx == (this->m_n_threads - 1u)
+            const bucket_size_type end_idx = t_idx == (n_threads - 1u)
                                                  ? container.bucket_count()
                                                  : static_cast<bucket_size_type>((t_idx + 1u) * bpt);
             for (; start_idx != end_idx; ++start_idx) {
-                auto &list = container._get_bucket_list(start_idx);
+                const auto &list = container._get_bucket_list(start_idx);
                 for (const auto &t : list) {
                     t.m_cf._set_den(l2);
                     t.m_cf.canonicalise();
@@ -307,7 +388,7 @@ private:
         // Go with the threads.
         future_list<decltype(thread_func(0u))> ff_list;
         try {
-            for (unsigned i = 0u; i < m_n_threads; ++i) {
+            for (unsigned i = 0u; i < n_threads; ++i) {
                 ff_list.push_back(thread_pool::enqueue(i, thread_func, i));
             }
             // First let's wait for everything to finish.
@@ -321,7 +402,26 @@ private:
     }
     template <typename T,
               typename std::enable_if<!detail::is_mp_rational<typename T::term_type::cf_type>::value, int>::type = 0>
-    void finalise_impl(T &) const
+    void finalise_impl(T &, unsigned) const
+    {
+    }
+    // Implementation of finalise_terms().
+    template <typename T = Series,
+              typename std::enable_if<detail::is_mp_rational<typename T::term_type::cf_type>::value, int>::type = 0>
+    void finalise_terms_impl(std::vector<typename T::term_type> &v) const
+    {
+        if (math::is_unitary(this->m_lcm)) {
+            return;
+        }
+        const auto l2 = this->m_lcm * this->m_lcm;
+        for (auto &t : v) {
+            t.m_cf._set_den(l2);
+            t.m_cf.canonicalise();
+        }
+    }
+    template <typename T = Series,
+              typename std::enable_if<!detail::is_mp_rational<typename T::term_type::cf_type>::value, int>::type = 0>
+    void finalise_terms_impl(std::vector<typename T::term_type> &) const
     {
     }
 
@@ -387,12 +487,44 @@ public:
                 ctr2 = &m_zero_f2;
             }
         }
-        // Set the number of threads.
-        m_n_threads = (ctr1->size() && ctr2->size())
+        // Set the number of threads. Containers which cannot be filled concurrently bucket-by-bucket
+        // are always handled in a single thread.
+        m_n_threads = (ctr1->size() && ctr2->size() && detail::has_concurrent_buckets<container_type>::value)
                           ? thread_pool::use_threads(integer(ctr1->size()) * ctr2->size(),
                                                      integer(settings::get_min_work_per_thread()))
                           : 1u;
         this->fill_term_pointers(*ctr1, *ctr2, m_v1, m_v2);
+        // Detect squaring. In this case we make sure that m_v1 and m_v2 point to the same terms
+        // in the same order (e.g., for rational coefficients fill_term_pointers() created two separate copies).
+        m_square = (&s1 == &s2) && !s1.empty();
+        if (m_square) {
+            m_v2 = m_v1;
+        }
+    }
+
+    /// Estimate the size of the multiplication.
+    /**
+     * \note
+     * This method is enabled only if the key and coefficient types of \p Series satisfy
+     * piranha::key_is_multipliable.
+     *
+     * This method will estimate the number of terms in the result of the full (i.e., untruncated)
+     * multiplication of the series used during construction, using estimate_final_series_size_interval()
+     * with the key's multiplication arity and the key's <tt>multiply()</tt> method.
+     *
+     * @return the estimated size of the multiplication and a confidence interval for it.
+     *
+     * @throws unspecified any exception thrown by estimate_final_series_size_interval().
+     */
+    template <typename T = Series,
+              typename std::enable_if<key_is_multipliable<typename T::term_type::cf_type,
+                                                          typename T::term_type::key_type>::value,
+                                      int>::type
+              = 0>
+    size_estimate estimate_size() const
+    {
+        return estimate_final_series_size_interval<T::term_type::key_type::multiply_arity, plain_multiplier<false>>(
+            default_limit_functor{*this});
     }
 
 private:
@@ -424,8 +556,8 @@ protected:
      * base_series_multiplier::size_type and returning \p void. \p lf must be a function object
      * with a call operator accepting and returning a base_series_multiplier::size_type.
      *
-     * Internally, the double loops is decomposed in blocks of size tuning::get_multiplication_block_size() in an
-     * attempt to optimise cache memory access patterns.
+     * Internally, the double loops is decomposed in blocks of size tuning::get_multiplication_block_size() (as set for
+     * the term type of \p Series) in an attempt to optimise cache memory access patterns.
      *
      * This method is meant to be used for series multiplication. \p mf is intended to be a function object that
      * multiplies the <tt>i</tt>-th term of the first series by the <tt>j</tt>-th term of the second series.
@@ -450,9 +582,10 @@ protected:
             piranha_throw(std::invalid_argument, "invalid bounds in blocked_multiplication");
         }
         // Block size and number of regular blocks.
-        const size_type bsize = safe_cast<size_type>(tuning::get_multiplication_block_size()),
-                        nblocks1 = static_cast<size_type>((end1 - start1) / bsize),
-                        nblocks2 = static_cast<size_type>(m_v2.size() / bsize);
+        const size_type bsize
+            = safe_cast<size_type>(tuning::get_multiplication_block_size<typename Series::term_type>()),
+            nblocks1 = static_cast<size_type>((end1 - start1) / bsize),
+            nblocks2 = static_cast<size_type>(m_v2.size() / bsize);
         // Start and end of last (possibly irregular) blocks.
         const size_type i_ir_start = static_cast<size_type>(nblocks1 * bsize + start1), i_ir_end = end1;
         const size_type j_ir_start = static_cast<size_type>(nblocks2 * bsize), j_ir_end = m_v2.size();
@@ -513,7 +646,7 @@ protected:
     {
         blocked_multiplication(mf, start1, end1, default_limit_functor{*this});
     }
-    /// Estimate size of series multiplication.
+    /// Estimate size of series multiplication, with a confidence interval.
     /**
      * \note
      * If \p MultArity, \p MultFunctor or \p LimitFunctor do not satisfy the requirements outlined below,
@@ -525,30 +658,43 @@ protected:
      * passing \p this and a temporary local \p Series object as construction parameters.
      * It will be assumed that a call <tt>mf(i,j)</tt> multiplies the <tt>i</tt>-th
      * term of the first series by the <tt>j</tt>-th term of the second series, accumulating the result into the \p
-     * Series
-     * passed as second parameter for construction.
+     * Series passed as second parameter for construction.
      *
      * This method will apply a statistical approach to estimate the final size of the result of the multiplication of
-     * the first
-     * series by the second. It will perform random term-by-term multiplications
-     * and deduce the estimate from the number of term multiplications performed before finding the first duplicate
-     * term.
+     * the first series by the second. A fixed number of independent streams of random term-by-term multiplications
+     * is performed (each stream picking a random term of the second series for each term of the first series,
+     * in random order), and each stream is stopped as soon as a fixed number of collisions (that is, of
+     * term-by-term multiplications not generating new terms) has been observed, or when the terms of the first series
+     * are exhausted. The estimate is the number of distinct terms which, if all equally likely to be generated, would
+     * yield on average the number of distinct terms observed in the streams. The confidence interval is derived from
+     * an approximate 95% confidence interval on the number of collisions. If no collision is observed, the estimate
+     * is the total number of term-by-term multiplications times \p MultArity.
+     *
+     * The estimate is biased low: terms generated more frequently than others produce more collisions than
+     * equally-likely terms would, which is the common case in practice (e.g., in dense polynomial products the
+     * terms in the middle of the result are generated by many more term-by-term multiplications than the terms
+     * at the edges). The confidence interval accounts only for the sampling error, and hence it might not contain
+     * the true size, which can exceed the upper bound. The lower bound and the point estimate are thus conservative
+     * bounds for the true size, and estimate_final_series_size() applies a safety factor to the estimate for the
+     * purpose of sizing the result.
+     *
      * The \p MultArity parameter represents the arity of term multiplications - that is, the number of terms generated
-     * by a single
-     * term-by-term multiplication. It must be strictly positive.
+     * by a single term-by-term multiplication. It must be strictly positive.
      *
      * The \p lf parameter must be a function object exposing the same inteface as explained in
      * blocked_multiplication().
      * This functor establishes how many terms in the second series must be multiplied by the <tt>i</tt>-th term of the
      * first series.
      *
-     * The number returned by this function is always at least 1. Multiple threads might be used by this method: in such
-     * a case, different
+     * All the returned values are at least 1 and not greater than the total number of term-by-term multiplications
+     * times \p MultArity. Multiple threads might be used by this method: in such a case, different
      * instances of \p MultFunctor are constructed in different threads, but \p lf is shared among all threads.
+     * The returned values do not depend on the number of threads.
      *
      * @param lf the limit functor.
      *
-     * @return the estimated size of the multiplication of the first series by the second, always at least 1.
+     * @return the estimated size of the multiplication of the first series by the second, and a confidence
+     * interval for it.
      *
      * @throws std::overflow_error in case of (unlikely) overflows in integral arithmetics.
      * @throws unspecified any exception thrown by:
@@ -561,86 +707,68 @@ protected:
      * - future_list::push_back().
      */
     template <std::size_t MultArity, typename MultFunctor, typename LimitFunctor>
-    bucket_size_type estimate_final_series_size(const LimitFunctor &lf) const
+    size_estimate estimate_final_series_size_interval(const LimitFunctor &lf) const
     {
         PIRANHA_TT_CHECK(is_function_object, MultFunctor, void, const size_type &, const size_type &);
         PIRANHA_TT_CHECK(std::is_constructible, MultFunctor, const base_series_multiplier &, Series &);
         PIRANHA_TT_CHECK(is_function_object, LimitFunctor, size_type, const size_type &);
+        static_assert(MultArity > 0u, "Invalid multiplication arity.");
         // Cache these.
         const size_type size1 = m_v1.size(), size2 = m_v2.size();
         constexpr std::size_t result_size = MultArity;
-        // If one of the two series is empty, just return 0.
+        // If one of the two series is empty, just return 1.
         if (unlikely(!size1 || !size2)) {
-            return 1u;
+            return size_estimate{1u, 1u, 1u};
         }
         // If either series has a size of 1, just return size1 * size2 * result_size.
         if (size1 == 1u || size2 == 1u) {
-            return static_cast<bucket_size_type>(integer(size1) * size2 * result_size);
+            const auto retval = static_cast<bucket_size_type>(integer(size1) * size2 * result_size);
+            return size_estimate{retval, retval, retval};
         }
-        // NOTE: Hard-coded number of trials.
-        // NOTE: here consider that in case of extremely sparse series with few terms this will incur in noticeable
-        // overhead, since we will need many term-by-term before encountering the first duplicate.
-        const unsigned n_trials = 15u;
-        // NOTE: Hard-coded value for the estimation multiplier.
-        // NOTE: This value should be tuned for performance/memory usage tradeoffs.
-        const unsigned multiplier = 2u;
-        // Number of threads to use. If there are more threads than trials, then reduce
-        // the number of actual threads to use.
-        // NOTE: this is a bit different from usual, where we do not care if the workload per thread is zero.
-        // We do like this because n_trials is a small number and there still seems to be benefit in running
-        // just 1 trial per thread.
-        const unsigned n_threads = (n_trials >= m_n_threads) ? m_n_threads : n_trials;
+        // The total number of terms generated by the multiplication, an upper bound for the estimates.
+        integer n_tot_terms(0);
+        for (size_type i = 0u; i < size1; ++i) {
+            n_tot_terms += lf(i);
+        }
+        n_tot_terms *= result_size;
+        // Total truncation.
+        if (n_tot_terms.sign() == 0) {
+            return size_estimate{1u, 1u, 1u};
+        }
+        // NOTE: Hard-coded number of streams and of collisions per stream. The relative width of the confidence
+        // interval is roughly 4 / sqrt(n_streams * n_coll), the number of term-by-term multiplications
+        // needed to observe the collisions is roughly n_streams * sqrt(2 * n_coll * size).
+        const unsigned n_streams = 4u;
+        const size_type n_coll = 16u;
+        // Number of threads to use: each thread will process whole streams.
+        const unsigned n_threads = (n_streams >= m_n_threads) ? m_n_threads : n_streams;
         piranha_assert(n_threads > 0u);
-        // Trials per thread. This will always be at least 1.
-        const unsigned tpt = n_trials / n_threads;
-        piranha_assert(tpt >= 1u);
-        // The cumulative estimate.
-        integer c_estimate(0);
-        // Sync mutex - actually used only in multithreading.
-        std::mutex mut;
+        // For each stream, the number of generated terms and the number of collisions.
+        std::vector<std::pair<size_type, size_type>> stats(n_streams);
         // The estimation functor.
-        auto estimator = [&lf, size1, n_threads, multiplier, tpt, n_trials, this, &c_estimate, &mut,
-                          result_size](unsigned thread_idx) {
+        auto estimator = [&lf, size1, n_threads, n_streams, n_coll, this, &stats, result_size](unsigned thread_idx) {
             piranha_assert(thread_idx < n_threads);
             // Vectors of indices into m_v1.
             std::vector<size_type> v_idx1(safe_cast<typename std::vector<size_type>::size_type>(size1));
-            std::iota(v_idx1.begin(), v_idx1.end(), size_type(0));
-            // Copy in order to reset to initial state later.
-            const auto v_idx1_copy = v_idx1;
             // Random number engine.
             std::mt19937 engine;
             // Uniform int distribution.
             using dist_type = std::uniform_int_distribution<size_type>;
             dist_type dist;
-            // Init the accumulated estimation for averaging later.
-            integer acc(0);
-            // Number of trials for this thread - usual special casing for the last thread.
-            const unsigned cur_trials = (thread_idx == n_threads - 1u) ? (n_trials - thread_idx * tpt) : tpt;
-            // This should always be guaranteed because tpt is never 0.
-            piranha_assert(cur_trials > 0u);
             // Create and setup the temp series.
             Series tmp;
             tmp.set_symbol_set(m_ss);
             // Create the multiplier.
             MultFunctor mf(*this, tmp);
-            // Go with the trials.
-            for (auto n = 0u; n < cur_trials; ++n) {
-                // Seed the engine. The seed should be the global trial number, accounting for multiple
-                // threads. This way the estimation will not depend on the number of threads.
-                engine.seed(static_cast<std::mt19937::result_type>(tpt * thread_idx + n));
-                // Reset the indices vector and re-randomise it.
-                // NOTE: we need to do this as every run inside this for loop must be completely independent
-                // of any previous run, we cannot keep any state.
-                v_idx1 = v_idx1_copy;
+            for (auto s = thread_idx; s < n_streams; s += n_threads) {
+                // Seed the engine with the stream index. This way the estimation will not depend
+                // on the number of threads.
+                engine.seed(static_cast<std::mt19937::result_type>(s));
+                std::iota(v_idx1.begin(), v_idx1.end(), size_type(0));
                 std::shuffle(v_idx1.begin(), v_idx1.end(), engine);
-                // The counter. This will be increased each time a term-by-term multiplication
-                // does not generate a duplicate term.
-                size_type count = 0u;
-                // This will be used to determine the average number of terms in s2
-                // that participate in the multiplication.
-                integer acc_s2(0);
-                auto it1 = v_idx1.begin();
-                for (; it1 != v_idx1.end(); ++it1) {
+                // Number of generated terms and of collisions.
+                size_type n_terms = 0u, coll = 0u;
+                for (auto it1 = v_idx1.begin(); it1 != v_idx1.end() && coll < n_coll; ++it1) {
                     // Get the limit idx in s2.
                     const size_type limit = lf(*it1);
                     // This is the upper limit of an open ended interval, so it needs
@@ -649,51 +777,28 @@ protected:
                     if (limit == 0u) {
                         continue;
                     }
-                    acc_s2 += limit;
                     // Pick a random index in m_v2 within the limit.
                     const size_type idx2
                         = dist(engine, typename dist_type::param_type(static_cast<size_type>(0u),
                                                                       static_cast<size_type>(limit - 1u)));
                     // Perform term multiplication.
                     mf(*it1, idx2);
-                    // Check for unlikely overflows when increasing count.
+                    // Check for unlikely overflows when increasing n_terms.
                     if (unlikely(result_size > std::numeric_limits<size_type>::max()
-                                 || count > std::numeric_limits<size_type>::max() - result_size)) {
+                                 || n_terms > std::numeric_limits<size_type>::max() - result_size)) {
                         piranha_throw(std::overflow_error, "overflow error");
                     }
-                    if (tmp.size() != count + result_size) {
-                        break;
-                    }
-                    // Increase cycle variables.
-                    count = static_cast<size_type>(count + result_size);
+                    n_terms = static_cast<size_type>(n_terms + result_size);
+                    // NOTE: the size of tmp could be smaller than the number of distinct terms generated if
+                    // there are cancellations: these are counted as collisions.
+                    const auto n_distinct = static_cast<size_type>(tmp.size());
+                    coll = (n_distinct < n_terms) ? static_cast<size_type>(n_terms - n_distinct) : size_type(0u);
                 }
-                integer add;
-                if (it1 == v_idx1.end()) {
-                    // We never found a duplicate. count is now the number of terms in s1
-                    // which actually participate in the multiplication, while acc_s2 / count
-                    // is the average number of terms in s2 that participate in the multiplication.
-                    // The result will be then count * acc_s2 / count = acc_s2.
-                    add = acc_s2;
-                } else {
-                    // If we found a duplicate, we use the heuristic.
-                    add = integer(multiplier) * count * count;
-                }
-                // Fix if zero, so that the average later never results in zero.
-                if (add.sign() == 0) {
-                    add = 1;
-                }
-                acc += add;
+                // Each stream writes its own slot, no locking needed.
+                stats[s] = std::make_pair(n_terms, coll);
                 // Reset tmp.
                 tmp._container().clear();
             }
-            // Accumulate in the shared variable.
-            if (n_threads == 1u) {
-                // No locking needed.
-                c_estimate += acc;
-            } else {
-                std::lock_guard<std::mutex> lock(mut);
-                c_estimate += acc;
-            }
         };
         // Run the estimation functor.
         if (n_threads == 1u) {
@@ -713,9 +818,38 @@ protected:
                 throw;
             }
         }
-        piranha_assert(c_estimate >= n_trials);
-        // Return the mean.
-        return static_cast<bucket_size_type>(c_estimate / n_trials);
+        return estimate_from_stats(stats, n_tot_terms);
+    }
+    /// Estimate size of series multiplication.
+    /**
+     * This method is meant to be used to size the table of the result of the multiplication. It will return
+     * the point estimate computed by estimate_final_series_size_interval() multiplied by a safety factor (which
+     * compensates for the bias of the estimate), capped to the total number of term-by-term multiplications
+     * times \p MultArity.
+     *
+     * @param lf the limit functor.
+     *
+     * @return the estimated size of the multiplication, including a safety factor.
+     *
+     * @throws unspecified any exception thrown by:
+     * - estimate_final_series_size_interval(),
+     * - the call operator of \p lf,
+     * - the conversion operator of piranha::integer.
+     */
+    template <std::size_t MultArity, typename MultFunctor, typename LimitFunctor>
+    bucket_size_type estimate_final_series_size(const LimitFunctor &lf) const
+    {
+        // NOTE: Hard-coded value for the estimation multiplier.
+        // NOTE: This value should be tuned for performance/memory usage tradeoffs.
+        const unsigned multiplier = 2u;
+        const auto est = estimate_final_series_size_interval<MultArity, MultFunctor>(lf).estimate;
+        integer n_tot_terms(0);
+        for (size_type i = 0u; i < m_v1.size(); ++i) {
+            n_tot_terms += lf(i);
+        }
+        n_tot_terms *= MultArity;
+        // NOTE: the estimate is never zero and, when the series are not empty, never larger than n_tot_terms.
+        return (std::max)(est, static_cast<bucket_size_type>((std::min)(integer(est) * multiplier, n_tot_terms)));
     }
     /// Estimate size of series multiplication (convenience overload)
     /**
@@ -833,7 +967,9 @@ protected:
      * This method can be used to fix these invariants: each term of \p retval will be checked for ignorability and
      * compatibility,
      * and the total count of terms in the series will be set to the number of non-ignorable terms. Ignorable terms will
-     * be erased.
+     * be erased. Finally, if the load factor of \p retval exceeds the maximum load factor (e.g., because the size
+     * of the result was underestimated before the multiplication), the table of \p retval will be rehashed to
+     * an appropriate number of buckets.
      *
      * Note that in case of exceptions \p retval will likely be left in an inconsistent state which violates internal
      * invariants.
@@ -852,7 +988,8 @@ protected:
      * - the cast operator of piranha::integer,
      * - standard threading primitives,
      * - thread_pool::enqueue(),
-     * - future_list::push_back().
+     * - future_list::push_back(),
+     * - piranha::hash_set::rehash().
      */
     static void sanitise_series(Series &retval, unsigned n_threads)
     {
@@ -882,6 +1019,7 @@ protected:
                     ++it;
                 }
             }
+            grow_table(container, 1u);
             return;
         }
         // Multi-thread implementation.
@@ -948,6 +1086,7 @@ protected:
         }
         // Final update of the total count.
         container._update_size(static_cast<bucket_size_type>(global_count));
+        grow_table(container, n_threads);
     }
     /// A plain series multiplication routine.
     /**
@@ -963,7 +1102,9 @@ protected:
      * The implementation is either single-threaded or multi-threaded, depending on the sizes of the input series, and
      * it will use
      * either base_series_multiplier::plain_multiplier or a similar thread-safe multiplier for the term-by-term
-     * multiplications.
+     * multiplications. In multithreaded mode, the buckets of the output series are partitioned into zones: each thread
+     * accumulates its products in a private buffer per zone, and inserts a buffer into the output series as a batch
+     * while holding the lock of the zone.
      * The \p lf functor will be forwarded as limit functor to base_series_multiplier::blocked_multiplication()
      * and base_series_multiplier::estimate_final_series_size().
      *
@@ -1048,8 +1189,19 @@ protected:
         }
         // Multi-threaded case.
         piranha_assert(estimate);
-        // Init the vector of spinlocks.
-        detail::atomic_flag_array sl_array(safe_cast<std::size_t>(retval._container().bucket_count()));
+        // NOTE: instead of locking the destination bucket of each term-by-term product, the buckets of retval are
+        // partitioned into zones, each protected by a spinlock. Each thread stages its products in per-zone buffers,
+        // and flushes a full buffer into the corresponding zone while holding the zone's lock. A full buffer is
+        // flushed only if the lock is free, unless the buffer has grown past a hard limit: threads hitting a busy zone
+        // keep on multiplying instead of spinning, and the cost of the locking is amortised over a whole batch.
+        const bucket_size_type b_count = retval._container().bucket_count();
+        // NOTE: these are tuning parameters.
+        const bucket_size_type n_zones
+            = std::min<bucket_size_type>(b_count, static_cast<bucket_size_type>(n_threads * 4u));
+        const bucket_size_type zone_size = static_cast<bucket_size_type>(b_count / n_zones + (b_count % n_zones != 0u));
+        const std::size_t batch_size = 64u, max_batch_size = 256u;
+        // Init the vector of spinlocks, one per zone.
+        detail::atomic_flag_array zone_locks(safe_cast<std::size_t>(n_zones));
         // Init the future list.
         future_list<void> f_list;
         // Thread block size.
@@ -1057,36 +1209,83 @@ protected:
         try {
             for (size_type idx = 0u; idx < n_threads; ++idx) {
                 // Thread functor.
-                auto tf = [idx, this, block_size, n_threads, &sl_array, &retval, &lf]() {
+                auto tf = [idx, this, block_size, n_threads, n_zones, zone_size, batch_size, max_batch_size,
+                           &zone_locks, &retval, &lf]() {
                     // Used to store the result of term multiplication.
                     std::array<term_type, key_type::multiply_arity> tmp_t;
+                    auto &container = retval._container();
                     // End of retval container (thread-safe).
-                    const auto c_end = retval._container().end();
+                    const auto c_end = container.end();
+                    // The staging buffers, containing the products and their destination buckets.
+                    std::vector<std::vector<std::pair<bucket_size_type, term_type>>> buffers(
+                        safe_cast<std::size_t>(n_zones));
+                    // Insert the content of the buffer of zone z into retval. The lock of the zone must
+                    // have been acquired, and it will be released on exit.
+                    auto flush = [&container, &c_end, &buffers, &zone_locks](const bucket_size_type &z) {
+                        auto &buffer = buffers[static_cast<std::size_t>(z)];
+                        auto &zl = zone_locks[static_cast<std::size_t>(z)];
+                        try {
+                            for (auto &p : buffer) {
+                                const auto it = container._find(p.second, p.first);
+                                if (it == c_end) {
+                                    container._unique_insert(std::move(p.second), p.first);
+                                } else {
+                                    it->m_cf += p.second.m_cf;
+                                }
+                            }
+                        } catch (...) {
+                            zl.clear(std::memory_order_release);
+                            throw;
+                        }
+                        zl.clear(std::memory_order_release);
+                        buffer.clear();
+                    };
                     // Block functor.
-                    // NOTE: this is very similar to the plain functor, but it does the bucket locking
-                    // additionally.
-                    auto f = [&c_end, &tmp_t, this, &retval, &sl_array](const size_type &i, const size_type &j) {
+                    auto f = [&container, &tmp_t, this, &retval, &buffers, &zone_locks, &flush, zone_size,
+                              batch_size, max_batch_size](const size_type &i, const size_type &j) {
                         // Run the term multiplication.
                         key_type::multiply(tmp_t, *(this->m_v1[i]), *(this->m_v2[j]), retval.get_symbol_set());
                         for (std::size_t n = 0u; n < key_type::multiply_arity; ++n) {
-                            auto &container = retval._container();
                             auto &tmp_term = tmp_t[n];
-                            // Try to locate the term into retval.
-                            auto bucket_idx = container._bucket(tmp_term);
-                            // Lock the bucket.
-                            detail::atomic_lock_guard alg(sl_array[static_cast<std::size_t>(bucket_idx)]);
-                            const auto it = container._find(tmp_term, bucket_idx);
-                            if (it == c_end) {
-                                container._unique_insert(term_insertion(tmp_term), bucket_idx);
+                            const auto bucket_idx = container._bucket(tmp_term);
+                            const auto z = static_cast<bucket_size_type>(bucket_idx / zone_size);
+                            auto &buffer = buffers[static_cast<std::size_t>(z)];
+                            // Move the product into the buffer, and reset tmp_term to the default-constructed
+                            // state it had before the first multiplication.
+                            buffer.emplace_back(bucket_idx, std::move(tmp_term));
+                            tmp_term = term_type{};
+                            if (buffer.size() < batch_size) {
+                                continue;
+                            }
+                            auto &zl = zone_locks[static_cast<std::size_t>(z)];
+                            if (buffer.size() < max_batch_size) {
+                                if (zl.test_and_set(std::memory_order_acquire)) {
+                                    // The zone is busy, try again later.
+                                    continue;
+                                }
                             } else {
-                                it->m_cf += tmp_term.m_cf;
+                                while (zl.test_and_set(std::memory_order_acquire)) {
+                                }
                             }
+                            flush(z);
                         }
                     };
                     // Thread block limit.
                     const auto e1
                         = (idx == n_threads - 1u) ? this->m_v1.size() : static_cast<size_type>((idx + 1u) * block_size);
                     this->blocked_multiplication(f, static_cast<size_type>(idx * block_size), e1, lf);
+                    // Flush the remaining content of the buffers. Each thread starts from a different zone,
+                    // in order to reduce contention.
+                    const auto z_start = static_cast<bucket_size_type>(n_zones / n_threads * idx);
+                    for (bucket_size_type k = 0u; k < n_zones; ++k) {
+                        const auto z = static_cast<bucket_size_type>((z_start + k) % n_zones);
+                        if (buffers[static_cast<std::size_t>(z)].empty()) {
+                            continue;
+                        }
+                        while (zone_locks[static_cast<std::size_t>(z)].test_and_set(std::memory_order_acquire)) {
+                        }
+                        flush(z);
+                    }
                 };
                 f_list.push_back(thread_pool::enqueue(static_cast<unsigned>(idx), tf));
             }
@@ -1131,7 +1330,95 @@ protected:
      */
     void finalise_series(Series &s) const
     {
-        finalise_impl(s);
+        finalise_impl(s, m_n_threads);
+    }
+    /// Finalise series with a given number of threads.
+    /**
+     * This method is equivalent to the other overload of finalise_series(), but it will use \p n_threads threads
+     * instead of base_series_multiplier::m_n_threads. It is useful, for instance, to finalise a series in a thread
+     * of piranha::thread_pool, in which case \p n_threads must be 1.
+     *
+     * @param s the \p Series to be finalised.
+     * @param n_threads the number of threads to use.
+     *
+     * @throws std::invalid_argument if \p n_threads is zero.
+     * @throws unspecified any exception thrown by the other overload of finalise_series().
+     */
+    void finalise_series(Series &s, unsigned n_threads) const
+    {
+        if (unlikely(n_threads == 0u)) {
+            piranha_throw(std::invalid_argument, "invalid number of threads");
+        }
+        finalise_impl(s, n_threads);
+    }
+    /// Finalise a vector of terms.
+    /**
+     * This method is equivalent to finalise_series(), but it will operate on the terms stored in \p v, which
+     * are assumed to be the output of a series multiplication undertaken via piranha::base_series_multiplier.
+     *
+     * @param v the vector of terms to be finalised.
+     */
+    void finalise_terms(std::vector<typename Series::term_type> &v) const
+    {
+        finalise_terms_impl(v);
+    }
+
+    /// Diagonal of a squaring.
+    /**
+     * \note
+     * This method can be called only if base_series_multiplier::m_square is \p true, and before
+     * square_double().
+     *
+     * This method will return a series containing the sum of the products of the <tt>i</tt>-th term in
+     * base_series_multiplier::m_v1 by the <tt>i</tt>-th term in base_series_multiplier::m_v2, for all the indices
+     * \p i for which <tt>p(i)</tt> returns \p true. The returned series has not been finalised (see
+     * finalise_series()).
+     *
+     * @param p the predicate used to select the diagonal products.
+     *
+     * @return the sum of the selected diagonal products.
+     *
+     * @throws unspecified any exception thrown by base_series_multiplier::plain_multiplier and by \p p.
+     */
+    template <typename Pred>
+    Series square_diagonal(const Pred &p) const
+    {
+        piranha_assert(m_square && m_v1 == m_v2);
+        Series retval;
+        retval.set_symbol_set(m_ss);
+        plain_multiplier<false> pm(*this, retval);
+        for (size_type i = 0u; i < m_v1.size(); ++i) {
+            if (p(i)) {
+                pm(i, i);
+            }
+        }
+        return retval;
+    }
+    /// Double the coefficients of the first series for squaring.
+    /**
+     * \note
+     * This method can be called only if base_series_multiplier::m_square is \p true.
+     *
+     * This method will replace the pointers in base_series_multiplier::m_v1 with pointers to copies of the
+     * terms in which the coefficients have been doubled. The multiplication of the <tt>i</tt>-th term in \p m_v1 by
+     * the <tt>j</tt>-th term in base_series_multiplier::m_v2, with <tt>j < i</tt>, will then account for both the
+     * <tt>(i,j)</tt> and <tt>(j,i)</tt> products of a squaring. The diagonal products can be computed separately with
+     * square_diagonal().
+     *
+     * @throws unspecified any exception thrown by memory allocation errors in standard containers, term copy
+     * construction and the in-place addition of coefficients.
+     */
+    void square_double() const
+    {
+        piranha_assert(m_square);
+        m_doubled_terms.clear();
+        m_doubled_terms.reserve(m_v1.size());
+        for (const auto &ptr : m_v1) {
+            m_doubled_terms.push_back(*ptr);
+            m_doubled_terms.back().m_cf += ptr->m_cf;
+        }
+        std::transform(m_doubled_terms.begin(), m_doubled_terms.end(), m_v1.begin(),
+                       [](const typename Series::term_type &t) { return &t; });
     }
 
 protected:
@@ -1145,14 +1432,24 @@ protected:
     /**
      * This value will be set by the constructor, and it represents the number of threads
      * that will be used by the multiplier. The value is always at least 1 and it is calculated
-     * via thread_pool::use_threads().
+     * via thread_pool::use_threads(). It is always 1 if the terms of \p Series are stored in a
+     * piranha::flat_hash_set.
      */
     unsigned m_n_threads;
+    /// Squaring flag.
+    /**
+     * This flag is set by the constructor to \p true if the two input series are the same non-empty object. In this
+     * case, base_series_multiplier::m_v1 and base_series_multiplier::m_v2 are guaranteed to contain the same pointers,
+     * in the same order.
+     */
+    bool m_square;
 
 private:
     // See the constructor for an explanation.
     container_type m_zero_f1;
     container_type m_zero_f2;
+    // Storage for the terms with doubled coefficients used in squaring.
+    mutable std::vector<typename Series::term_type> m_doubled_terms;
 };
 }
 
@@ -0,0 +1,174 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_FFT_HPP
+#define PIRANHA_DETAIL_FFT_HPP
+
+#include <algorithm>
+#include <boost/math/constants/constants.hpp>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../config.hpp"
+
+namespace piranha
+{
+namespace detail
+{
+
+// NOTE: complex multiplication is written explicitly, in order to avoid the special handling of infinities and NaNs
+// mandated by the standard for std::complex.
+inline std::complex<double> fft_cmul(const std::complex<double> &a, const std::complex<double> &b)
+{
+    return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(),
+                                a.real() * b.imag() + a.imag() * b.real());
+}
+
+// Iterative radix-2 FFT, in place. The size of v must be a power of two. If inverse is true, the inverse
+// transform is computed, without the 1/n normalisation.
+// NOTE: the twiddle factors are computed directly via cos() and sin(), rather than via recurrences, so that
+// their error is of the order of the machine epsilon. This is assumed in fft_real_convolution_error().
+inline void fft(std::vector<std::complex<double>> &v, const bool &inverse)
+{
+    const auto n = v.size();
+    piranha_assert(n != 0u && (n & (n - 1u)) == 0u);
+    if (n == 1u) {
+        return;
+    }
+    // Bit-reversal permutation.
+    for (decltype(v.size()) i = 1u, j = 0u; i < n; ++i) {
+        auto bit = n >> 1u;
+        for (; j & bit; bit >>= 1u) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(v[i], v[j]);
+        }
+    }
+    // Twiddle factors.
+    const double angle = (inverse ? 2. : -2.) * boost::math::constants::pi<double>() / static_cast<double>(n);
+    std::vector<std::complex<double>> w(n / 2u);
+    for (decltype(w.size()) k = 0u; k < w.size(); ++k) {
+        w[k] = std::complex<double>(std::cos(angle * static_cast<double>(k)), std::sin(angle * static_cast<double>(k)));
+    }
+    // Butterflies.
+    for (decltype(v.size()) len = 2u; len <= n; len <<= 1u) {
+        const auto half = len / 2u, step = n / len;
+        for (decltype(v.size()) i = 0u; i < n; i += len) {
+            for (decltype(v.size()) j = 0u; j < half; ++j) {
+                const auto u = v[i + j], t = fft_cmul(v[i + j + half], w[j * step]);
+                v[i + j] = u + t;
+                v[i + j + half] = u - t;
+            }
+        }
+    }
+}
+
+// 2-norm of a real sequence.
+inline double fft_norm2(const std::vector<double> &v)
+{
+    double retval = 0.;
+    for (const auto &x : v) {
+        retval += x * x;
+    }
+    return std::sqrt(retval);
+}
+
+// In fft_real_convolution(), the second sequence is scaled by 2**fft_scale_exp(|a|, |b|) (hence exactly), so that
+// the two sequences have similar 2-norms. This keeps the error bound tight.
+inline int fft_scale_exp(const double &na, const double &nb)
+{
+    if (na == 0. || nb == 0. || !std::isfinite(na) || !std::isfinite(nb)) {
+        return 0;
+    }
+    int exp_a, exp_b;
+    std::frexp(na, &exp_a);
+    std::frexp(nb, &exp_b);
+    return exp_a - exp_b;
+}
+
+// Linear convolution of the real sequences a and b via a single complex FFT of size n, which must be a power of two
+// not less than a.size() + b.size() - 1. The two sequences are packed as the real and imaginary parts of a complex
+// sequence, and their transforms are separated exploiting the conjugate symmetry of the transforms of real
+// sequences.
+inline std::vector<double> fft_real_convolution(const std::vector<double> &a, const std::vector<double> &b,
+                                                const std::size_t &n)
+{
+    piranha_assert(a.size() && b.size() && n >= a.size() + b.size() - 1u);
+    const int s_exp = fft_scale_exp(fft_norm2(a), fft_norm2(b));
+    std::vector<std::complex<double>> z(n);
+    for (decltype(a.size()) i = 0u; i < a.size(); ++i) {
+        z[i].real(a[i]);
+    }
+    for (decltype(b.size()) i = 0u; i < b.size(); ++i) {
+        z[i].imag(std::ldexp(b[i], s_exp));
+    }
+    fft(z, false);
+    // Separate the transforms of a and b, and multiply them: with Z the transform of z, the transforms
+    // are A[k] = (Z[k] + conj(Z[n - k])) / 2 and B[k] = (Z[k] - conj(Z[n - k])) / 2i.
+    std::vector<std::complex<double>> c(n);
+    for (std::size_t k = 0u; k < n; ++k) {
+        const auto zk = z[k], zmk = std::conj(z[(n - k) & (n - 1u)]);
+        c[k] = fft_cmul((zk + zmk) * 0.5, (zk - zmk) * std::complex<double>(0., -0.5));
+    }
+    fft(c, true);
+    std::vector<double> retval(a.size() + b.size() - 1u);
+    const double scale = std::ldexp(1. / static_cast<double>(n), -s_exp);
+    for (decltype(retval.size()) i = 0u; i < retval.size(); ++i) {
+        retval[i] = c[i].real() * scale;
+    }
+    return retval;
+}
+
+// Bound on the absolute error of each element of the convolution computed by fft_real_convolution(), given the
+// 2-norms of the two sequences. The bound is infinite or NaN if the norms are not finite.
+// NOTE: this is the first-order expansion of the bound for FFT-based convolutions in C. Percival, "Rapid
+// multiplication modulo the sum and difference of highly composite numbers", Math. Comp. 72 (2003), with the
+// norm of the packed complex sequence in place of the product of the norms of the inputs, and an extra factor of 2
+// for the separation of the transforms and for the higher-order terms.
+inline double fft_real_convolution_error(const double &na, const double &nb, const std::size_t &n)
+{
+    const int s_exp = fft_scale_exp(na, nb);
+    double log_n = 0.;
+    for (auto m = n; m > 1u; m >>= 1u) {
+        log_n += 1.;
+    }
+    const double u = std::numeric_limits<double>::epsilon() / 2., sqrt5 = std::sqrt(5.);
+    // Squared norm of the packed sequence, divided by the scaling factor of the second sequence.
+    const double nz2 = na * na * std::ldexp(1., -s_exp) + nb * nb * std::ldexp(1., s_exp);
+    return 2. * nz2 * u * (6. * log_n + sqrt5 * (3. * log_n + 1.));
+}
+}
+}
+
+#endif
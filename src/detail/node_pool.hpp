@@ -0,0 +1,192 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_NODE_POOL_HPP
+#define PIRANHA_DETAIL_NODE_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../config.hpp"
+#include "atomic_lock_guard.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Index of the cache slot of the calling thread in a node_pool.
+inline std::size_t node_pool_slot(std::size_t n_slots)
+{
+#if defined(PIRANHA_HAVE_THREAD_LOCAL)
+    // Assign the slots round-robin, so that the first n_slots threads asking for a slot
+    // get a slot each.
+    static std::atomic<std::size_t> counter(0u);
+    static thread_local const std::size_t slot = counter.fetch_add(1u, std::memory_order_relaxed);
+    return slot % n_slots;
+#else
+    return std::hash<std::thread::id>{}(std::this_thread::get_id()) % n_slots;
+#endif
+}
+
+// A pool of nodes of type Node, carved from slabs of geometrically increasing size (starting from a few nodes,
+// so that the pools of small sets stay small). The nodes are never returned to the system individually: all the
+// slabs are released at once when the pool is destroyed, and it is the responsibility of the user to destroy the
+// payloads of the nodes beforehand. Allocation and deallocation are thread-safe: each thread goes through one of
+// a few cache slots, each containing a list of freed nodes and a range of never-used nodes, which is refilled
+// from the current slab under the lock of the pool. The number of slots is set on construction (typically, to the
+// number of threads in use), and each slot occupies its own cache line.
+// Node must be trivially destructible, default-constructible and provide a Node * m_next member, which is
+// used to link the freed nodes.
+template <typename Node>
+class node_pool
+{
+    static_assert(std::is_trivially_destructible<Node>::value, "The node type must be trivially destructible.");
+    using storage_type = typename std::aligned_storage<sizeof(Node), alignof(Node)>::type;
+    // NOTE: these are tuning parameters.
+    static const std::size_t max_slots = 16u;
+    static const std::size_t chunk_size = 32u;
+    static const std::size_t min_slab_size = 4u;
+    static const std::size_t max_slab_size = 16384u;
+    // NOTE: a typical cache line size. The runtime value (settings::get_cache_line_size()) cannot be used
+    // here, as it is needed at compile time for the padding of the slots.
+    static const std::size_t slot_alignment = 64u;
+    struct alignas(slot_alignment) slot_type {
+        slot_type() : m_free(nullptr), m_cur(nullptr), m_end(nullptr)
+        {
+            m_lock.clear();
+        }
+        std::atomic_flag m_lock;
+        Node *m_free;
+        storage_type *m_cur;
+        storage_type *m_end;
+    };
+    // NOTE: the slots are never destroyed explicitly.
+    static_assert(std::is_trivially_destructible<slot_type>::value, "Invalid slot type.");
+    // Refill the never-used range of slot s with a chunk of the current slab. Requires the lock of s.
+    void refill(slot_type &s)
+    {
+        atomic_lock_guard lock(m_lock);
+        if (m_cur == m_end) {
+            // NOTE: if this throws, nothing was modified.
+            std::unique_ptr<storage_type[]> slab(::new storage_type[m_slab_size]);
+            m_slabs.push_back(std::move(slab));
+            m_cur = m_slabs.back().get();
+            m_end = m_cur + m_slab_size;
+            m_slab_size = std::min<std::size_t>(m_slab_size * 2u, max_slab_size);
+        }
+        const auto n = std::min<std::size_t>(chunk_size, static_cast<std::size_t>(m_end - m_cur));
+        s.m_cur = m_cur;
+        s.m_end = m_cur + n;
+        m_cur += n;
+    }
+
+public:
+    // Construct a pool with n_slots slots (clamped to [1, max_slots]).
+    explicit node_pool(std::size_t n_slots)
+        : m_n_slots(std::max<std::size_t>(1u, std::min(n_slots, max_slots))),
+          m_slot_buffer(::new unsigned char[m_n_slots * sizeof(slot_type) + slot_alignment]), m_cur(nullptr),
+          m_end(nullptr), m_slab_size(min_slab_size)
+    {
+        // NOTE: operator new does not honour extended alignments in C++14, align the slots manually.
+        void *ptr = m_slot_buffer.get();
+        std::size_t space = m_n_slots * sizeof(slot_type) + slot_alignment;
+        ptr = std::align(slot_alignment, m_n_slots * sizeof(slot_type), ptr, space);
+        piranha_assert(ptr != nullptr);
+        m_slots = static_cast<slot_type *>(ptr);
+        for (std::size_t i = 0u; i < m_n_slots; ++i) {
+            ::new (static_cast<void *>(m_slots + i)) slot_type();
+        }
+        m_lock.clear();
+    }
+    node_pool(const node_pool &) = delete;
+    node_pool(node_pool &&) = delete;
+    node_pool &operator=(const node_pool &) = delete;
+    node_pool &operator=(node_pool &&) = delete;
+    ~node_pool() = default;
+    // Get a default-constructed node.
+    Node *allocate()
+    {
+        auto &s = m_slots[node_pool_slot(m_n_slots)];
+        atomic_lock_guard lock(s.m_lock);
+        if (s.m_free) {
+            const auto retval = s.m_free;
+            s.m_free = retval->m_next;
+            return ::new (static_cast<void *>(retval)) Node();
+        }
+        if (s.m_cur == s.m_end) {
+            refill(s);
+        }
+        return ::new (static_cast<void *>(s.m_cur++)) Node();
+    }
+    // Give back a node obtained from allocate(). The payload of the node must have been destroyed.
+    void deallocate(Node *n)
+    {
+        auto &s = m_slots[node_pool_slot(m_n_slots)];
+        atomic_lock_guard lock(s.m_lock);
+        n->m_next = s.m_free;
+        s.m_free = n;
+    }
+
+private:
+    const std::size_t m_n_slots;
+    std::unique_ptr<unsigned char[]> m_slot_buffer;
+    slot_type *m_slots;
+    std::atomic_flag m_lock;
+    std::vector<std::unique_ptr<storage_type[]>> m_slabs;
+    storage_type *m_cur;
+    storage_type *m_end;
+    std::size_t m_slab_size;
+};
+
+template <typename Node>
+const std::size_t node_pool<Node>::max_slots;
+
+template <typename Node>
+const std::size_t node_pool<Node>::chunk_size;
+
+template <typename Node>
+const std::size_t node_pool<Node>::min_slab_size;
+
+template <typename Node>
+const std::size_t node_pool<Node>::max_slab_size;
+
+template <typename Node>
+const std::size_t node_pool<Node>::slot_alignment;
+}
+}
+
+#endif
@@ -0,0 +1,145 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_PARALLEL_RADIX_SORT_HPP
+#define PIRANHA_DETAIL_PARALLEL_RADIX_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../config.hpp"
+#include "../exceptions.hpp"
+#include "parallel_run.hpp"
+
+namespace piranha
+{
+namespace detail
+{
+
+// Stable sort of the vector v according to the unsigned integral keys computed by the functor key, via an LSD radix
+// sort with 8-bit digits. The keys are computed only once. Up to n_threads threads from the pool are used: each thread
+// builds the histogram of the digits in its portion of the vector, and then scatters its portion into the output
+// at the offsets deduced from all the histograms. Small vectors are sorted with std::stable_sort(). In case of errors,
+// v is left in a valid but unspecified state.
+template <typename T, typename F>
+inline void parallel_radix_sort(unsigned n_threads, std::vector<T> &v, const F &key)
+{
+    using key_type = typename std::decay<decltype(key(std::declval<const T &>()))>::type;
+    static_assert(std::is_integral<key_type>::value && std::is_unsigned<key_type>::value,
+                  "The keys of the radix sort must be unsigned integers.");
+    using size_type = typename std::vector<T>::size_type;
+    constexpr unsigned digit_bits = 8u, n_digits = 1u << digit_bits;
+    using hist_type = std::array<size_type, n_digits>;
+    if (unlikely(n_threads == 0u)) {
+        piranha_throw(std::invalid_argument, "invalid number of threads");
+    }
+    const size_type size = v.size();
+    // NOTE: these are tuning parameters.
+    if (size < 512u) {
+        std::stable_sort(v.begin(), v.end(), [&key](const T &a, const T &b) { return key(a) < key(b); });
+        return;
+    }
+    // Use at least 16384 elements per thread.
+    n_threads = static_cast<unsigned>(std::min<size_type>(n_threads, std::max<size_type>(1u, size / 16384u)));
+    auto chunk = [size, n_threads](unsigned i) { return parallel_chunk(size, n_threads, i); };
+    // Pair up the values with their keys, and compute the max key.
+    std::vector<std::pair<key_type, T>> a(size), b(size);
+    std::vector<key_type> max_keys(n_threads, 0u);
+    parallel_run(n_threads, [&a, &v, &key, &max_keys, &chunk](unsigned i) {
+        const auto c = chunk(i);
+        key_type m = 0u;
+        for (auto j = c.first; j != c.second; ++j) {
+            a[j].first = key(v[j]);
+            a[j].second = std::move(v[j]);
+            m = std::max(m, a[j].first);
+        }
+        max_keys[i] = m;
+    });
+    key_type max_key = *std::max_element(max_keys.begin(), max_keys.end());
+    std::vector<hist_type> hists(n_threads);
+    for (unsigned shift = 0u; max_key != 0u;
+         shift += digit_bits, max_key = static_cast<key_type>(max_key >> digit_bits)) {
+        auto digit = [shift](const key_type &k) { return static_cast<unsigned>((k >> shift) & (n_digits - 1u)); };
+        // Histograms.
+        parallel_run(n_threads, [&a, &hists, &digit, &chunk](unsigned i) {
+            const auto c = chunk(i);
+            auto &h = hists[i];
+            h.fill(0u);
+            for (auto j = c.first; j != c.second; ++j) {
+                ++h[digit(a[j].first)];
+            }
+        });
+        // Turn the histograms into output offsets: the elements with digit d from thread i go after those
+        // with smaller digits and after those with digit d from the threads with smaller index.
+        size_type offset = 0u;
+        bool single_digit = false;
+        for (unsigned d = 0u; d < n_digits; ++d) {
+            size_type d_count = 0u;
+            for (auto &h : hists) {
+                const auto tmp = h[d];
+                h[d] = offset;
+                offset = static_cast<size_type>(offset + tmp);
+                d_count = static_cast<size_type>(d_count + tmp);
+            }
+            if (d_count == size) {
+                single_digit = true;
+            }
+        }
+        if (single_digit) {
+            // All the elements share the same digit, no need to move them.
+            continue;
+        }
+        // Scatter.
+        parallel_run(n_threads, [&a, &b, &hists, &digit, &chunk](unsigned i) {
+            const auto c = chunk(i);
+            auto &h = hists[i];
+            for (auto j = c.first; j != c.second; ++j) {
+                b[h[digit(a[j].first)]++] = std::move(a[j]);
+            }
+        });
+        a.swap(b);
+    }
+    // Copy back the values.
+    parallel_run(n_threads, [&a, &v, &chunk](unsigned i) {
+        const auto c = chunk(i);
+        for (auto j = c.first; j != c.second; ++j) {
+            v[j] = std::move(a[j].second);
+        }
+    });
+}
+}
+}
+
+#endif
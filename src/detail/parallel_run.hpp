@@ -0,0 +1,79 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_DETAIL_PARALLEL_RUN_HPP
+#define PIRANHA_DETAIL_PARALLEL_RUN_HPP
+
+#include <utility>
+
+#include "../config.hpp"
+#include "../thread_pool.hpp"
+
+namespace piranha
+{
+namespace detail
+{
+
+// Run f(i) for i in [0, n_threads[, using the first n_threads threads in the pool if n_threads > 1.
+// Any exception thrown by f will be re-thrown after all the threads have finished.
+template <typename F>
+inline void parallel_run(unsigned n_threads, const F &f)
+{
+    piranha_assert(n_threads > 0u);
+    if (n_threads == 1u) {
+        f(0u);
+        return;
+    }
+    future_list<decltype(f(0u))> ff_list;
+    try {
+        for (unsigned i = 0u; i < n_threads; ++i) {
+            ff_list.push_back(thread_pool::enqueue(i, f, i));
+        }
+        // First let's wait for everything to finish.
+        ff_list.wait_all();
+        // Then, let's handle the exceptions.
+        ff_list.get_all();
+    } catch (...) {
+        ff_list.wait_all();
+        throw;
+    }
+}
+
+// Portion of [0,size[ assigned to the thread i out of n_threads: all the portions have the same size,
+// apart from the last one which also takes the remainder.
+template <typename S>
+inline std::pair<S, S> parallel_chunk(const S &size, unsigned n_threads, unsigned i)
+{
+    piranha_assert(n_threads > 0u && i < n_threads);
+    return std::make_pair(static_cast<S>(size / n_threads * i),
+                          (i == n_threads - 1u) ? size : static_cast<S>(size / n_threads * (i + 1u)));
+}
+}
+}
+
+#endif
@@ -40,8 +40,12 @@ struct series_tag {
 };
 }
 
-// Forward-declaration of series.
+// Forward-declaration of hash_set, the default container for the terms of a series.
 template <typename, typename, typename>
+class hash_set;
+
+// Forward-declaration of series.
+template <typename, typename, typename, template <typename, typename, typename> class = hash_set>
 class series;
 
 // Fwd declaration of type trait.
@@ -354,6 +354,15 @@ private:
             update_exponent(it->e, term.e);
         }
     }
+    // Locate the term p, whose hash is h, in the container c. Returns null if p is not in c.
+    static const p_type *find_term(const container_type &c, const p_type &p, const std::size_t &h)
+    {
+        if (c.empty()) {
+            return nullptr;
+        }
+        const auto it = c._find(p, c._bucket_from_hash(h));
+        return it == c.end() ? nullptr : &*it;
+    }
     template <typename U = T, typename std::enable_if<std::is_integral<U>::value, int>::type = 0>
     static void update_exponent(value_type &a, const value_type &b)
     {
@@ -892,6 +901,87 @@ public:
             t.m_key.insertion_impl(*it);
         }
     }
+    /// Hash value of a product.
+    /**
+     * This method will compute the hash value of the key resulting from the multiplication of \p a by \p b
+     * (see multiply()), given the hash values \p ha and \p hb of \p a and \p b. The key of the product
+     * will not be constructed.
+     *
+     * @param a first factor.
+     * @param ha hash value of \p a.
+     * @param b second factor.
+     * @param hb hash value of \p b.
+     *
+     * @return the hash value of the product of \p a by \p b.
+     */
+    static std::size_t _product_hash(const divisor &a, const std::size_t &ha, const divisor &b,
+                                     const std::size_t &hb)
+    {
+        // NOTE: the hash of a divisor is the sum of the hashes of its terms, so we need to subtract
+        // the hashes of the terms which appear in both factors.
+        const divisor &large = (a.size() >= b.size()) ? a : b;
+        const divisor &small = (a.size() < b.size()) ? a : b;
+        std::size_t retval = static_cast<std::size_t>(ha + hb);
+        p_type_hasher hasher;
+        const auto it_f = small.m_container.end();
+        for (auto it = small.m_container.begin(); it != it_f; ++it) {
+            const auto h = hasher(*it);
+            if (find_term(large.m_container, *it, h)) {
+                retval = static_cast<std::size_t>(retval - h);
+            }
+        }
+        return retval;
+    }
+    /// Product check.
+    /**
+     * This method will check if \p this is equal to the key resulting from the multiplication of \p a by
+     * \p b (see multiply()), without constructing the product.
+     *
+     * @param a first factor.
+     * @param b second factor.
+     *
+     * @return \p true if \p this is the product of \p a by \p b, \p false otherwise.
+     *
+     * @throws std::invalid_argument if the computation of an exponent of the product overflows.
+     * @throws unspecified any exception thrown by the arithmetic operations on the exponents.
+     */
+    bool _is_product(const divisor &a, const divisor &b) const
+    {
+        const divisor &large = (a.size() >= b.size()) ? a : b;
+        const divisor &small = (a.size() < b.size()) ? a : b;
+        p_type_hasher hasher;
+        // Check the size first.
+        size_type n_common = 0u;
+        const auto it_f_s = small.m_container.end();
+        for (auto it = small.m_container.begin(); it != it_f_s; ++it) {
+            if (find_term(large.m_container, *it, hasher(*it))) {
+                ++n_common;
+            }
+        }
+        if (size() != large.size() + (small.size() - n_common)) {
+            return false;
+        }
+        // Check the terms.
+        const auto it_f = m_container.end();
+        for (auto it = m_container.begin(); it != it_f; ++it) {
+            const auto h = hasher(*it);
+            const auto p_l = find_term(large.m_container, *it, h), p_s = find_term(small.m_container, *it, h);
+            if (p_l && p_s) {
+                value_type e(p_l->e);
+                update_exponent(e, p_s->e);
+                if (e != it->e) {
+                    return false;
+                }
+            } else if (p_l || p_s) {
+                if ((p_l ? p_l->e : p_s->e) != it->e) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
     /// Identify symbols that can be trimmed.
     /**
      * This method is used in piranha::series::trim(). The input parameter \p candidates
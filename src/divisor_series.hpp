@@ -29,15 +29,23 @@ see https://www.gnu.org/licenses/. */
 #ifndef PIRANHA_DIVISOR_SERIES_HPP
 #define PIRANHA_DIVISOR_SERIES_HPP
 
+#include <algorithm>
+#include <array>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "base_series_multiplier.hpp"
 #include "config.hpp"
+#include "detail/cf_mult_impl.hpp"
 #include "detail/divisor_series_fwd.hpp"
 #include "detail/polynomial_fwd.hpp"
 #include "divisor.hpp"
@@ -55,6 +63,8 @@ see https://www.gnu.org/licenses/. */
 #include "series_multiplier.hpp"
 #include "substitutable_series.hpp"
 #include "symbol_set.hpp"
+#include "thread_pool.hpp"
+#include "tuning.hpp"
 #include "type_traits.hpp"
 
 namespace piranha
@@ -571,6 +581,143 @@ class series_multiplier<Series, detail::divisor_series_multiplier_enabler<Series
     using call_enabler = typename std::enable_if<key_is_multipliable<typename T::term_type::cf_type,
                                                                      typename T::term_type::key_type>::value,
                                                  int>::type;
+    // Multiplication engine. The divisor keys of the operands are hashed only once, and the hash of each
+    // term-by-term product is computed from the hashes of the factors. The products are then located in the
+    // return value via divisor::_is_product(), so that a key is constructed only when a new term is inserted
+    // in the return value.
+    // In multi-threaded mode, the buckets of the return value are partitioned into zones, one per thread. The
+    // products of a round of rows of the first series are first assigned to zones in parallel (only indices and
+    // bucket positions are stored, in buffers which are reused across rounds), then each zone is processed
+    // by a single thread, without any locking. Each thread buffers roughly block_size**2 products per round.
+    template <typename LimitFunctor>
+    Series divisor_multiplication(const LimitFunctor &lf) const
+    {
+        using size_type = typename base::size_type;
+        using bucket_size_type = typename base::bucket_size_type;
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        using product_type = std::tuple<size_type, size_type, bucket_size_type>;
+        using buffer_type = std::vector<std::vector<product_type>>;
+        const auto n_threads = this->m_n_threads;
+        piranha_assert(n_threads > 0u);
+        const size_type size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        // Small multiplications in single-threaded mode go through the plain multiplication.
+        const auto e_thr = tuning::get_estimate_threshold();
+        if (n_threads == 1u && integer(size1) * size2 < integer(e_thr) * e_thr) {
+            return this->plain_multiplication(lf);
+        }
+        Series retval;
+        retval.set_symbol_set(this->m_ss);
+        if (unlikely(!size1 || !size2)) {
+            return retval;
+        }
+        auto &container = retval._container();
+        const auto est
+            = this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>(lf);
+        const auto n_buckets = boost::numeric_cast<bucket_size_type>(
+            std::ceil(static_cast<double>(est) / container.max_load_factor()));
+        piranha_assert(n_buckets > 0u);
+        container.rehash(n_buckets, tuning::get_parallel_memory_set() ? n_threads : 1u);
+        // Pre-hash the keys.
+        std::vector<std::size_t> h1, h2;
+        std::transform(this->m_v1.begin(), this->m_v1.end(), std::back_inserter(h1),
+                       [](const term_type *t) { return t->m_key.hash(); });
+        std::transform(this->m_v2.begin(), this->m_v2.end(), std::back_inserter(h2),
+                       [](const term_type *t) { return t->m_key.hash(); });
+        // Bucket of the product of the terms i and j.
+        auto bucket = [this, &h1, &h2, &container](const size_type &i, const size_type &j) {
+            return container._bucket_from_hash(
+                key_type::_product_hash(this->m_v1[i]->m_key, h1[i], this->m_v2[j]->m_key, h2[j]));
+        };
+        // Accumulate the product of the terms i and j, whose destination bucket is bucket_idx. tmp_cf and tmp_t
+        // are thread-local storage for the product of the coefficients and for the product of the terms.
+        auto accumulate = [this, &container, &retval](const size_type &i, const size_type &j,
+                                                      const bucket_size_type &bucket_idx, cf_type &tmp_cf,
+                                                      std::array<term_type, key_type::multiply_arity> &tmp_t) {
+            const auto &t1 = *(this->m_v1[i]), &t2 = *(this->m_v2[j]);
+            for (const auto &t : container._get_bucket_list(bucket_idx)) {
+                if (t.m_key._is_product(t1.m_key, t2.m_key)) {
+                    detail::cf_mult_impl(tmp_cf, t1.m_cf, t2.m_cf);
+                    t.m_cf += tmp_cf;
+                    return;
+                }
+            }
+            key_type::multiply(tmp_t, t1, t2, retval.get_symbol_set());
+            piranha_assert(container._bucket(tmp_t[0u]) == bucket_idx);
+            container._unique_insert(std::move(tmp_t[0u]), bucket_idx);
+        };
+        try {
+            if (n_threads == 1u) {
+                cf_type tmp_cf;
+                std::array<term_type, key_type::multiply_arity> tmp_t;
+                this->blocked_multiplication(
+                    [&bucket, &accumulate, &tmp_cf, &tmp_t](const size_type &i, const size_type &j) {
+                        accumulate(i, j, bucket(i, j), tmp_cf, tmp_t);
+                    },
+                    0u, size1, lf);
+            } else {
+                // Buckets per zone. The last zone also takes the remainder.
+                const auto bpz = static_cast<bucket_size_type>(container.bucket_count() / n_threads);
+                auto zone = [bpz, n_threads](const bucket_size_type &b) -> unsigned {
+                    return bpz ? static_cast<unsigned>(std::min<bucket_size_type>(b / bpz, n_threads - 1u))
+                               : n_threads - 1u;
+                };
+                // Rows of the first series processed by each thread in each round.
+                const auto bsize = safe_cast<size_type>(tuning::get_multiplication_block_size<term_type>());
+                const auto rpt = std::max<size_type>(static_cast<size_type>(bsize * bsize / size2), 1u);
+                // buffers[t][z] contains the products assigned by thread t to zone z.
+                std::vector<buffer_type> buffers(n_threads, buffer_type(n_threads));
+                // NOTE: the destructors of the future lists wait on the futures in case of exceptions.
+                for (size_type start = 0u; start < size1;) {
+                    // Assignment phase.
+                    {
+                        future_list<void> f_list;
+                        for (unsigned t = 0u; t < n_threads && start < size1; ++t) {
+                            const auto end = static_cast<size_type>(size1 - start > rpt ? start + rpt : size1);
+                            auto tf = [this, t, start, end, &lf, &buffers, &bucket, &zone]() {
+                                auto &buffer = buffers[t];
+                                this->blocked_multiplication(
+                                    [&buffer, &bucket, &zone](const size_type &i, const size_type &j) {
+                                        const auto b = bucket(i, j);
+                                        buffer[zone(b)].emplace_back(i, j, b);
+                                    },
+                                    start, end, lf);
+                            };
+                            f_list.push_back(thread_pool::enqueue(t, tf));
+                            start = end;
+                        }
+                        f_list.wait_all();
+                        f_list.get_all();
+                    }
+                    // Accumulation phase.
+                    future_list<void> f_list;
+                    for (unsigned z = 0u; z < n_threads; ++z) {
+                        auto af = [z, &buffers, &accumulate]() {
+                            cf_type tmp_cf;
+                            std::array<term_type, key_type::multiply_arity> tmp_t;
+                            for (auto &buffer : buffers) {
+                                for (const auto &p : buffer[z]) {
+                                    accumulate(std::get<0u>(p), std::get<1u>(p), std::get<2u>(p), tmp_cf, tmp_t);
+                                }
+                                buffer[z].clear();
+                            }
+                        };
+                        f_list.push_back(thread_pool::enqueue(z, af));
+                    }
+                    f_list.wait_all();
+                    f_list.get_all();
+                }
+            }
+            this->sanitise_series(retval, n_threads);
+            this->finalise_series(retval);
+        } catch (...) {
+            // Clean up retval as it might be in an inconsistent state.
+            container.clear();
+            throw;
+        }
+        return retval;
+    }
 
 public:
     /// Inherit base constructors.
@@ -581,16 +728,28 @@ public:
      * This operator is enabled only if the coefficient and key types of \p Series satisfy
      * piranha::key_is_multipliable.
      *
-     * The call operator will use base_series_multiplier::plain_multiplication().
+     * The keys of the operands are hashed only once, and the hash values of the term-by-term products are
+     * computed from the hash values of the factors. The keys of the products are constructed only when new terms
+     * are inserted in the result. In multi-threaded mode, the buckets of the result are partitioned into zones, one
+     * per thread, and each zone is accumulated by a single thread without locking. Small single-threaded
+     * multiplications are performed via base_series_multiplier::plain_multiplication().
      *
      * @return the result of the multiplication.
      *
-     * @throws unspecified any exception thrown by base_series_multiplier::plain_multiplication().
+     * @throws unspecified any exception thrown by:
+     * - base_series_multiplier::plain_multiplication(),
+     *   base_series_multiplier::estimate_final_series_size(), base_series_multiplier::sanitise_series(),
+     * - the multiplication of divisors and the methods of piranha::divisor used to locate the products,
+     * - the arithmetic operations on the coefficient type,
+     * - thread_pool::enqueue(), future_list::push_back(),
+     * - memory errors in standard containers,
+     * - the low-level interface of piranha::hash_set.
      */
     template <typename T = Series, call_enabler<T> = 0>
     Series operator()() const
     {
-        return this->plain_multiplication();
+        const auto size2 = this->m_v2.size();
+        return divisor_multiplication([size2](const typename base::size_type &) { return size2; });
     }
 };
 }
@@ -0,0 +1,1398 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_FLAT_HASH_SET_HPP
+#define PIRANHA_FLAT_HASH_SET_HPP
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "debug_access.hpp"
+#include "detail/init_data.hpp"
+#include "exceptions.hpp"
+#include "memory.hpp"
+#include "s11n.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+/// Open-addressing hash set.
+/**
+ * Hash set class with the same public and low-level interface as piranha::hash_set, implemented with
+ * an open-addressing strategy instead of separate chaining. The items are stored in a flat array of slots, and a
+ * parallel array of one-byte control values records, for each slot, whether the slot is empty, whether it contained
+ * an item that was erased (a "tombstone"), or a few bits of the hash of the item it contains. Collisions are resolved
+ * via linear probing. During lookups the control bytes are scanned first, and the (comparatively expensive) equality
+ * predicate is invoked only on the slots whose control byte matches the hash of the searched item. Traversing the
+ * probe sequence thus touches contiguous memory and does not require any pointer chasing or heap allocation.
+ *
+ * The main differences with respect to piranha::hash_set are the following:
+ *
+ * - the maximum load factor is lower than 1, as the table must always contain at least one empty slot,
+ * - the "buckets" of the low-level interface are the slots of the table: a bucket contains at most one item, and an
+ *   item is not necessarily stored in its destination bucket (as returned by _bucket()), but possibly in one of the
+ *   following slots,
+ * - _unique_insert() will grow the table if needed, so that it can never run out of empty slots,
+ * - erasing an item invalidates only the iterators pointing to that item, and the end iterator is never invalidated,
+ *   not even by a rehash operation.
+ *
+ * Because an item can be stored outside its destination bucket, this set cannot be filled concurrently by threads
+ * working on disjoint ranges of buckets, as it is possible with piranha::hash_set.
+ *
+ * Note that for performance reasons the implementation employs sizes that are powers of two. Hence, particular care
+ * should be taken that the hash function does not exhibit commensurabilities with powers of 2.
+ *
+ * ## Type requirements ##
+ *
+ * - \p T must satisfy piranha::is_container_element,
+ * - \p Hash must satisfy piranha::is_hash_function_object,
+ * - \p Pred must satisfy piranha::is_equality_function_object.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations apart from methods involving insertion,
+ * which provide the basic guarantee (after a failed insertion, the set will be left in an unspecified but valid state).
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object equivalent to an empty set whose hasher and
+ * equality predicate have been moved-from.
+ */
+template <typename T, typename Hash = std::hash<T>, typename Pred = std::equal_to<T>>
+class flat_hash_set
+{
+    PIRANHA_TT_CHECK(is_container_element, T);
+    PIRANHA_TT_CHECK(is_hash_function_object, Hash, T);
+    PIRANHA_TT_CHECK(is_equality_function_object, Pred, T);
+    // Make friend with debug access class.
+    template <typename U>
+    friend class debug_access;
+    // Storage for a single item.
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot_type;
+    // Control bytes. An empty slot has a control byte of zero, so that the control array can be
+    // initialised via value-initialisation. The control byte of a full slot has the top bit set,
+    // and the remaining 7 bits are taken from the hash of the item.
+    using ctrl_type = unsigned char;
+    static const ctrl_type ctrl_empty = 0u;
+    static const ctrl_type ctrl_deleted = 1u;
+    static bool is_full(const ctrl_type &c)
+    {
+        return (c & ctrl_type(0x80u)) != 0u;
+    }
+    // Allocator types.
+    typedef std::allocator<ctrl_type> ctrl_allocator_type;
+    typedef std::allocator<slot_type> slot_allocator_type;
+
+public:
+    /// Functor type for the calculation of hash values.
+    using hasher = Hash;
+    /// Functor type for comparing the items in the set.
+    using key_equal = Pred;
+    /// Key type.
+    using key_type = T;
+    /// Size type.
+    /**
+     * Alias for \p std::size_t.
+     */
+    using size_type = std::size_t;
+
+private:
+    // Internal pack type, containing the pointers to the control bytes and to the slots, and the hash/equal
+    // functors. In many cases the functors are stateless so we can exploit EBCO if implemented
+    // in the tuple type (likely).
+    using pack_type = std::tuple<ctrl_type *, slot_type *, hasher, key_equal>;
+    // A few handy accessors.
+    ctrl_type *&ctrl()
+    {
+        return std::get<0u>(m_pack);
+    }
+    ctrl_type *const &ctrl() const
+    {
+        return std::get<0u>(m_pack);
+    }
+    slot_type *&slots()
+    {
+        return std::get<1u>(m_pack);
+    }
+    slot_type *const &slots() const
+    {
+        return std::get<1u>(m_pack);
+    }
+    const hasher &hash() const
+    {
+        return std::get<2u>(m_pack);
+    }
+    const key_equal &k_equal() const
+    {
+        return std::get<3u>(m_pack);
+    }
+    // Access to the item in a slot. See the notes in hash_set about the chain of casts.
+    T *slot_ptr(const size_type &idx)
+    {
+        piranha_assert(idx < bucket_count());
+        return static_cast<T *>(static_cast<void *>(&slots()[idx]));
+    }
+    const T *slot_ptr(const size_type &idx) const
+    {
+        piranha_assert(idx < bucket_count());
+        return static_cast<const T *>(static_cast<const void *>(&slots()[idx]));
+    }
+    // The index used to represent the end of the set in iterators. It does not depend on the number
+    // of slots, so that the end iterator survives rehash operations.
+    static const size_type end_idx = std::numeric_limits<size_type>::max();
+    // Definition of the iterator type for the set.
+    template <typename Key>
+    class iterator_impl : public boost::iterator_facade<iterator_impl<Key>, Key, boost::forward_traversal_tag>
+    {
+        friend class flat_hash_set;
+        typedef
+            typename std::conditional<std::is_const<Key>::value, flat_hash_set const, flat_hash_set>::type set_type;
+
+    public:
+        iterator_impl() : m_set(nullptr), m_idx(end_idx)
+        {
+        }
+        explicit iterator_impl(set_type *set, const size_type &idx) : m_set(set), m_idx(idx)
+        {
+        }
+
+    private:
+        friend class boost::iterator_core_access;
+        void increment()
+        {
+            piranha_assert(m_set);
+            // Assert that the current iterator is valid.
+            piranha_assert(m_idx < m_set->bucket_count() && is_full(m_set->ctrl()[m_idx]));
+            m_idx = m_set->next_full(static_cast<size_type>(m_idx + 1u));
+        }
+        bool equal(const iterator_impl &other) const
+        {
+            // NOTE: comparing iterators from different containers is UB
+            // in the standard.
+            piranha_assert(m_set && other.m_set);
+            return m_idx == other.m_idx;
+        }
+        Key &dereference() const
+        {
+            piranha_assert(m_set && m_idx < m_set->bucket_count() && is_full(m_set->ctrl()[m_idx]));
+            return *m_set->slot_ptr(m_idx);
+        }
+
+    private:
+        set_type *m_set;
+        size_type m_idx;
+    };
+    // The range of items stored in a single slot. It contains either zero or one item.
+    class slot_range
+    {
+    public:
+        explicit slot_range(T const *begin, T const *end) : m_begin(begin), m_end(end)
+        {
+        }
+        T const *begin() const
+        {
+            return m_begin;
+        }
+        T const *end() const
+        {
+            return m_end;
+        }
+
+    private:
+        T const *m_begin;
+        T const *m_end;
+    };
+    // Index of the first full slot at or after idx, or end_idx.
+    size_type next_full(size_type idx) const
+    {
+        const auto b_count = bucket_count();
+        for (; idx < b_count; ++idx) {
+            if (is_full(ctrl()[idx])) {
+                return idx;
+            }
+        }
+        return end_idx;
+    }
+    // Control byte for an item with hash value h. The bits are taken right above the bits used for the computation of
+    // the destination bucket, as these are the bits that distinguish items with the same destination bucket.
+    ctrl_type ctrl_from_hash(const std::size_t &h) const
+    {
+        return static_cast<ctrl_type>(ctrl_type(0x80u) | ((h >> m_log2_size) & std::size_t(0x7fu)));
+    }
+    // Maximum number of used (i.e., full or deleted) slots in a table with size slots. It is always less than size,
+    // so that there will always be at least one empty slot terminating the probe sequences.
+    static size_type max_used(const size_type &size)
+    {
+        return static_cast<size_type>((size / 4u) * 3u + ((size % 4u) * 3u) / 4u);
+    }
+    // Index of the first slot suitable for the insertion of a new item, starting the linear probing
+    // from the slot at index idx.
+    size_type first_free(size_type idx) const
+    {
+        const auto mask = static_cast<size_type>(bucket_count() - 1u);
+        while (is_full(ctrl()[idx])) {
+            idx = static_cast<size_type>((idx + 1u) & mask);
+        }
+        return idx;
+    }
+    void init_from_n_buckets(const size_type &n_buckets, unsigned n_threads)
+    {
+        piranha_assert(!ctrl() && !slots() && !m_log2_size && !m_n_elements && !m_n_used);
+        if (unlikely(!n_threads)) {
+            piranha_throw(std::invalid_argument, "the number of threads must be strictly positive");
+        }
+        // Proceed to actual construction only if the requested number of buckets is nonzero.
+        if (!n_buckets) {
+            return;
+        }
+        const size_type log2_size = get_log2_from_hint(n_buckets);
+        const size_type size = size_type(1u) << log2_size;
+        ctrl_allocator_type c_alloc;
+        slot_allocator_type s_alloc;
+        auto new_ctrl = c_alloc.allocate(size);
+        if (unlikely(!new_ctrl)) {
+            piranha_throw(std::bad_alloc, );
+        }
+        slot_type *new_slots;
+        try {
+            new_slots = s_alloc.allocate(size);
+            if (unlikely(!new_slots)) {
+                piranha_throw(std::bad_alloc, );
+            }
+        } catch (...) {
+            c_alloc.deallocate(new_ctrl, size);
+            throw;
+        }
+        try {
+            // Mark all slots as empty. The slots themselves are left uninitialised.
+            parallel_value_init(new_ctrl, size, n_threads);
+        } catch (...) {
+            s_alloc.deallocate(new_slots, size);
+            c_alloc.deallocate(new_ctrl, size);
+            throw;
+        }
+        // Assign the members.
+        ctrl() = new_ctrl;
+        slots() = new_slots;
+        m_log2_size = log2_size;
+    }
+    // Destroy all elements and deallocate the arrays.
+    void destroy_and_deallocate()
+    {
+        // Proceed to destroy all elements and deallocate only if the set is actually storing something.
+        if (ctrl()) {
+            const size_type size = size_type(1u) << m_log2_size;
+            for (size_type i = 0u; i < size; ++i) {
+                if (is_full(ctrl()[i])) {
+                    slot_ptr(i)->~T();
+                }
+            }
+            slot_allocator_type{}.deallocate(slots(), size);
+            ctrl_allocator_type{}.deallocate(ctrl(), size);
+        } else {
+            piranha_assert(!slots() && !m_log2_size && !m_n_elements && !m_n_used);
+        }
+    }
+    // Count the number of full slots.
+    size_type count_full() const
+    {
+        size_type retval = 0u;
+        for (size_type i = 0u; i < bucket_count(); ++i) {
+            retval = static_cast<size_type>(retval + is_full(ctrl()[i]));
+        }
+        return retval;
+    }
+    // Move the items into a new table with at least new_size slots. The number of slots will be increased
+    // if needed to accommodate all the items currently stored in the table, which are counted explicitly
+    // (as the output of size() might not be accurate when using the low-level interface).
+    void rehash_impl(size_type new_size, unsigned n_threads)
+    {
+        const auto n_full = count_full();
+        if (unlikely(n_full > std::numeric_limits<size_type>::max() / 2u)) {
+            piranha_throw(std::bad_alloc, );
+        }
+        const auto min_size = static_cast<size_type>(n_full + n_full / 3u + 1u);
+        if (new_size < min_size) {
+            new_size = min_size;
+        }
+        // Create a new set with needed amount of slots.
+        flat_hash_set new_set(new_size, hash(), k_equal(), n_threads);
+        piranha_assert(max_used(new_set.bucket_count()) >= n_full);
+        try {
+            const auto it_f = _m_end();
+            for (auto it = _m_begin(); it != it_f; ++it) {
+                const auto h = hash()(*it);
+                const auto idx = new_set.first_free(new_set._bucket_from_hash(h));
+                ::new (static_cast<void *>(&new_set.slots()[idx])) T(std::move(*it));
+                new_set.ctrl()[idx] = new_set.ctrl_from_hash(h);
+                ++new_set.m_n_used;
+            }
+        } catch (...) {
+            // Clear up both this and the new set upon any kind of error.
+            clear();
+            new_set.clear();
+            throw;
+        }
+        // Retain the number of elements.
+        new_set.m_n_elements = m_n_elements;
+        // Clear the old set.
+        clear();
+        // Assign the new set.
+        *this = std::move(new_set);
+    }
+    // Serialization support.
+    friend class boost::serialization::access;
+    template <class Archive>
+    void save(Archive &ar, unsigned) const
+    {
+        // Size.
+        boost_save(ar, size());
+        // Serialize the items.
+        boost_save_range(ar, begin(), end());
+    }
+    template <class Archive>
+    void load(Archive &ar, unsigned)
+    {
+        // Reset this.
+        *this = flat_hash_set{};
+        // Recover the size.
+        size_type size;
+        boost_load(ar, size);
+        // Prepare an adequate number of buckets.
+        rehash(boost::numeric_cast<size_type>(std::ceil(static_cast<double>(size) / max_load_factor())));
+        for (size_type i = 0; i < size; ++i) {
+            T tmp;
+            boost_load(ar, tmp);
+            const auto p = insert(std::move(tmp));
+            if (unlikely(!p.second)) {
+                piranha_throw(std::invalid_argument, "while deserializing a flat_hash_set from a Boost archive "
+                                                     "a duplicate value was encountered");
+            }
+        }
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+    // Enabler for insert().
+    template <typename U>
+    using insert_enabler = enable_if_t<std::is_same<key_type, uncvref_t<U>>::value, int>;
+    // Run a consistency check on the set, will return false if something is wrong.
+    bool sanity_check() const
+    {
+        // Ignore sanity checks on shutdown.
+        if (shutdown()) {
+            return true;
+        }
+        const auto b_count = bucket_count();
+        size_type count = 0u, n_used = 0u, n_empty = 0u;
+        for (size_type i = 0u; i < b_count; ++i) {
+            const auto c = ctrl()[i];
+            if (c == ctrl_empty) {
+                ++n_empty;
+                continue;
+            }
+            ++n_used;
+            if (c == ctrl_deleted) {
+                continue;
+            }
+            if (!is_full(c)) {
+                return false;
+            }
+            const auto h = hash()(*slot_ptr(i));
+            if (c != ctrl_from_hash(h)) {
+                return false;
+            }
+            // There must be no empty slot between the destination bucket and the slot of the item.
+            for (auto j = _bucket_from_hash(h); j != i; j = (j + 1u) & (b_count - 1u)) {
+                if (ctrl()[j] == ctrl_empty) {
+                    return false;
+                }
+            }
+            ++count;
+        }
+        if (count != m_n_elements || n_used != m_n_used) {
+            return false;
+        }
+        // A table with slots must always have at least one empty slot.
+        if (b_count && !n_empty) {
+            return false;
+        }
+        // m_log2_size must not be equal to or greater than the number of bits of size_type.
+        if (m_log2_size >= unsigned(std::numeric_limits<size_type>::digits)) {
+            return false;
+        }
+        // The pointers must be consistent with the other members.
+        if (!ctrl() && (slots() || m_log2_size || m_n_elements || m_n_used)) {
+            return false;
+        }
+        // Check size is consistent with number of iterator traversals.
+        count = 0u;
+        for (auto it = begin(); it != end(); ++it, ++count) {
+        }
+        if (count != m_n_elements) {
+            return false;
+        }
+        return true;
+    }
+    // The number of available nonzero sizes will be the number of bits in the size type. Possible nonzero sizes will be
+    // in the [2 ** 0, 2 ** (n-1)] range.
+    static const size_type m_n_nonzero_sizes = static_cast<size_type>(std::numeric_limits<size_type>::digits);
+    // Get log2 of set size at least equal to hint. To be used only when hint is not zero.
+    static size_type get_log2_from_hint(const size_type &hint)
+    {
+        piranha_assert(hint);
+        for (size_type i = 0u; i < m_n_nonzero_sizes; ++i) {
+            if ((size_type(1u) << i) >= hint) {
+                return i;
+            }
+        }
+        piranha_throw(std::bad_alloc, );
+    }
+
+public:
+    /// Iterator type.
+    /**
+     * A read-only forward iterator.
+     */
+    using iterator = iterator_impl<key_type const>;
+
+private:
+    // Static checks on the iterator type.
+    PIRANHA_TT_CHECK(is_forward_iterator, iterator);
+
+public:
+    /// Const iterator type.
+    /**
+     * Equivalent to the iterator type.
+     */
+    using const_iterator = iterator;
+    /// Local iterator.
+    /**
+     * Const iterator that can be used to iterate through a single bucket.
+     */
+    using local_iterator = T const *;
+    /// Default constructor.
+    /**
+     * If not specified, it will default-initialise the hasher and the equality predicate. The resulting
+     * hash set will be empty.
+     *
+     * @param h hasher functor.
+     * @param k equality predicate.
+     *
+     * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>.
+     */
+    flat_hash_set(const hasher &h = hasher{}, const key_equal &k = key_equal{})
+        : m_pack(nullptr, nullptr, h, k), m_log2_size(0u), m_n_elements(0u), m_n_used(0u)
+    {
+    }
+    /// Constructor from number of buckets.
+    /**
+     * Will construct a set whose number of buckets is at least equal to \p n_buckets. If \p n_threads is not 1,
+     * then the first \p n_threads threads from piranha::thread_pool will be used concurrently for the initialisation
+     * of the set.
+     *
+     * @param n_buckets desired number of buckets.
+     * @param h hasher functor.
+     * @param k equality predicate.
+     * @param n_threads number of threads to use during initialisation.
+     *
+     * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum, or in
+     * case of memory errors.
+     * @throws std::invalid_argument if \p n_threads is zero.
+     * @throws unspecified any exception thrown by:
+     * - the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>,
+     * - piranha::parallel_value_init().
+     */
+    explicit flat_hash_set(const size_type &n_buckets, const hasher &h = hasher{}, const key_equal &k = key_equal{},
+                           unsigned n_threads = 1u)
+        : m_pack(nullptr, nullptr, h, k), m_log2_size(0u), m_n_elements(0u), m_n_used(0u)
+    {
+        init_from_n_buckets(n_buckets, n_threads);
+    }
+    /// Copy constructor.
+    /**
+     * The hasher and the equality comparator will also be copied.
+     *
+     * @param other piranha::flat_hash_set that will be copied into \p this.
+     *
+     * @throws unspecified any exception thrown by memory allocation errors,
+     * the copy constructor of the stored type, <tt>Hash</tt> or <tt>Pred</tt>.
+     */
+    flat_hash_set(const flat_hash_set &other)
+        : m_pack(nullptr, nullptr, other.hash(), other.k_equal()), m_log2_size(0u), m_n_elements(0u), m_n_used(0u)
+    {
+        // Proceed to actual copy only if other has some content.
+        if (other.ctrl()) {
+            init_from_n_buckets(size_type(1u) << other.m_log2_size, 1u);
+            size_type i = 0u;
+            try {
+                // Copy-construct the items, preserving their positions.
+                for (; i < other.bucket_count(); ++i) {
+                    if (is_full(other.ctrl()[i])) {
+                        ::new (static_cast<void *>(&slots()[i])) T(*other.slot_ptr(i));
+                    }
+                    ctrl()[i] = other.ctrl()[i];
+                }
+            } catch (...) {
+                // Unwind the construction and deallocate, before re-throwing.
+                for (size_type j = 0u; j < i; ++j) {
+                    if (is_full(ctrl()[j])) {
+                        slot_ptr(j)->~T();
+                    }
+                }
+                slot_allocator_type{}.deallocate(slots(), bucket_count());
+                ctrl_allocator_type{}.deallocate(ctrl(), bucket_count());
+                throw;
+            }
+            m_n_elements = other.m_n_elements;
+            m_n_used = other.m_n_used;
+        } else {
+            piranha_assert(!other.m_log2_size && !other.m_n_elements && !other.m_n_used);
+        }
+    }
+    /// Move constructor.
+    /**
+     * After the move, \p other will have zero buckets and zero elements, and its hasher and equality predicate
+     * will have been used to move-construct their counterparts in \p this.
+     *
+     * @param other set to be moved.
+     */
+    flat_hash_set(flat_hash_set &&other) noexcept : m_pack(std::move(other.m_pack)),
+                                                    m_log2_size(other.m_log2_size),
+                                                    m_n_elements(other.m_n_elements),
+                                                    m_n_used(other.m_n_used)
+    {
+        // Clear out the other one.
+        other.ctrl() = nullptr;
+        other.slots() = nullptr;
+        other.m_log2_size = 0u;
+        other.m_n_elements = 0u;
+        other.m_n_used = 0u;
+    }
+    /// Constructor from range.
+    /**
+     * Create a set with a copy of a range.
+     *
+     * @param begin begin of range.
+     * @param end end of range.
+     * @param n_buckets number of initial buckets.
+     * @param h hash functor.
+     * @param k key equality predicate.
+     *
+     * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum.
+     * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>, or arising
+     * from calling insert() on the elements of the range.
+     */
+    template <typename InputIterator>
+    explicit flat_hash_set(const InputIterator &begin, const InputIterator &end, const size_type &n_buckets = 0u,
+                           const hasher &h = hasher{}, const key_equal &k = key_equal{})
+        : m_pack(nullptr, nullptr, h, k), m_log2_size(0u), m_n_elements(0u), m_n_used(0u)
+    {
+        init_from_n_buckets(n_buckets, 1u);
+        for (auto it = begin; it != end; ++it) {
+            insert(*it);
+        }
+    }
+    /// Constructor from initializer list.
+    /**
+     * Will insert() all the elements of the initializer list, ignoring the return value of the operation.
+     * Hash functor and equality predicate will be default-constructed.
+     *
+     * @param list initializer list of elements to be inserted.
+     *
+     * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum.
+     * @throws unspecified any exception thrown by either insert() or of the default constructor of <tt>Hash</tt> or
+     * <tt>Pred</tt>.
+     */
+    template <typename U>
+    explicit flat_hash_set(std::initializer_list<U> list)
+        : m_pack(nullptr, nullptr, hasher{}, key_equal{}), m_log2_size(0u), m_n_elements(0u), m_n_used(0u)
+    {
+        // We do not care here for possible truncation of list.size(), as this is only an optimization.
+        init_from_n_buckets(static_cast<size_type>(static_cast<double>(list.size()) / max_load_factor()), 1u);
+        for (const auto &x : list) {
+            insert(x);
+        }
+    }
+    /// Destructor.
+    /**
+     * No side effects.
+     */
+    ~flat_hash_set()
+    {
+        piranha_assert(sanity_check());
+        destroy_and_deallocate();
+    }
+    /// Copy assignment operator.
+    /**
+     * @param other assignment argument.
+     *
+     * @return reference to \p this.
+     *
+     * @throws unspecified any exception thrown by the copy constructor.
+     */
+    flat_hash_set &operator=(const flat_hash_set &other)
+    {
+        if (likely(this != &other)) {
+            flat_hash_set tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+    /// Move assignment operator.
+    /**
+     * @param other set to be moved into \p this.
+     *
+     * @return reference to \p this.
+     */
+    flat_hash_set &operator=(flat_hash_set &&other) noexcept
+    {
+        if (likely(this != &other)) {
+            destroy_and_deallocate();
+            m_pack = std::move(other.m_pack);
+            m_log2_size = other.m_log2_size;
+            m_n_elements = other.m_n_elements;
+            m_n_used = other.m_n_used;
+            // Zero out other.
+            other.ctrl() = nullptr;
+            other.slots() = nullptr;
+            other.m_log2_size = 0u;
+            other.m_n_elements = 0u;
+            other.m_n_used = 0u;
+        }
+        return *this;
+    }
+    /// Const begin iterator.
+    /**
+     * @return flat_hash_set::const_iterator to the first element of the set, or end() if the set is empty.
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(this, next_full(0u));
+    }
+    /// Const end iterator.
+    /**
+     * The end iterator is not invalidated by any operation on the set.
+     *
+     * @return flat_hash_set::const_iterator to the position past the last element of the set.
+     */
+    const_iterator end() const
+    {
+        return const_iterator(this, end_idx);
+    }
+    /// Begin iterator.
+    /**
+     * @return flat_hash_set::iterator to the first element of the set, or end() if the set is empty.
+     */
+    iterator begin()
+    {
+        return static_cast<flat_hash_set const *>(this)->begin();
+    }
+    /// End iterator.
+    /**
+     * @return flat_hash_set::iterator to the position past the last element of the set.
+     */
+    iterator end()
+    {
+        return static_cast<flat_hash_set const *>(this)->end();
+    }
+    /// Number of elements contained in the set.
+    /**
+     * @return number of elements in the set.
+     */
+    size_type size() const
+    {
+        return m_n_elements;
+    }
+    /// Test for empty set.
+    /**
+     * @return \p true if size() returns 0, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return !size();
+    }
+    /// Number of buckets.
+    /**
+     * @return number of buckets (i.e., slots) in the set.
+     */
+    size_type bucket_count() const
+    {
+        return (ctrl()) ? (size_type(1u) << m_log2_size) : size_type(0u);
+    }
+    /// Load factor.
+    /**
+     * @return <tt>(double)size() / bucket_count()</tt>, or 0 if the set is empty.
+     */
+    double load_factor() const
+    {
+        const auto b_count = bucket_count();
+        return (b_count) ? static_cast<double>(size()) / static_cast<double>(b_count) : 0.;
+    }
+    /// Index of destination bucket.
+    /**
+     * Index to which \p k would belong, were it to be inserted into the set, if no collisions took place. The index
+     * of the destination bucket is the hash value reduced modulo the bucket count.
+     *
+     * @param k input argument.
+     *
+     * @return index of the destination bucket for \p k.
+     *
+     * @throws piranha::zero_division_error if bucket_count() returns zero.
+     * @throws unspecified any exception thrown by _bucket().
+     */
+    size_type bucket(const key_type &k) const
+    {
+        if (unlikely(!bucket_count())) {
+            piranha_throw(zero_division_error, "cannot calculate bucket index in an empty set");
+        }
+        return _bucket(k);
+    }
+    /// Find element.
+    /**
+     * @param k element to be located.
+     *
+     * @return flat_hash_set::const_iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+     *
+     * @throws unspecified any exception thrown by _find() or by _bucket().
+     */
+    const_iterator find(const key_type &k) const
+    {
+        if (unlikely(!bucket_count())) {
+            return end();
+        }
+        return _find(k, _bucket(k));
+    }
+    /// Find element.
+    /**
+     * @param k element to be located.
+     *
+     * @return flat_hash_set::iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+     *
+     * @throws unspecified any exception thrown by _find().
+     */
+    iterator find(const key_type &k)
+    {
+        return static_cast<const flat_hash_set *>(this)->find(k);
+    }
+    /// Maximum load factor.
+    /**
+     * @return the maximum load factor allowed before a resize.
+     */
+    double max_load_factor() const
+    {
+        // NOTE: this must be consistent with max_used().
+        return .75;
+    }
+    /// Insert element.
+    /**
+     * \note
+     * This template method is activated only if \p T and \p U are the same type, aside from cv qualifications and
+     * references.
+     *
+     * If no other key equivalent to \p k exists in the set, the insertion is successful and returns the
+     * <tt>(it,true)</tt> pair - where \p it is the position in the set into which the object has been inserted.
+     * Otherwise, the return value will be <tt>(it,false)</tt> - where \p it is the position of the existing equivalent
+     * object.
+     *
+     * @param k object that will be inserted into the set.
+     *
+     * @return <tt>(flat_hash_set::iterator,bool)</tt> pair containing an iterator to the newly-inserted object (or its
+     * existing equivalent) and the result of the operation.
+     *
+     * @throws unspecified any exception thrown by:
+     * - flat_hash_set::key_type's copy constructor,
+     * - _find(),
+     * - _bucket().
+     * @throws std::overflow_error if a successful insertion would result in size() exceeding the maximum
+     * value representable by type piranha::flat_hash_set::size_type.
+     * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
+     * maximum number of buckets.
+     */
+    template <typename U, insert_enabler<U> = 0>
+    std::pair<iterator, bool> insert(U &&k)
+    {
+        auto b_count = bucket_count();
+        // Handle the case of a set with no buckets.
+        if (unlikely(!b_count)) {
+            _increase_size();
+            // Update the bucket count.
+            b_count = bucket_count();
+        }
+        // Try to locate the element.
+        auto bucket_idx = _bucket(k);
+        const auto it = _find(k, bucket_idx);
+        if (it != end()) {
+            // Item already present, exit.
+            return std::make_pair(it, false);
+        }
+        if (unlikely(m_n_elements == std::numeric_limits<size_type>::max())) {
+            piranha_throw(std::overflow_error, "maximum number of elements reached");
+        }
+        // Item is new. Handle the case in which we need to rehash because of load factor.
+        if (unlikely(static_cast<double>(m_n_elements + size_type(1u)) / static_cast<double>(b_count)
+                     > max_load_factor())) {
+            _increase_size();
+            // We need a new bucket index in case of a rehash.
+            bucket_idx = _bucket(k);
+        }
+        const auto it_retval = _unique_insert(std::forward<U>(k), bucket_idx);
+        ++m_n_elements;
+        return std::make_pair(it_retval, true);
+    }
+    /// Erase element.
+    /**
+     * Erase the element to which \p it points. \p it must be a valid iterator
+     * pointing to an element of the set.
+     *
+     * Erasing an element invalidates only the iterators pointing to the erased element.
+     *
+     * After the operation has taken place, the size() of the set will be decreased by one.
+     *
+     * @param it iterator to the element of the set to be removed.
+     *
+     * @return iterator pointing to the element following \p it prior to the element being erased, or end() if
+     * no such element exists.
+     */
+    iterator erase(const_iterator it)
+    {
+        piranha_assert(!empty());
+        _erase(it);
+        piranha_assert(m_n_elements);
+        // Update the number of elements.
+        m_n_elements = static_cast<size_type>(m_n_elements - 1u);
+        return iterator(this, next_full(static_cast<size_type>(it.m_idx + 1u)));
+    }
+    /// Remove all elements.
+    /**
+     * After this call, size() and bucket_count() will both return zero.
+     */
+    void clear()
+    {
+        destroy_and_deallocate();
+        // Reset the members.
+        ctrl() = nullptr;
+        slots() = nullptr;
+        m_log2_size = 0u;
+        m_n_elements = 0u;
+        m_n_used = 0u;
+    }
+    /// Swap content.
+    /**
+     * Will use \p std::swap to swap hasher and equality predicate.
+     *
+     * @param other swap argument.
+     *
+     * @throws unspecified any exception thrown by swapping hasher or equality predicate via \p std::swap.
+     */
+    void swap(flat_hash_set &other)
+    {
+        std::swap(m_pack, other.m_pack);
+        std::swap(m_log2_size, other.m_log2_size);
+        std::swap(m_n_elements, other.m_n_elements);
+        std::swap(m_n_used, other.m_n_used);
+    }
+    /// Rehash set.
+    /**
+     * Change the number of buckets in the set to at least \p new_size. No rehash is performed
+     * if rehashing would lead to exceeding the maximum load factor. If \p n_threads is not 1,
+     * then the first \p n_threads threads from piranha::thread_pool will be used concurrently during
+     * the initialisation of the new table. The rehash operation also removes the tombstones left behind
+     * by erase operations.
+     *
+     * @param new_size new desired number of buckets.
+     * @param n_threads number of threads to use.
+     *
+     * @throws std::invalid_argument if \p n_threads is zero.
+     * @throws unspecified any exception thrown by the constructor from number of buckets or by the hasher.
+     */
+    void rehash(const size_type &new_size, unsigned n_threads = 1u)
+    {
+        if (unlikely(!n_threads)) {
+            piranha_throw(std::invalid_argument, "the number of threads must be strictly positive");
+        }
+        // If rehash is requested to zero, do something only if there are no items stored in the set.
+        if (!new_size) {
+            if (!size()) {
+                clear();
+            }
+            return;
+        }
+        // Do nothing if rehashing to the new size would lead to exceeding the max load factor.
+        if (static_cast<double>(size()) / static_cast<double>(new_size) > max_load_factor()) {
+            return;
+        }
+        rehash_impl(new_size, n_threads);
+    }
+    /// Get information on the sparsity of the set.
+    /**
+     * @return an <tt>std::map<size_type,size_type></tt> in which the key is the length of the probe sequence needed
+     * to locate an element (1 for an element stored in its destination bucket) and the mapped type the number of
+     * elements with that probe length. The number of slots not containing any element is reported under the key 0.
+     *
+     * @throws unspecified any exception thrown by memory errors in standard containers or by the hasher.
+     */
+    std::map<size_type, size_type> evaluate_sparsity() const
+    {
+        const auto b_count = bucket_count();
+        std::map<size_type, size_type> retval;
+        for (size_type i = 0u; i < b_count; ++i) {
+            if (is_full(ctrl()[i])) {
+                ++retval[static_cast<size_type>(((i - _bucket(*slot_ptr(i))) & (b_count - 1u)) + 1u)];
+            } else {
+                ++retval[0u];
+            }
+        }
+        return retval;
+    }
+    /** @name Low-level interface
+     * Low-level methods and types.
+     */
+    //@{
+    /// Mutable iterator.
+    /**
+     * This iterator type provides non-const access to the elements of the set. Please note that modifications
+     * to an existing element of the set might invalidate the relation between the element and its position in the set.
+     * After such modifications of one or more elements, the only valid operation is flat_hash_set::clear()
+     * (destruction of the set before calling flat_hash_set::clear() will lead to assertion failures in debug mode).
+     */
+    using _m_iterator = iterator_impl<key_type>;
+    /// Mutable begin iterator.
+    /**
+     * @return flat_hash_set::_m_iterator to the beginning of the set.
+     */
+    _m_iterator _m_begin()
+    {
+        return _m_iterator(this, next_full(0u));
+    }
+    /// Mutable end iterator.
+    /**
+     * @return flat_hash_set::_m_iterator to the end of the set.
+     */
+    _m_iterator _m_end()
+    {
+        return _m_iterator(this, end_idx);
+    }
+    /// Insert unique element (low-level).
+    /**
+     * \note
+     * This template method is activated only if \p T and \p U are the same type, aside from cv qualifications and
+     * references.
+     *
+     * The parameter \p bucket_idx is the index of the destination bucket for \p k and, for a
+     * set with a nonzero number of buckets, must be equal to the output
+     * of bucket() before the insertion.
+     *
+     * This method will not check if a key equivalent to \p k already exists in the set, it will not
+     * update the number of elements present in the set after the insertion, nor it will check
+     * if the value of \p bucket_idx is correct. Differently from piranha::hash_set::_unique_insert(), this method
+     * will grow the table if no more empty slots can be used for insertion: in such case, all the
+     * iterators (apart from the end iterator) and the bucket indices computed before the call are invalidated.
+     *
+     * @param k object that will be inserted into the set.
+     * @param bucket_idx destination bucket for \p k.
+     *
+     * @return iterator pointing to the newly-inserted element.
+     *
+     * @throws unspecified any exception thrown by the copy constructor of flat_hash_set::key_type, by the hasher,
+     * or by memory allocation errors.
+     */
+    template <typename U, insert_enabler<U> = 0>
+    iterator _unique_insert(U &&k, const size_type &bucket_idx)
+    {
+        // Assert that key is not present already in the set.
+        piranha_assert(find(k) == end());
+        // Assert bucket index is correct.
+        piranha_assert(bucket_idx == _bucket(k));
+        auto idx = first_free(bucket_idx);
+        if (ctrl()[idx] == ctrl_empty && unlikely(m_n_used == max_used(bucket_count()))) {
+            // Filling up an empty slot would leave the table without enough empty slots. If the items
+            // occupy at least half of the usable slots, double the number of slots, otherwise just get rid
+            // of the tombstones by rehashing to the same size.
+            if (count_full() >= max_used(bucket_count()) / 2u) {
+                if (unlikely(m_log2_size >= m_n_nonzero_sizes - 1u)) {
+                    piranha_throw(std::bad_alloc, );
+                }
+                rehash_impl(size_type(1u) << (m_log2_size + 1u), 1u);
+            } else {
+                rehash_impl(bucket_count(), 1u);
+            }
+            idx = first_free(_bucket(k));
+        }
+        // NOTE: the control byte depends on the size of the table, it must be computed after the growth.
+        const auto c = ctrl_from_hash(hash()(k));
+        ::new (static_cast<void *>(&slots()[idx])) T(std::forward<U>(k));
+        if (ctrl()[idx] == ctrl_empty) {
+            ++m_n_used;
+        }
+        ctrl()[idx] = c;
+        return iterator(this, idx);
+    }
+    /// Find element (low-level).
+    /**
+     * Locate element in the set. The parameter \p bucket_idx is the index of the destination bucket for \p k and, for
+     * a set with a nonzero number of buckets, must be equal to the output
+     * of bucket() before the insertion. This method will not check if the value of \p bucket_idx is correct.
+     *
+     * The probe sequence starting from \p bucket_idx is scanned until an empty slot is found, and the equality
+     * predicate is called only on the slots whose control byte matches the hash of \p k.
+     *
+     * @param k element to be located.
+     * @param bucket_idx index of the destination bucket for \p k.
+     *
+     * @return flat_hash_set::iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+     *
+     * @throws unspecified any exception thrown by calling the equality predicate or the hasher.
+     */
+    const_iterator _find(const key_type &k, const size_type &bucket_idx) const
+    {
+        // Assert bucket index is correct.
+        piranha_assert(bucket_idx == _bucket(k) && bucket_idx < bucket_count());
+        const auto c = ctrl_from_hash(hash()(k));
+        const auto mask = static_cast<size_type>(bucket_count() - 1u);
+        auto idx = bucket_idx;
+        // NOTE: this terminates because there is always at least one empty slot in the table.
+        while (true) {
+            const auto cur = ctrl()[idx];
+            if (cur == c && k_equal()(*slot_ptr(idx), k)) {
+                return const_iterator(this, idx);
+            }
+            if (cur == ctrl_empty) {
+                return end();
+            }
+            idx = static_cast<size_type>((idx + 1u) & mask);
+        }
+    }
+    /// Index of destination bucket from hash value.
+    /**
+     * Note that this method will not check if the number of buckets is zero.
+     *
+     * @param hash input hash value.
+     *
+     * @return index of the destination bucket for an object with hash value \p hash.
+     */
+    size_type _bucket_from_hash(const std::size_t &hash) const
+    {
+        piranha_assert(bucket_count());
+        return hash & ((size_type(1u) << m_log2_size) - 1u);
+    }
+    /// Index of destination bucket (low-level).
+    /**
+     * Equivalent to bucket(), with the exception that this method will not check
+     * if the number of buckets is zero.
+     *
+     * @param k input argument.
+     *
+     * @return index of the destination bucket for \p k.
+     *
+     * @throws unspecified any exception thrown by the call operator of the hasher.
+     */
+    size_type _bucket(const key_type &k) const
+    {
+        return _bucket_from_hash(hash()(k));
+    }
+    /// Force update of the number of elements.
+    /**
+     * After this call, size() will return \p new_size regardless of the true number of elements in the set.
+     *
+     * @param new_size new set size.
+     */
+    void _update_size(const size_type &new_size)
+    {
+        m_n_elements = new_size;
+    }
+    /// Increase bucket count.
+    /**
+     * Increase the number of buckets to the next implementation-defined value.
+     *
+     * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
+     * maximum number of buckets.
+     * @throws unspecified any exception thrown by rehash().
+     */
+    void _increase_size()
+    {
+        if (unlikely(m_log2_size >= m_n_nonzero_sizes - 1u)) {
+            piranha_throw(std::bad_alloc, );
+        }
+        // We must take care here: if the set has zero buckets,
+        // the next log2_size is 0u. Otherwise increase current log2_size.
+        piranha_assert(ctrl() || (!ctrl() && !m_log2_size));
+        const auto new_log2_size = (ctrl()) ? (m_log2_size + 1u) : 0u;
+        // Rehash to the new size.
+        rehash(size_type(1u) << new_log2_size);
+    }
+    /// Range of items in a bucket.
+    /**
+     * @param idx index of the bucket whose content will be returned.
+     *
+     * @return a range (i.e., an object with <tt>begin()</tt> and <tt>end()</tt> methods returning
+     * flat_hash_set::local_iterator) containing the item stored in the slot at index \p idx, if any. Note that
+     * the item stored in the slot does not necessarily have \p idx as destination bucket.
+     */
+    slot_range _get_bucket_list(const size_type &idx) const
+    {
+        piranha_assert(idx < bucket_count());
+        const auto p = slot_ptr(idx);
+        return slot_range(p, is_full(ctrl()[idx]) ? p + 1 : p);
+    }
+    /// Erase element.
+    /**
+     * Erase the element to which \p it points. \p it must be a valid iterator
+     * pointing to an element of the set.
+     *
+     * The slot of the erased element is marked as deleted, so that the probe sequences going through it are not
+     * interrupted, unless the following slot is empty. Erasing an element invalidates only the iterators pointing to
+     * the erased element.
+     *
+     * This method will not update the number of elements in the set.
+     *
+     * @param it iterator to the element of the set to be removed.
+     *
+     * @return the local end iterator of the bucket of the erased element.
+     */
+    local_iterator _erase(const_iterator it)
+    {
+        // Verify the iterator is valid.
+        piranha_assert(it.m_set == this);
+        piranha_assert(it.m_idx < bucket_count());
+        piranha_assert(is_full(ctrl()[it.m_idx]));
+        const auto idx = it.m_idx;
+        slot_ptr(idx)->~T();
+        if (ctrl()[(idx + 1u) & (bucket_count() - 1u)] == ctrl_empty) {
+            // No probe sequence can go past the next slot, hence we can mark this slot as empty.
+            ctrl()[idx] = ctrl_empty;
+            piranha_assert(m_n_used);
+            --m_n_used;
+        } else {
+            ctrl()[idx] = ctrl_deleted;
+        }
+        return slot_ptr(idx);
+    }
+    //@}
+private:
+    pack_type m_pack;
+    size_type m_log2_size;
+    size_type m_n_elements;
+    // Number of full or deleted slots.
+    size_type m_n_used;
+};
+
+template <typename T, typename Hash, typename Pred>
+const typename flat_hash_set<T, Hash, Pred>::ctrl_type flat_hash_set<T, Hash, Pred>::ctrl_empty;
+
+template <typename T, typename Hash, typename Pred>
+const typename flat_hash_set<T, Hash, Pred>::ctrl_type flat_hash_set<T, Hash, Pred>::ctrl_deleted;
+
+template <typename T, typename Hash, typename Pred>
+const typename flat_hash_set<T, Hash, Pred>::size_type flat_hash_set<T, Hash, Pred>::end_idx;
+
+template <typename T, typename Hash, typename Pred>
+const typename flat_hash_set<T, Hash, Pred>::size_type flat_hash_set<T, Hash, Pred>::m_n_nonzero_sizes;
+
+namespace detail
+{
+
+// Detect if a container can be filled concurrently by threads working on disjoint
+// ranges of buckets (e.g., piranha::hash_set). This is not the case for open-addressing tables,
+// in which the probe sequences can cross the boundaries of the ranges.
+template <typename Container>
+struct has_concurrent_buckets : std::true_type {
+};
+
+template <typename T, typename Hash, typename Pred>
+struct has_concurrent_buckets<flat_hash_set<T, Hash, Pred>> : std::false_type {
+};
+}
+
+inline namespace impl
+{
+
+// Enablers for boost s11n.
+template <typename Archive, typename T, typename Hash, typename Pred>
+using flat_hash_set_boost_save_enabler
+    = enable_if_t<conjunction<has_boost_save<Archive, T>,
+                              has_boost_save<Archive, typename flat_hash_set<T, Hash, Pred>::size_type>>::value>;
+
+template <typename Archive, typename T, typename Hash, typename Pred>
+using flat_hash_set_boost_load_enabler
+    = enable_if_t<conjunction<has_boost_load<Archive, T>,
+                              has_boost_load<Archive, typename flat_hash_set<T, Hash, Pred>::size_type>>::value>;
+}
+
+/// Specialisation of piranha::boost_save() for piranha::flat_hash_set.
+/**
+ * \note
+ * This specialisation is enabled only if \p T and the size type of piranha::flat_hash_set satisfy
+ * piranha::has_boost_save.
+ *
+ * The hashing functor and the equality predicate are not serialized. The archive format is the same
+ * as for piranha::hash_set.
+ *
+ * @throws unspecified any exception thrown by piranha::boost_save().
+ */
+template <typename Archive, typename T, typename Hash, typename Pred>
+struct boost_save_impl<Archive, flat_hash_set<T, Hash, Pred>, flat_hash_set_boost_save_enabler<Archive, T, Hash, Pred>>
+    : boost_save_via_boost_api<Archive, flat_hash_set<T, Hash, Pred>> {
+};
+
+/// Specialisation of piranha::boost_load() for piranha::flat_hash_set.
+/**
+ * \note
+ * This specialisation is enabled only if \p T and the size type of piranha::flat_hash_set satisfy
+ * piranha::has_boost_load.
+ *
+ * In case duplicate elements are encountered during deserialization, an exception will be raised. Before performing
+ * the deserialization, the output piranha::flat_hash_set is reset with a default-constructed instance of
+ * piranha::flat_hash_set. The hashing functor and the equality predicate are not deserialized. The basic exception
+ * safety guarantee is provided.
+ *
+ * @throws std::invalid_argument if a duplicate element is encountered during deserialization.
+ * @throws unspecified any exception thrown by:
+ * - the public interface of piranha::flat_hash_set,
+ * - piranha::boost_load(),
+ * - <tt>boost::numeric_cast()</tt>.
+ */
+template <typename Archive, typename T, typename Hash, typename Pred>
+struct boost_load_impl<Archive, flat_hash_set<T, Hash, Pred>, flat_hash_set_boost_load_enabler<Archive, T, Hash, Pred>>
+    : boost_load_via_boost_api<Archive, flat_hash_set<T, Hash, Pred>> {
+};
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+inline namespace impl
+{
+
+// Enablers for msgpack s11n.
+template <typename Stream, typename T, typename Hash, typename Pred>
+using flat_hash_set_msgpack_pack_enabler
+    = enable_if_t<conjunction<is_msgpack_stream<Stream>,
+                              has_safe_cast<std::uint32_t, typename flat_hash_set<T, Hash, Pred>::size_type>,
+                              has_msgpack_pack<Stream, T>>::value>;
+
+template <typename T>
+using flat_hash_set_msgpack_convert_enabler = enable_if_t<has_msgpack_convert<T>::value>;
+}
+
+/// Specialisation of piranha::msgpack_pack() for piranha::flat_hash_set.
+/**
+ * \note
+ * This specialisation is enabled only if
+ * - \p Stream satisfies piranha::is_msgpack_stream,
+ * - \p T satisfies piranha::has_msgpack_pack,
+ * - the size type of piranha::flat_hash_set is safely convertible to \p std::uint32_t.
+ */
+template <typename Stream, typename T, typename Hash, typename Pred>
+struct msgpack_pack_impl<Stream, flat_hash_set<T, Hash, Pred>,
+                         flat_hash_set_msgpack_pack_enabler<Stream, T, Hash, Pred>> {
+    /// Call operator.
+    /**
+     * This method will serialize \p h into \p p using the format \p f. The hashing functor and the equality predicate
+     * are not serialized. The msgpack representation of a piranha::flat_hash_set is the same as the representation
+     * of a piranha::hash_set, i.e., an array containing the items in the set.
+     *
+     * @param p the target packer.
+     * @param h the piranha::flat_hash_set that will be serialized.
+     * @param f the desired piranha::msgpack_format.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the public interface of <tt>msgpack::packer</tt>,
+     * - piranha::safe_cast(),
+     * - piranha::msgpack_pack().
+     */
+    void operator()(msgpack::packer<Stream> &p, const flat_hash_set<T, Hash, Pred> &h, msgpack_format f) const
+    {
+        msgpack_pack_range(p, h.begin(), h.end(), h.size(), f);
+    }
+};
+
+/// Specialisation of piranha::msgpack_convert() for piranha::flat_hash_set.
+/**
+ * \note
+ * This specialisation is enabled only if \p T satisfies piranha::has_msgpack_convert.
+ */
+template <typename T, typename Hash, typename Pred>
+struct msgpack_convert_impl<flat_hash_set<T, Hash, Pred>, flat_hash_set_msgpack_convert_enabler<T>> {
+    /// Call operator.
+    /**
+     * This method will convert the input object \p o into \p h using the format \p f. In case duplicate elements
+     * are encountered during deserialization, an exception will be raised. Before performing the deserialization,
+     * \p h is reset with a default-constructed instance of piranha::flat_hash_set. The hashing functor and the
+     * equality predicate are not deserialized. This method provides the basic exception safety guarantee.
+     *
+     * @param h the target piranha::flat_hash_set.
+     * @param o the source <tt>msgpack::object</tt>.
+     * @param f the desired piranha::msgpack_format.
+     *
+     * @throws std::invalid_argument if a duplicate element is encountered during deserialization.
+     * @throws unspecified any exception thrown by:
+     * - the public interface of piranha::flat_hash_set and <tt>msgpack::object</tt>,
+     * - <tt>boost::numeric_cast()</tt>,
+     * - piranha::msgpack_convert().
+     */
+    void operator()(flat_hash_set<T, Hash, Pred> &h, const msgpack::object &o, msgpack_format f) const
+    {
+        // Clear out the retval.
+        h = flat_hash_set<T, Hash, Pred>{};
+        // Extract the array of items as a vector of objects.
+        std::vector<msgpack::object> items;
+        o.convert(items);
+        // Prepare the number of buckets.
+        h.rehash(boost::numeric_cast<typename flat_hash_set<T, Hash, Pred>::size_type>(
+            std::ceil(static_cast<double>(items.size()) / h.max_load_factor())));
+        // Deserialize the items.
+        for (const auto &obj : items) {
+            T tmp;
+            msgpack_convert(tmp, obj, f);
+            const auto p = h.insert(std::move(tmp));
+            if (unlikely(!p.second)) {
+                piranha_throw(std::invalid_argument, "while deserializing a flat_hash_set from a msgpack object "
+                                                     "a duplicate value was encountered");
+            }
+        }
+    }
+};
+
+#endif
+}
+
+#endif
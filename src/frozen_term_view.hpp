@@ -0,0 +1,304 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_FROZEN_TERM_VIEW_HPP
+#define PIRANHA_FROZEN_TERM_VIEW_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "detail/parallel_run.hpp"
+#include "exceptions.hpp"
+#include "is_cf.hpp"
+#include "is_key.hpp"
+#include "symbol_set.hpp"
+#include "term.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+/// Frozen structure-of-arrays view of a series.
+/**
+ * This class stores a read-only snapshot of the terms of a series with coefficient type \p Cf and key type \p Key
+ * as two contiguous arrays of the same size: an array of keys and an array of coefficients. The key and the
+ * coefficient at the same position in the two arrays form one term of the series. The order of the terms
+ * is the iteration order of the series at the moment the view was built.
+ *
+ * With respect to the hash-based storage of piranha::series, in which terms are scattered in the nodes of the
+ * buckets, this layout allows to traverse the keys (or the coefficients) alone with unit stride. For keys
+ * which are packed into a single integral value, such as piranha::kronecker_monomial, the array of keys
+ * is an array of integers. This makes the view suitable for read-only kernels (evaluation, degree computation,
+ * bounds checking, etc.) that can be vectorised by the compiler.
+ *
+ * The view can be built in parallel, and it is usually accessed via piranha::series::frozen_view(), which caches
+ * it on the series until the next modification.
+ *
+ * ## Type requirements ##
+ *
+ * - \p Cf must satisfy piranha::is_cf,
+ * - \p Key must satisfy piranha::is_key.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in an unspecified but valid state.
+ */
+template <typename Cf, typename Key>
+class frozen_term_view
+{
+    PIRANHA_TT_CHECK(is_cf, Cf);
+    PIRANHA_TT_CHECK(is_key, Key);
+
+public:
+    /// Alias for the term type.
+    using term_type = term<Cf, Key>;
+    /// Alias for the coefficient type.
+    using cf_type = Cf;
+    /// Alias for the key type.
+    using key_type = Key;
+    /// Size type.
+    using size_type = typename std::vector<Key>::size_type;
+
+private:
+    // Enabler for the constructor from series.
+    template <typename Series>
+    using series_enabler = enable_if_t<std::is_same<typename Series::term_type, term_type>::value, int>;
+
+public:
+    /// Default constructor.
+    /**
+     * The view will be empty, with an empty symbol set.
+     */
+    frozen_term_view() = default;
+    /// Defaulted copy constructor.
+    frozen_term_view(const frozen_term_view &) = default;
+    /// Defaulted move constructor.
+    frozen_term_view(frozen_term_view &&) = default;
+    /// Constructor from series.
+    /**
+     * \note
+     * This constructor is enabled only if the term type of \p Series is frozen_term_view::term_type.
+     *
+     * The keys and the coefficients of the terms of \p s are copied into the arrays of \p this. Up to \p n_threads
+     * threads from piranha::thread_pool will be used: the terms in each range of buckets of \p s are first counted,
+     * and then copied concurrently into the corresponding portion of the arrays.
+     *
+     * @param s the input series.
+     * @param n_threads the number of threads to be used.
+     *
+     * @throws std::invalid_argument if \p n_threads is zero.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the default constructors and the copy assignment operators of coefficients and keys,
+     * - piranha::thread_pool::enqueue() or piranha::future_list::push_back().
+     */
+    template <typename Series, series_enabler<Series> = 0>
+    explicit frozen_term_view(const Series &s, unsigned n_threads = 1u) : m_symbol_set(s.get_symbol_set())
+    {
+        if (unlikely(n_threads == 0u)) {
+            piranha_throw(std::invalid_argument, "the number of threads must be strictly positive");
+        }
+        if (s.empty()) {
+            return;
+        }
+        const auto &c = s._container();
+        using bucket_size_type = typename std::decay<decltype(c)>::type::size_type;
+        const bucket_size_type b_count = c.bucket_count();
+        n_threads = static_cast<unsigned>(std::min<bucket_size_type>(n_threads, b_count));
+        // Count the terms in each range of buckets, and deduce the offsets in the arrays.
+        std::vector<size_type> offsets(static_cast<typename std::vector<size_type>::size_type>(n_threads) + 1u, 0u);
+        detail::parallel_run(n_threads, [&c, &offsets, b_count, n_threads](unsigned i) {
+            const auto r = detail::parallel_chunk(b_count, n_threads, i);
+            size_type count = 0u;
+            for (auto idx = r.first; idx != r.second; ++idx) {
+                const auto &list = c._get_bucket_list(idx);
+                count = static_cast<size_type>(count + static_cast<size_type>(std::distance(list.begin(), list.end())));
+            }
+            offsets[i + 1u] = count;
+        });
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        piranha_assert(offsets.back() == s.size());
+        m_keys.resize(offsets.back());
+        m_cfs.resize(offsets.back());
+        detail::parallel_run(n_threads, [this, &c, &offsets, b_count, n_threads](unsigned i) {
+            const auto r = detail::parallel_chunk(b_count, n_threads, i);
+            auto pos = offsets[i];
+            for (auto idx = r.first; idx != r.second; ++idx) {
+                for (const auto &t : c._get_bucket_list(idx)) {
+                    this->m_keys[pos] = t.m_key;
+                    this->m_cfs[pos] = t.m_cf;
+                    ++pos;
+                }
+            }
+            piranha_assert(pos == offsets[i + 1u]);
+        });
+    }
+    /// Defaulted destructor.
+    ~frozen_term_view() = default;
+    /// Defaulted copy assignment operator.
+    frozen_term_view &operator=(const frozen_term_view &) = default;
+    /// Defaulted move assignment operator.
+    frozen_term_view &operator=(frozen_term_view &&) = default;
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the piranha::symbol_set of the series from which \p this was built.
+     */
+    const symbol_set &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Number of terms.
+    /**
+     * @return the number of terms in the view.
+     */
+    size_type size() const
+    {
+        return m_keys.size();
+    }
+    /// Empty test.
+    /**
+     * @return \p true if the view contains no terms, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return m_keys.empty();
+    }
+    /// Array of keys.
+    /**
+     * @return a const reference to the array of keys.
+     */
+    const std::vector<Key> &keys() const
+    {
+        return m_keys;
+    }
+    /// Array of coefficients.
+    /**
+     * @return a const reference to the array of coefficients.
+     */
+    const std::vector<Cf> &cfs() const
+    {
+        return m_cfs;
+    }
+
+private:
+    symbol_set m_symbol_set;
+    std::vector<Key> m_keys;
+    std::vector<Cf> m_cfs;
+};
+
+namespace detail
+{
+
+// Lazily-built cache of a frozen_term_view, to be stored as a member of a series. The view is built on first access,
+// possibly concurrently from multiple threads reading the same series (only one of the concurrently built views is
+// kept), and it is dropped via reset() whenever the series is modified. Copies of the cache are empty (a copy of the
+// series is a distinct object, which might be modified independently), moves transfer the cached view.
+template <typename View>
+class frozen_view_cache
+{
+public:
+    frozen_view_cache() : m_ptr(nullptr)
+    {
+    }
+    frozen_view_cache(const frozen_view_cache &) : m_ptr(nullptr)
+    {
+    }
+    frozen_view_cache(frozen_view_cache &&other) noexcept
+        : m_ptr(other.m_ptr.exchange(nullptr, std::memory_order_relaxed))
+    {
+    }
+    frozen_view_cache &operator=(const frozen_view_cache &other)
+    {
+        if (likely(this != &other)) {
+            reset();
+        }
+        return *this;
+    }
+    frozen_view_cache &operator=(frozen_view_cache &&other) noexcept
+    {
+        if (likely(this != &other)) {
+            reset();
+            m_ptr.store(other.m_ptr.exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        return *this;
+    }
+    ~frozen_view_cache()
+    {
+        reset();
+    }
+    // Get the cached view, building it with f() if necessary.
+    template <typename F>
+    const View &get(const F &f) const
+    {
+        auto retval = m_ptr.load(std::memory_order_acquire);
+        if (likely(retval != nullptr)) {
+            return *retval;
+        }
+        std::unique_ptr<View> new_view(::new View(f()));
+        if (m_ptr.compare_exchange_strong(retval, new_view.get(), std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+            return *new_view.release();
+        }
+        // Another thread built the view in the meantime.
+        piranha_assert(retval != nullptr);
+        return *retval;
+    }
+    // Drop the cached view. This must not be called concurrently with get().
+    void reset()
+    {
+        const auto ptr = m_ptr.load(std::memory_order_relaxed);
+        if (unlikely(ptr != nullptr)) {
+            ::delete ptr;
+            m_ptr.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    bool has_value() const
+    {
+        return m_ptr.load(std::memory_order_acquire) != nullptr;
+    }
+
+private:
+    mutable std::atomic<View *> m_ptr;
+};
+}
+}
+
+#endif
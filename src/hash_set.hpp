@@ -29,6 +29,8 @@ see https://www.gnu.org/licenses/. */
 #ifndef PIRANHA_HASH_SET_HPP
 #define PIRANHA_HASH_SET_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 #include <cmath>
@@ -50,9 +52,13 @@ see https://www.gnu.org/licenses/. */
 #include "config.hpp"
 #include "debug_access.hpp"
 #include "detail/init_data.hpp"
+#include "detail/node_pool.hpp"
+#include "detail/parallel_run.hpp"
 #include "exceptions.hpp"
+#include "mp_integer.hpp"
 #include "s11n.hpp"
 #include "safe_cast.hpp"
+#include "settings.hpp"
 #include "thread_pool.hpp"
 #include "type_traits.hpp"
 
@@ -72,7 +78,9 @@ namespace piranha
  *
  * The implementation employs a separate chaining strategy consisting of an array of buckets, each one a singly linked
  * list with the first node stored directly within the array (so that the first insertion in a bucket does not require
- * any heap allocation).
+ * any heap allocation). The additional nodes of the lists are taken from a pool owned by the set, which allocates
+ * them in slabs and keeps the erased nodes for reuse. The pool is released in bulk when the set is cleared or
+ * destroyed, and it can be accessed concurrently by threads inserting into different buckets.
  *
  * An additional set of low-level methods is provided: such methods are suitable for use in high-performance and
  * multi-threaded contexts, and, if misused, could lead to data corruption and other unpredictable errors.
@@ -232,12 +240,21 @@ class hash_set
         list() : m_node()
         {
         }
-        list(list &&other) noexcept : m_node()
+        // NOTE: the nodes past the first one belong to the node pool of the set containing the list,
+        // so lists cannot be copied or moved around on their own.
+        list(const list &) = delete;
+        list(list &&) = delete;
+        list &operator=(const list &) = delete;
+        list &operator=(list &&) = delete;
+        ~list()
         {
-            steal_from_rvalue(std::move(other));
+            destroy();
         }
-        list(const list &other) : m_node()
+        // Copy the content of other into this, which must be empty. The additional nodes are taken
+        // from the node pool of hs.
+        void copy_from(const list &other, hash_set &hs)
         {
+            piranha_assert(empty());
             try {
                 auto cur = &m_node;
                 auto other_cur = &other.m_node;
@@ -248,11 +265,17 @@ class hash_set
                         piranha_assert(cur->m_next == &terminator);
                         // Create a new node with content equal to other_cur
                         // and linking forward to the terminator.
-                        std::unique_ptr<node> new_node(::new node());
-                        ::new (static_cast<void *>(&new_node->m_storage)) T(*other_cur->ptr());
+                        auto &pool = hs.get_pool();
+                        const auto new_node = pool.allocate();
+                        try {
+                            ::new (static_cast<void *>(&new_node->m_storage)) T(*other_cur->ptr());
+                        } catch (...) {
+                            pool.deallocate(new_node);
+                            throw;
+                        }
                         new_node->m_next = &terminator;
                         // Link the new node.
-                        cur->m_next = new_node.release();
+                        cur->m_next = new_node;
                         cur = cur->m_next;
                     } else {
                         // This means this is the first node.
@@ -266,53 +289,23 @@ class hash_set
                 throw;
             }
         }
-        list &operator=(list &&other)
-        {
-            if (likely(this != &other)) {
-                // Destroy the content of this.
-                destroy();
-                steal_from_rvalue(std::move(other));
-            }
-            return *this;
-        }
-        list &operator=(const list &other)
-        {
-            if (likely(this != &other)) {
-                auto tmp = other;
-                *this = std::move(tmp);
-            }
-            return *this;
-        }
-        ~list()
-        {
-            destroy();
-        }
-        void steal_from_rvalue(list &&other)
-        {
-            piranha_assert(empty());
-            // Do something only if there is content in the other.
-            if (other.m_node.m_next) {
-                // Move construct current first node with first node of other.
-                ::new (static_cast<void *>(&m_node.m_storage)) T(std::move(*other.m_node.ptr()));
-                // Link remaining content of other into this.
-                m_node.m_next = other.m_node.m_next;
-                // Destroy first node of other.
-                other.m_node.ptr()->~T();
-                other.m_node.m_next = nullptr;
-            }
-            piranha_assert(other.empty());
-        }
         template <typename U, enable_if_t<std::is_same<T, uncvref_t<U>>::value, int> = 0>
-        node *insert(U &&item)
+        node *insert(U &&item, hash_set &hs)
         {
             // NOTE: optimize with likely/unlikely?
             if (m_node.m_next) {
                 // Create the new node and forward-link it to the second node.
-                std::unique_ptr<node> new_node(::new node());
-                ::new (static_cast<void *>(&new_node->m_storage)) T(std::forward<U>(item));
+                auto &pool = hs.get_pool();
+                const auto new_node = pool.allocate();
+                try {
+                    ::new (static_cast<void *>(&new_node->m_storage)) T(std::forward<U>(item));
+                } catch (...) {
+                    pool.deallocate(new_node);
+                    throw;
+                }
                 new_node->m_next = m_node.m_next;
                 // Link first node to the new node.
-                m_node.m_next = new_node.release();
+                m_node.m_next = new_node;
                 return m_node.m_next;
             } else {
                 ::new (static_cast<void *>(&m_node.m_storage)) T(std::forward<U>(item));
@@ -340,6 +333,8 @@ class hash_set
         {
             return !m_node.m_next;
         }
+        // NOTE: this destroys the payloads, but it does not give back the additional nodes to the
+        // node pool: they are released in bulk together with the pool.
         void destroy()
         {
             node *cur = &m_node;
@@ -351,10 +346,6 @@ class hash_set
                 // Destroy the old payload and erase connections.
                 old->ptr()->~T();
                 old->m_next = nullptr;
-                // If the old node was not the initial one, delete it.
-                if (old != &m_node) {
-                    ::delete old;
-                }
             }
             // After destruction, the list should be equivalent to a default-constructed one.
             piranha_assert(empty());
@@ -369,6 +360,8 @@ class hash_set
     // NOTE: for std::allocator, pointer is guaranteed to be "T *":
     // http://en.cppreference.com/w/cpp/memory/allocator
     typedef std::allocator<list> allocator_type;
+    // Pool for the nodes of the lists past the first one.
+    using pool_type = detail::node_pool<node>;
 
 public:
     /// Functor type for the calculation of hash values.
@@ -544,19 +537,97 @@ private:
         ptr() = new_ptr;
         m_log2_size = log2_size;
     }
-    // Destroy all elements and deallocate ptr().
+    // Get the node pool, creating it if necessary. This can be called concurrently from multiple threads
+    // (e.g., when inserting concurrently into different buckets).
+    pool_type &get_pool()
+    {
+        auto retval = m_pool.load(std::memory_order_acquire);
+        if (likely(retval != nullptr)) {
+            return *retval;
+        }
+        // NOTE: one cache slot per thread in use.
+        std::unique_ptr<pool_type> new_pool(::new pool_type(settings::get_n_threads()));
+        if (m_pool.compare_exchange_strong(retval, new_pool.get(), std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+            return *new_pool.release();
+        }
+        // Another thread created the pool in the meantime.
+        piranha_assert(retval != nullptr);
+        return *retval;
+    }
+    // Number of threads to be used for bulk operations (copy, rehash, destruction) on a set
+    // with n_elements elements. The thread pool is used only above the minimum work per thread
+    // (see piranha::settings::get_min_work_per_thread()), and never from within the pool itself.
+    static unsigned bulk_n_threads(const size_type &n_elements)
+    {
+        const auto min_work = settings::get_min_work_per_thread();
+        // NOTE: quick exit for small sets, which use_threads() would assign to a single thread anyway.
+        if (static_cast<unsigned long long>(n_elements) / 2u < min_work) {
+            return 1u;
+        }
+        return thread_pool::use_threads(integer(n_elements), integer(min_work));
+    }
+    // Call f(start, end) on n_threads approximately equal subranges of [0, size), using the first
+    // n_threads threads of the pool. Any exception thrown by f will be re-thrown after all the threads
+    // have finished.
+    template <typename F>
+    static void parallel_for_ranges(const size_type &size, unsigned n_threads, const F &f)
+    {
+        piranha_assert(n_threads > 1u);
+        detail::parallel_run(n_threads, [&f, &size, n_threads](unsigned i) {
+            const auto r = detail::parallel_chunk(size, n_threads, i);
+            f(r.first, r.second);
+        });
+    }
+    // Destroy all elements and deallocate ptr() and the node pool.
     void destroy_and_deallocate()
     {
         // Proceed to destroy all elements and deallocate only if the set is actually storing something.
         if (ptr()) {
             const size_type size = size_type(1u) << m_log2_size;
-            for (size_type i = 0u; i < size; ++i) {
-                allocator().destroy(&ptr()[i]);
+            auto destroy_range = [this](const size_type &start, const size_type &end) {
+                for (size_type i = start; i != end; ++i) {
+                    this->allocator().destroy(&this->ptr()[i]);
+                }
+            };
+            unsigned n_threads = 1u;
+            try {
+                n_threads = static_cast<unsigned>(std::min<size_type>(bulk_n_threads(m_n_elements), size));
+            } catch (...) {
+                // NOTE: destruction cannot fail, just fall back to the serial implementation.
+            }
+            if (n_threads == 1u) {
+                destroy_range(0u, size);
+            } else {
+                // NOTE: the ranges which could not be handed over to the thread pool (because of
+                // errors in enqueue()) are destroyed in the calling thread. If push_back() throws,
+                // it will have waited for the completion of the enqueued range.
+                unsigned n_enqueued = 0u;
+                {
+                    future_list<decltype(destroy_range(0u, 0u))> f_list;
+                    try {
+                        while (n_enqueued < n_threads) {
+                            const auto r = detail::parallel_chunk(size, n_threads, n_enqueued);
+                            auto f = thread_pool::enqueue(n_enqueued, destroy_range, r.first, r.second);
+                            ++n_enqueued;
+                            f_list.push_back(std::move(f));
+                        }
+                    } catch (...) {
+                    }
+                    f_list.wait_all();
+                }
+                for (auto i = n_enqueued; i < n_threads; ++i) {
+                    const auto r = detail::parallel_chunk(size, n_threads, i);
+                    destroy_range(r.first, r.second);
+                }
             }
             allocator().deallocate(ptr(), size);
         } else {
             piranha_assert(!m_log2_size && !m_n_elements);
         }
+        // Release in bulk all the additional nodes.
+        ::delete m_pool.load(std::memory_order_relaxed);
+        m_pool.store(nullptr, std::memory_order_relaxed);
     }
     // Serialization support.
     friend class boost::serialization::access;
@@ -677,7 +748,7 @@ public:
      * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>.
      */
     hash_set(const hasher &h = hasher{}, const key_equal &k = key_equal{})
-        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u)
+        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u), m_pool(nullptr)
     {
     }
     /// Constructor from number of buckets.
@@ -701,46 +772,49 @@ public:
      */
     explicit hash_set(const size_type &n_buckets, const hasher &h = hasher{}, const key_equal &k = key_equal{},
                       unsigned n_threads = 1u)
-        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u)
+        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u), m_pool(nullptr)
     {
         init_from_n_buckets(n_buckets, n_threads);
     }
     /// Copy constructor.
     /**
-     * The hasher, the equality comparator and the allocator will also be copied.
+     * The hasher, the equality comparator and the allocator will also be copied. If \p other is large enough
+     * (see piranha::settings::get_min_work_per_thread()), the copy will be performed in parallel using
+     * piranha::thread_pool.
      *
      * @param other piranha::hash_set that will be copied into \p this.
      *
      * @throws unspecified any exception thrown by memory allocation errors,
-     * the copy constructor of the stored type, <tt>Hash</tt> or <tt>Pred</tt>.
+     * the copy constructor of the stored type, <tt>Hash</tt> or <tt>Pred</tt>, piranha::thread_pool::enqueue()
+     * or piranha::future_list::push_back().
      */
     hash_set(const hash_set &other)
-        : m_pack(nullptr, other.hash(), other.k_equal(), other.allocator()), m_log2_size(0u), m_n_elements(0u)
+        : m_pack(nullptr, other.hash(), other.k_equal(), other.allocator()), m_log2_size(0u), m_n_elements(0u),
+          m_pool(nullptr)
     {
         // Proceed to actual copy only if other has some content.
         if (other.ptr()) {
             const size_type size = size_type(1u) << other.m_log2_size;
-            auto new_ptr = allocator().allocate(size);
-            if (unlikely(!new_ptr)) {
-                piranha_throw(std::bad_alloc, );
-            }
-            size_type i = 0u;
+            const auto n_threads = static_cast<unsigned>(std::min<size_type>(bulk_n_threads(other.m_n_elements), size));
+            init_from_n_buckets(size, n_threads);
+            piranha_assert(m_log2_size == other.m_log2_size);
+            // NOTE: the lists can be copied concurrently, as the node pool is thread-safe.
+            auto copy_range = [this, &other](const size_type &start, const size_type &end) {
+                for (size_type i = start; i != end; ++i) {
+                    this->ptr()[i].copy_from(other.ptr()[i], *this);
+                }
+            };
             try {
-                // Copy-construct the elements of the array.
-                for (; i < size; ++i) {
-                    allocator().construct(&new_ptr[i], other.ptr()[i]);
+                if (n_threads == 1u) {
+                    copy_range(0u, size);
+                } else {
+                    parallel_for_ranges(size, n_threads, copy_range);
                 }
             } catch (...) {
                 // Unwind the construction and deallocate, before re-throwing.
-                for (size_type j = 0u; j < i; ++j) {
-                    allocator().destroy(&new_ptr[j]);
-                }
-                allocator().deallocate(new_ptr, size);
+                destroy_and_deallocate();
                 throw;
             }
-            // Assign the members.
-            ptr() = new_ptr;
-            m_log2_size = other.m_log2_size;
             m_n_elements = other.m_n_elements;
         } else {
             piranha_assert(!other.m_log2_size && !other.m_n_elements);
@@ -754,10 +828,12 @@ public:
      * @param other set to be moved.
      */
     hash_set(hash_set &&other) noexcept
-        : m_pack(std::move(other.m_pack)), m_log2_size(other.m_log2_size), m_n_elements(other.m_n_elements)
+        : m_pack(std::move(other.m_pack)), m_log2_size(other.m_log2_size), m_n_elements(other.m_n_elements),
+          m_pool(other.m_pool.load(std::memory_order_relaxed))
     {
         // Clear out the other one.
         other.ptr() = nullptr;
+        other.m_pool.store(nullptr, std::memory_order_relaxed);
         other.m_log2_size = 0u;
         other.m_n_elements = 0u;
     }
@@ -779,7 +855,7 @@ public:
     template <typename InputIterator>
     explicit hash_set(const InputIterator &begin, const InputIterator &end, const size_type &n_buckets = 0u,
                       const hasher &h = hasher{}, const key_equal &k = key_equal{})
-        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u)
+        : m_pack(nullptr, h, k, allocator_type{}), m_log2_size(0u), m_n_elements(0u), m_pool(nullptr)
     {
         init_from_n_buckets(n_buckets, 1u);
         for (auto it = begin; it != end; ++it) {
@@ -799,7 +875,7 @@ public:
      */
     template <typename U>
     explicit hash_set(std::initializer_list<U> list)
-        : m_pack(nullptr, hasher{}, key_equal{}, allocator_type{}), m_log2_size(0u), m_n_elements(0u)
+        : m_pack(nullptr, hasher{}, key_equal{}, allocator_type{}), m_log2_size(0u), m_n_elements(0u), m_pool(nullptr)
     {
         // We do not care here for possible truncation of list.size(), as this is only an optimization.
         init_from_n_buckets(static_cast<size_type>(list.size()), 1u);
@@ -809,7 +885,7 @@ public:
     }
     /// Destructor.
     /**
-     * No side effects.
+     * No side effects. Large sets are destroyed in parallel using piranha::thread_pool.
      */
     ~hash_set()
     {
@@ -845,8 +921,10 @@ public:
             m_pack = std::move(other.m_pack);
             m_log2_size = other.m_log2_size;
             m_n_elements = other.m_n_elements;
+            m_pool.store(other.m_pool.load(std::memory_order_relaxed), std::memory_order_relaxed);
             // Zero out other.
             other.ptr() = nullptr;
+            other.m_pool.store(nullptr, std::memory_order_relaxed);
             other.m_log2_size = 0u;
             other.m_n_elements = 0u;
         }
@@ -1124,13 +1202,17 @@ public:
         std::swap(m_pack, other.m_pack);
         std::swap(m_log2_size, other.m_log2_size);
         std::swap(m_n_elements, other.m_n_elements);
+        const auto tmp_pool = m_pool.load(std::memory_order_relaxed);
+        m_pool.store(other.m_pool.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        other.m_pool.store(tmp_pool, std::memory_order_relaxed);
     }
     /// Rehash set.
     /**
      * Change the number of buckets in the set to at least \p new_size. No rehash is performed
      * if rehashing would lead to exceeding the maximum load factor. If \p n_threads is not 1,
      * then the first \p n_threads threads from piranha::thread_pool will be used concurrently during
-     * the rehash operation.
+     * the rehash operation, both for the initialisation of the new buckets and for moving the elements
+     * into them.
      *
      * @param new_size new desired number of buckets.
      * @param n_threads number of threads to use.
@@ -1158,10 +1240,28 @@ public:
         // Create a new set with needed amount of buckets.
         hash_set new_set(new_size, hash(), k_equal(), n_threads);
         try {
-            const auto it_f = _m_end();
-            for (auto it = _m_begin(); it != it_f; ++it) {
-                const auto new_idx = new_set._bucket(*it);
-                new_set._unique_insert(std::move(*it), new_idx);
+            if (n_threads == 1u || !ptr()) {
+                const auto it_f = _m_end();
+                for (auto it = _m_begin(); it != it_f; ++it) {
+                    const auto new_idx = new_set._bucket(*it);
+                    new_set._unique_insert(std::move(*it), new_idx);
+                }
+            } else {
+                // The bucket counts are powers of two, hence the destination bucket of an element has the same
+                // residue modulo the smaller bucket count m as its current bucket. Partitioning the residues
+                // modulo m among the threads, each thread will read from and write to its own sets of buckets.
+                const auto old_size = bucket_count(), m = std::min(old_size, new_set.bucket_count());
+                auto move_range = [this, &new_set, old_size, m](const size_type &start, const size_type &end) {
+                    for (size_type r = start; r != end; ++r) {
+                        for (size_type i = r; i < old_size; i += m) {
+                            for (auto &x : this->ptr()[i]) {
+                                const auto new_idx = new_set._bucket(x);
+                                new_set._unique_insert(std::move(x), new_idx);
+                            }
+                        }
+                    }
+                };
+                parallel_for_ranges(m, static_cast<unsigned>(std::min<size_type>(n_threads, m)), move_range);
             }
         } catch (...) {
             // Clear up both this and the new set upon any kind of error.
@@ -1272,7 +1372,7 @@ public:
         piranha_assert(find(std::forward<U>(k)) == end());
         // Assert bucket index is correct.
         piranha_assert(bucket_idx == _bucket(k));
-        auto p = ptr()[bucket_idx].insert(std::forward<U>(k));
+        auto p = ptr()[bucket_idx].insert(std::forward<U>(k), *this);
         return iterator(this, bucket_idx, local_iterator(p));
     }
     /// Find element (low-level).
@@ -1344,7 +1444,8 @@ public:
     }
     /// Increase bucket count.
     /**
-     * Increase the number of buckets to the next implementation-defined value.
+     * Increase the number of buckets to the next implementation-defined value. Large sets
+     * will be rehashed in parallel using piranha::thread_pool.
      *
      * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
      * maximum number of buckets.
@@ -1359,8 +1460,8 @@ public:
         // the next log2_size is 0u. Otherwise increase current log2_size.
         piranha_assert(ptr() || (!ptr() && !m_log2_size));
         const auto new_log2_size = (ptr()) ? (m_log2_size + 1u) : 0u;
-        // Rehash to the new size.
-        rehash(size_type(1u) << new_log2_size);
+        // Rehash to the new size, in parallel for large sets.
+        rehash(size_type(1u) << new_log2_size, bulk_n_threads(m_n_elements));
     }
     /// Const reference to list in bucket.
     /**
@@ -1413,7 +1514,7 @@ public:
                 // Move-construct from the second element, and then destroy it.
                 ::new (static_cast<void *>(&bucket.m_node.m_storage)) T(std::move(*bucket.m_node.m_next->ptr()));
                 bucket.m_node.m_next->ptr()->~T();
-                ::delete bucket.m_node.m_next;
+                get_pool().deallocate(bucket.m_node.m_next);
                 // Establish the new link.
                 bucket.m_node.m_next = tmp;
                 return bucket.begin();
@@ -1429,7 +1530,7 @@ public:
                     prev_b_it.m_ptr->m_next = b_it.m_ptr->m_next;
                     // Delete the current one.
                     b_it.m_ptr->ptr()->~T();
-                    ::delete b_it.m_ptr;
+                    get_pool().deallocate(b_it.m_ptr);
                     break;
                 };
             }
@@ -1447,6 +1548,7 @@ private:
     pack_type m_pack;
     size_type m_log2_size;
     size_type m_n_elements;
+    std::atomic<pool_type *> m_pool;
 };
 
 template <typename T, typename Hash, typename Pred>
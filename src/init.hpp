@@ -30,10 +30,12 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_INIT_HPP
 
 #include <cstdlib>
+#include <exception>
 #include <iostream>
 
 #include "detail/init_data.hpp"
 #include "detail/mpfr.hpp"
+#include "tuning.hpp"
 
 namespace piranha
 {
@@ -57,6 +59,10 @@ inline void cleanup_function()
  * It will register cleanup functions that will be run on program exit (e.g.,
  * the MPFR <tt>mpfr_free_cache()</tt> function).
  *
+ * If the environment variable \p PIRANHA_TUNING_FILE is set, the tuning parameters will be loaded from the file it
+ * refers to via piranha::tuning::load_parameters(). Errors in the loading of the file will be reported to the
+ * standard error stream, and the tuning parameters will not be modified.
+ *
  * It is allowed to call this function concurrently from multiple threads: after the first
  * invocation, additional invocations will not perform any action.
  */
@@ -98,6 +104,15 @@ inline void init()
         std::cerr << "The MPFR library was not built thread-safe.\n";
         std::cerr.flush();
     }
+    if (const char *tuning_file = std::getenv("PIRANHA_TUNING_FILE")) {
+        try {
+            tuning::load_parameters(tuning_file);
+        } catch (const std::exception &e) {
+            // NOTE: logging candidate.
+            std::cerr << "Unable to load the tuning parameters: " << e.what() << '\n';
+            std::cerr.flush();
+        }
+    }
 }
 }
 
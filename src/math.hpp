@@ -34,6 +34,7 @@ see https://www.gnu.org/licenses/. */
 #include <cmath>
 #include <complex>
 #include <cstdarg>
+#include <deque>
 #include <initializer_list>
 #include <iterator>
 #include <stdexcept>
@@ -433,6 +434,173 @@ inline void multiply_accumulate(T &x, const T &y, const T &z)
     multiply_accumulate_impl<T>{}(x, y, z);
 }
 
+/// Default functor for the implementation of piranha::math::multiply_all().
+/**
+ * This functor can be specialised via the \p std::enable_if mechanism.
+ */
+template <typename T, typename = void>
+struct multiply_all_impl {
+private:
+    template <typename U>
+    using mul_t = decltype(std::declval<const U &>() * std::declval<const U &>());
+    template <typename U>
+    using size_t_ = decltype(std::declval<const U &>().size());
+    template <typename U>
+    using enabler
+        = enable_if_t<conjunction<std::is_same<detected_t<mul_t, U>, U>, std::is_constructible<U, int>,
+                                  std::is_move_constructible<U>, std::is_move_assignable<U>>::value,
+                      int>;
+    // The weight of an operand: its size, if available, otherwise 1.
+    template <typename U, enable_if_t<is_detected<size_t_, U>::value, int> = 0>
+    static double weight(const U &x)
+    {
+        return static_cast<double>(x.size());
+    }
+    template <typename U, enable_if_t<!is_detected<size_t_, U>::value, int> = 0>
+    static double weight(const U &)
+    {
+        return 1.;
+    }
+    // Weight of the product of two operands with weights w1 and w2, given the product itself.
+    template <typename U, enable_if_t<is_detected<size_t_, U>::value, int> = 0>
+    static double product_weight(const U &x, double, double)
+    {
+        return weight(x);
+    }
+    template <typename U, enable_if_t<!is_detected<size_t_, U>::value, int> = 0>
+    static double product_weight(const U &, double w1, double w2)
+    {
+        return w1 + w2;
+    }
+
+public:
+    /// Call operator.
+    /**
+     * \note
+     * This call operator is enabled only if the type \p U is the same as the type resulting from the
+     * multiplication of two instances of \p U, and if \p U is constructible from \p int and move constructible and
+     * assignable.
+     *
+     * The operands in the range <tt>[begin, end)</tt> are multiplied via a product tree in which, at each step, the
+     * two operands of smallest weight are multiplied together. The weight of an operand is its size, as returned
+     * by a <tt>size()</tt> method (if available), or 1 otherwise. The weight of an intermediate product is its
+     * size, if available, or the sum of the weights of the factors otherwise. This results in a balanced product tree
+     * for operands of similar size, and it postpones the multiplications involving large operands as much as
+     * possible. The operands in the range are not copied.
+     *
+     * If the range is empty, the value 1 will be returned.
+     *
+     * @param begin start of the range.
+     * @param end end of the range.
+     *
+     * @return the product of the values in the range.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the multiplication, construction and assignment operators of \p U,
+     * - memory errors in standard containers,
+     * - the <tt>size()</tt> method of \p U.
+     */
+    template <typename It, typename U = T, enabler<U> = 0>
+    U operator()(It begin, It end) const
+    {
+        // A node of the product tree: the weight and a pointer to the operand.
+        using node = std::pair<double, U const *>;
+        // Storage for the intermediate products.
+        // NOTE: we use a deque so that the pointers to the existing elements are not invalidated by
+        // the insertion of new elements.
+        std::deque<U> products;
+        std::vector<node> heap;
+        for (; begin != end; ++begin) {
+            const U &x = *begin;
+            heap.emplace_back(weight(x), &x);
+        }
+        if (heap.empty()) {
+            return U(1);
+        }
+        // Min-heap on the weights.
+        auto cmp = [](const node &n1, const node &n2) { return n1.first > n2.first; };
+        std::make_heap(heap.begin(), heap.end(), cmp);
+        while (heap.size() > 1u) {
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            const node n1 = heap.back();
+            heap.pop_back();
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            const node n2 = heap.back();
+            heap.pop_back();
+            products.push_back(*n1.second * *n2.second);
+            heap.emplace_back(product_weight(products.back(), n1.first, n2.first), &products.back());
+            std::push_heap(heap.begin(), heap.end(), cmp);
+        }
+        // NOTE: if the result is an intermediate product, we can move it out.
+        if (!products.empty() && heap[0u].second == &products.back()) {
+            return std::move(products.back());
+        }
+        return *heap[0u].second;
+    }
+};
+} // namespace math
+
+inline namespace impl
+{
+
+// Enabler for multiply_all.
+template <typename It>
+using math_multiply_all_t = decltype(math::multiply_all_impl<typename std::iterator_traits<It>::value_type>{}(
+    std::declval<const It &>(), std::declval<const It &>()));
+
+template <typename It>
+using math_multiply_all_enabler = enable_if_t<is_detected<math_multiply_all_t, It>::value, int>;
+
+template <typename Range>
+using math_multiply_all_range_it = decltype(std::begin(std::declval<const Range &>()));
+} // namespace impl
+
+namespace math
+{
+
+/// Multiply all the values in a range.
+/**
+ * \note
+ * This function is enabled only if the expression <tt>multiply_all_impl<T>{}(begin, end)</tt> is valid, where \p T is
+ * the value type of \p It.
+ *
+ * The actual implementation of this function is in the piranha::math::multiply_all_impl functor's call operator.
+ * The body of this function is equivalent to:
+ * @code
+ * return multiply_all_impl<T>{}(begin, end);
+ * @endcode
+ *
+ * @param begin start of the range.
+ * @param end end of the range.
+ *
+ * @return the product of the values in the range <tt>[begin, end)</tt>.
+ *
+ * @throws unspecified any exception thrown by the call operator of piranha::math::multiply_all_impl.
+ */
+template <typename It, math_multiply_all_enabler<It> = 0>
+inline math_multiply_all_t<It> multiply_all(It begin, It end)
+{
+    return multiply_all_impl<typename std::iterator_traits<It>::value_type>{}(begin, end);
+}
+
+/// Multiply all the values in a range (convenience overload).
+/**
+ * \note
+ * This function is enabled only if the other overload of multiply_all() can be called on the iterators of
+ * \p r.
+ *
+ * @param r the input range.
+ *
+ * @return <tt>multiply_all(std::begin(r), std::end(r))</tt>.
+ *
+ * @throws unspecified any exception thrown by the other overload of multiply_all().
+ */
+template <typename Range, math_multiply_all_enabler<math_multiply_all_range_it<Range>> = 0>
+inline math_multiply_all_t<math_multiply_all_range_it<Range>> multiply_all(const Range &r)
+{
+    return multiply_all(std::begin(r), std::end(r));
+}
+
 /// Default functor for the implementation of piranha::math::cos().
 /**
  * This functor should be specialised via the \p std::enable_if mechanism. Default implementation will not define
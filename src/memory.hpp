@@ -34,6 +34,7 @@ see https://www.gnu.org/licenses/. */
  */
 
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <new>
@@ -44,6 +45,7 @@ see https://www.gnu.org/licenses/. */
 
 #include "config.hpp"
 #include "exceptions.hpp"
+#include "runtime_info.hpp"
 #include "thread_pool.hpp"
 #include "type_traits.hpp"
 
@@ -245,6 +247,45 @@ inline bool alignment_check(const std::size_t &alignment)
     return true;
 }
 
+namespace detail
+{
+
+// Compute the index of the first element of the range of the array ptr of the given size that is assigned to thread
+// idx in a parallel operation run by n_threads threads. The ranges are of approximately equal size, and their
+// boundaries are aligned (when possible) to the memory pages. In this way, each page is touched first by a single
+// thread and, on NUMA machines with a first-touch policy, it is placed on the node of that thread.
+template <typename T>
+inline std::size_t parallel_range_begin(const T *ptr, const std::size_t &size, const unsigned &idx,
+                                        const unsigned &n_threads)
+{
+    piranha_assert(n_threads > 0u && idx <= n_threads);
+    if (idx == 0u) {
+        return 0u;
+    }
+    if (idx == n_threads) {
+        return size;
+    }
+    const auto wpt = static_cast<std::size_t>(size / n_threads), candidate = static_cast<std::size_t>(idx * wpt);
+    // NOTE: this is detected only once.
+    static const unsigned page_size = runtime_info::get_page_size();
+    if (page_size == 0u || wpt * sizeof(T) < page_size) {
+        // Page size unknown or ranges smaller than a page, don't align.
+        return candidate;
+    }
+    // Round up the address of the candidate boundary to the next page boundary, and locate the first
+    // element that begins at or after it.
+    const auto addr = reinterpret_cast<std::uintptr_t>(ptr) + candidate * sizeof(T),
+               rem = static_cast<std::uintptr_t>(addr % page_size);
+    if (rem == 0u) {
+        return candidate;
+    }
+    const auto delta = static_cast<std::size_t>(page_size - rem);
+    const auto retval = static_cast<std::size_t>(candidate + delta / sizeof(T) + (delta % sizeof(T) != 0u));
+    // Never overshoot the ideal start of the next range.
+    return (retval > candidate + wpt) ? candidate : retval;
+}
+}
+
 /// Parallel value initialisation.
 /**
  * \note
@@ -306,12 +347,13 @@ inline void parallel_value_init(T *ptr, const std::size_t &size, const unsigned
         if (unlikely(inited_ranges.size() != n_threads)) {
             piranha_throw(std::bad_alloc, );
         }
-        // Work per thread.
-        const auto wpt = static_cast<std::size_t>(size / n_threads);
         future_list<decltype(init_function(ptr, ptr, 0u, &inited_ranges))> f_list;
         try {
             for (auto i = 0u; i < n_threads; ++i) {
-                auto start = ptr + i * wpt, end = (i == n_threads - 1u) ? ptr + size : ptr + (i + 1u) * wpt;
+                // NOTE: the ranges are page-aligned, so that memory is placed on the NUMA node of the
+                // thread that will (likely) use it.
+                auto start = ptr + detail::parallel_range_begin(ptr, size, i, n_threads),
+                     end = ptr + detail::parallel_range_begin(ptr, size, i + 1u, n_threads);
                 f_list.push_back(thread_pool::enqueue(i, init_function, start, end, i, &inited_ranges));
             }
             f_list.wait_all();
@@ -384,11 +426,11 @@ inline void parallel_destroy(T *ptr, const std::size_t &size, const unsigned &n_
             return;
         }
         try {
-            // Work per thread.
-            const auto wpt = static_cast<std::size_t>(size / n_threads);
-            // The ranges to destroy in the cleanup phase are, initially, all the ranges.
+            // The ranges to destroy in the cleanup phase are, initially, all the ranges. They are the same
+            // used in parallel_value_init(), so that each thread operates on memory local to it.
             for (auto i = 0u; i < n_threads; ++i) {
-                auto start = ptr + i * wpt, end = (i == n_threads - 1u) ? ptr + size : ptr + (i + 1u) * wpt;
+                auto start = ptr + detail::parallel_range_begin(ptr, size, i, n_threads),
+                     end = ptr + detail::parallel_range_begin(ptr, size, i + 1u, n_threads);
                 d_ranges[static_cast<rv_size_type>(i)] = std::make_pair(start, end);
             }
             // Perform the actual destruction and update the d_ranges vector.
@@ -1326,15 +1326,24 @@ struct is_mp_integer_interoperable_type {
  * mp_rational, but if exceptions
  *   are allowed then we need to change the implementation to the copy+move idiom.
  */
+namespace detail
+{
+
+template <int>
+class mp_integer_accumulator;
+}
+
 template <int NBits = 0>
 class mp_integer
 {
-    // Make friend with debugging class, mp_rational and real.
+    // Make friend with debugging class, mp_rational, real and the accumulator.
     template <typename>
     friend class debug_access;
     template <int>
     friend class mp_rational;
     friend class real;
+    template <int>
+    friend class detail::mp_integer_accumulator;
     // Import the interoperable types detector.
     template <typename T>
     using is_interoperable_type = detail::is_mp_integer_interoperable_type<T>;
@@ -4442,6 +4451,247 @@ struct is_mp_integer : std::false_type {
 template <int NBits>
 struct is_mp_integer<mp_integer<NBits>> : std::true_type {
 };
+
+// Accumulator for sums of products of integers fitting in a single limb, used in the multiplication of series.
+// The accumulated value is m_hi * 2**(2 * limb_bits) + m_lo, where m_lo is an unsigned double limb and m_hi counts
+// the wraparounds of m_lo. With respect to mp_integer::multiply_accumulate(), there are no overflow checks and no
+// promotions to dynamic storage in the accumulation, and the conversion to mp_integer happens only once, in get().
+template <int NBits>
+class mp_integer_accumulator
+{
+    using s_storage = typename integer_union<NBits>::s_storage;
+    using limb_t = typename s_storage::limb_t;
+    using dlimb_t = typename s_storage::dlimb_t;
+    // NOTE: the wraparound logic needs limb types without padding bits.
+    static const bool usable = sizeof(limb_t) * CHAR_BIT == s_storage::limb_bits
+                               && sizeof(dlimb_t) * CHAR_BIT == 2u * s_storage::limb_bits;
+
+public:
+    mp_integer_accumulator() : m_lo(0u), m_hi(0)
+    {
+    }
+    // Check if n can be used as a factor in multiply_accumulate().
+    static bool is_eligible(const mp_integer<NBits> &n)
+    {
+        return usable && n.is_static() && n.m_int.g_st()._mp_size >= -1 && n.m_int.g_st()._mp_size <= 1;
+    }
+    // Check if the accumulation of n products cannot overflow: each product wraps m_lo at most once.
+    static bool can_accumulate(const std::size_t &n)
+    {
+        return static_cast<unsigned long long>(n) <= static_cast<unsigned long long>(
+                                                         std::numeric_limits<long long>::max());
+    }
+    void multiply_accumulate(const mp_integer<NBits> &a, const mp_integer<NBits> &b)
+    {
+        piranha_assert(is_eligible(a) && is_eligible(b));
+        const auto &sa = a.m_int.g_st(), &sb = b.m_int.g_st();
+        if (sa._mp_size == 0 || sb._mp_size == 0) {
+            return;
+        }
+        const auto p = static_cast<dlimb_t>(static_cast<dlimb_t>(sa.m_limbs[0u]) * sb.m_limbs[0u]);
+        if ((sa._mp_size > 0) == (sb._mp_size > 0)) {
+            m_lo = static_cast<dlimb_t>(m_lo + p);
+            if (m_lo < p) {
+                ++m_hi;
+            }
+        } else {
+            if (m_lo < p) {
+                --m_hi;
+            }
+            m_lo = static_cast<dlimb_t>(m_lo - p);
+        }
+    }
+    bool is_zero() const
+    {
+        return m_lo == 0u && m_hi == 0;
+    }
+    mp_integer<NBits> get() const
+    {
+        const auto lb = s_storage::limb_bits;
+        // Magnitude of the value.
+        const bool neg = m_hi < 0;
+        unsigned long long mhi;
+        dlimb_t mlo;
+        if (!neg) {
+            mhi = static_cast<unsigned long long>(m_hi);
+            mlo = m_lo;
+        } else if (m_lo == 0u) {
+            mhi = 0ull - static_cast<unsigned long long>(m_hi);
+            mlo = 0u;
+        } else {
+            mhi = 0ull - static_cast<unsigned long long>(m_hi + 1);
+            mlo = static_cast<dlimb_t>(dlimb_t(0u) - m_lo);
+        }
+        const auto lo_hi = static_cast<limb_t>(mlo >> lb), lo_lo = static_cast<limb_t>(mlo);
+        mp_integer<NBits> retval(mhi);
+        if (mhi != 0u || lo_hi != 0u) {
+            retval <<= lb;
+            retval += lo_hi;
+            retval <<= lb;
+            retval += lo_lo;
+        } else {
+            retval = lo_lo;
+        }
+        if (neg) {
+            retval.negate();
+        }
+        return retval;
+    }
+
+private:
+    dlimb_t m_lo;
+    long long m_hi;
+};
+
+#if defined(PIRANHA_UINT128_T)
+
+// The moduli of the multimodular representation of integers: the 16 largest primes below 2**50.
+inline unsigned long long crt_prime(const std::size_t &k)
+{
+    static const unsigned long long primes[] = {
+        1125899906842597ull, 1125899906842589ull, 1125899906842573ull, 1125899906842553ull,
+        1125899906842511ull, 1125899906842507ull, 1125899906842493ull, 1125899906842463ull,
+        1125899906842429ull, 1125899906842391ull, 1125899906842357ull, 1125899906842283ull,
+        1125899906842273ull, 1125899906842247ull, 1125899906842201ull, 1125899906842177ull};
+    piranha_assert(k < 16u);
+    return primes[k];
+}
+
+// Multimodular accumulator for sums of products of integers, used in the multiplication of series with large
+// integral coefficients. The factors are represented by their residues modulo the first K primes returned by
+// crt_prime(), the products of the residues are accumulated in 128-bit integers without any intermediate reduction,
+// and the value is reconstructed via the Chinese remainder theorem only once, in get(). The reconstruction is exact
+// if the absolute value of the accumulated sum has at most max_bits() bits: it is up to the user to check this
+// beforehand, e.g., from the sizes of the factors.
+template <int NBits, std::size_t K>
+class mp_integer_crt_accumulator
+{
+    static_assert(K > 0u && K <= 16u, "Invalid number of moduli.");
+    static_assert(GMP_NUMB_BITS <= 64, "Invalid GMP limb size.");
+    using uint128 = PIRANHA_UINT128_T;
+    using inv_table = std::array<std::array<unsigned long long, K>, K>;
+
+public:
+    using residues = std::array<unsigned long long, K>;
+    mp_integer_crt_accumulator()
+    {
+        m_acc.fill(0u);
+    }
+    // The product of the moduli is greater than 2**(50 * K - 1), hence all values whose absolute value
+    // is less than 2**(50 * K - 2) are represented unambiguously in the symmetric range.
+    static unsigned max_bits()
+    {
+        return static_cast<unsigned>(50u * K - 2u);
+    }
+    // Each product of residues is less than 2**100, hence up to 2**28 products can be accumulated.
+    static bool can_accumulate(const std::size_t &n)
+    {
+        return static_cast<unsigned long long>(n) <= (1ull << 28u);
+    }
+    static residues reduce(const mp_integer<NBits> &n)
+    {
+        auto v = n.get_mpz_view();
+        const auto size = ::mpz_size(v);
+        residues retval;
+        for (std::size_t k = 0u; k < K; ++k) {
+            const auto p = crt_prime(k);
+            // Horner scheme on the limbs of the absolute value, in base 2**GMP_NUMB_BITS.
+            const auto base = static_cast<unsigned long long>((uint128(1u) << GMP_NUMB_BITS) % p);
+            uint128 r = 0u;
+            for (auto i = size; i != 0u; --i) {
+                r = (r * base + ::mpz_getlimbn(v, static_cast<::mp_size_t>(i - 1u))) % p;
+            }
+            retval[k] = static_cast<unsigned long long>(r);
+            if (n.sign() < 0 && retval[k] != 0u) {
+                retval[k] = p - retval[k];
+            }
+        }
+        return retval;
+    }
+    void multiply_accumulate(const residues &a, const residues &b)
+    {
+        for (std::size_t k = 0u; k < K; ++k) {
+            m_acc[k] += static_cast<uint128>(a[k]) * b[k];
+        }
+    }
+    bool is_zero() const
+    {
+        for (std::size_t k = 0u; k < K; ++k) {
+            if (m_acc[k] % crt_prime(k) != 0u) {
+                return false;
+            }
+        }
+        return true;
+    }
+    mp_integer<NBits> get() const
+    {
+        // Garner's algorithm: the value in [0, M[, with M the product of the moduli, is
+        // d[0] + d[1] * p[0] + d[2] * p[0] * p[1] + ..., with d[k] in [0, p[k][.
+        const auto &inv = inverses();
+        residues d;
+        for (std::size_t k = 0u; k < K; ++k) {
+            const auto p = crt_prime(k);
+            auto t = static_cast<unsigned long long>(m_acc[k] % p);
+            for (std::size_t j = 0u; j < k; ++j) {
+                const auto dj = d[j] % p;
+                t = static_cast<unsigned long long>(static_cast<uint128>(t >= dj ? t - dj : t + (p - dj)) * inv[j][k]
+                                                    % p);
+            }
+            d[k] = t;
+        }
+        mp_integer<NBits> retval(d[K - 1u]);
+        for (std::size_t k = K - 1u; k != 0u; --k) {
+            retval *= crt_prime(k - 1u);
+            retval += d[k - 1u];
+        }
+        // Move to the symmetric range ]-M/2, M/2].
+        const auto &m = modulus();
+        if (retval > m.first) {
+            retval -= m.second;
+        }
+        return retval;
+    }
+
+private:
+    // inv[j][k] is the inverse of p[j] modulo p[k], for j < k.
+    static const inv_table &inverses()
+    {
+        static const inv_table table = []() {
+            inv_table retval{};
+            for (std::size_t k = 0u; k < K; ++k) {
+                const auto p = crt_prime(k);
+                for (std::size_t j = 0u; j < k; ++j) {
+                    // Fermat's little theorem: p[j]**-1 = p[j]**(p[k] - 2) mod p[k].
+                    uint128 b = crt_prime(j) % p, r = 1u;
+                    for (auto e = p - 2u; e != 0u; e >>= 1u) {
+                        if (e & 1u) {
+                            r = r * b % p;
+                        }
+                        b = b * b % p;
+                    }
+                    retval[j][k] = static_cast<unsigned long long>(r);
+                }
+            }
+            return retval;
+        }();
+        return table;
+    }
+    // M / 2 and M.
+    static const std::pair<mp_integer<NBits>, mp_integer<NBits>> &modulus()
+    {
+        static const std::pair<mp_integer<NBits>, mp_integer<NBits>> m = []() {
+            mp_integer<NBits> retval(1);
+            for (std::size_t k = 0u; k < K; ++k) {
+                retval *= crt_prime(k);
+            }
+            return std::make_pair(retval / 2, retval);
+        }();
+        return m;
+    }
+    std::array<uint128, K> m_acc;
+};
+
+#endif
 }
 
 namespace math
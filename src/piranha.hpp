@@ -309,6 +309,7 @@ inline namespace literals
 }
 }
 
+#include "autotune.hpp"
 #include "array_key.hpp"
 #include "base_series_multiplier.hpp"
 #include "binomial.hpp"
@@ -320,6 +321,8 @@ inline namespace literals
 #include "divisor_series.hpp"
 #include "dynamic_aligning_allocator.hpp"
 #include "exceptions.hpp"
+#include "flat_hash_set.hpp"
+#include "frozen_term_view.hpp"
 #include "hash_set.hpp"
 #include "init.hpp"
 #include "invert.hpp"
@@ -352,6 +355,8 @@ inline namespace literals
 #include "series_multiplier.hpp"
 #include "settings.hpp"
 #include "small_vector.hpp"
+#include "sorted_term_vector.hpp"
+#include "spilled_series.hpp"
 #include "static_vector.hpp"
 #include "substitutable_series.hpp"
 #include "symbol.hpp"
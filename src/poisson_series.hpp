@@ -30,7 +30,10 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_POISSON_SERIES_HPP
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
 #include <iterator>
 #include <stdexcept>
 #include <string>
@@ -43,6 +46,7 @@ see https://www.gnu.org/licenses/. */
 #include "detail/divisor_series_fwd.hpp"
 #include "detail/poisson_series_fwd.hpp"
 #include "detail/polynomial_fwd.hpp"
+#include "detail/real_fwd.hpp"
 #include "detail/sfinae_types.hpp"
 #include "exceptions.hpp"
 #include "forwarding.hpp"
@@ -64,6 +68,7 @@ see https://www.gnu.org/licenses/. */
 #include "term.hpp"
 #include "thread_pool.hpp"
 #include "trigonometric_series.hpp"
+#include "tuning.hpp"
 #include "type_traits.hpp"
 
 namespace piranha
@@ -837,6 +842,26 @@ namespace detail
 
 template <typename Series>
 using ps_series_multiplier_enabler = typename std::enable_if<std::is_base_of<poisson_series_tag, Series>::value>::type;
+
+// Detect coefficient types for which the division by two is exact (and hence it commutes with
+// multiplication and addition).
+template <typename Cf, typename = void>
+struct ps_cf_exact_halving {
+    static const bool value
+        = std::is_floating_point<Cf>::value || is_mp_rational<Cf>::value || std::is_same<Cf, real>::value;
+};
+
+template <typename Cf>
+struct ps_cf_exact_halving<Cf, typename std::enable_if<is_series<Cf>::value>::type> {
+    static const bool value = ps_cf_exact_halving<typename Cf::term_type::cf_type>::value;
+};
+
+// NOTE: rational coefficients at the top level are excluded, as in that case the base multiplier works
+// on normalised integral numerators and sets the denominators only at the end.
+template <typename Series>
+using ps_exact_halving
+    = std::integral_constant<bool, !is_mp_rational<typename Series::term_type::cf_type>::value
+                                       && ps_cf_exact_halving<typename Series::term_type::cf_type>::value>;
 }
 
 /// Specialisation of piranha::series_multiplier for piranha::poisson_series.
@@ -914,6 +939,160 @@ class series_multiplier<Series, detail::ps_series_multiplier_enabler<Series>> :
             container._update_size(static_cast<bucket_size_type>(s.size() - tot));
         }
     }
+    // Multiplication in which the buckets of the return value are partitioned into zones, one per thread.
+    // The term products of a round of rows of the first series are computed in parallel and buffered
+    // according to their destination zone, then each zone is merged into the return value by a single thread,
+    // without any locking. Each thread buffers roughly block_size**2 products per round.
+    // NOTE: the canonicalisation of the trigonometric keys scrambles the order of the codes of the
+    // products (unlike in the polynomial case), so the zones are determined after the key multiplication.
+    template <typename LimitFunctor>
+    Series zoned_multiplication(const LimitFunctor &lf) const
+    {
+        using size_type = typename base::size_type;
+        using bucket_size_type = typename base::bucket_size_type;
+        using term_type = typename Series::term_type;
+        using key_type = typename term_type::key_type;
+        using buffer_type = std::vector<std::vector<term_type>>;
+        const auto n_threads = this->m_n_threads;
+        piranha_assert(n_threads > 0u);
+        if (n_threads == 1u) {
+            return this->plain_multiplication(lf);
+        }
+        Series retval;
+        retval.set_symbol_set(this->m_ss);
+        if (unlikely(this->m_v1.empty() || this->m_v2.empty())) {
+            return retval;
+        }
+        const size_type size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        auto &container = retval._container();
+        const auto est = this->template estimate_final_series_size<key_type::multiply_arity,
+                                                                   typename base::template plain_multiplier<false>>(lf);
+        const auto n_buckets = boost::numeric_cast<bucket_size_type>(
+            std::ceil(static_cast<double>(est) / container.max_load_factor()));
+        piranha_assert(n_buckets > 0u);
+        container.rehash(n_buckets, tuning::get_parallel_memory_set() ? n_threads : 1u);
+        // Buckets per zone. The last zone also takes the remainder.
+        const auto bpz = static_cast<bucket_size_type>(container.bucket_count() / n_threads);
+        auto zone = [bpz, n_threads](const bucket_size_type &b) -> unsigned {
+            return bpz ? static_cast<unsigned>(std::min<bucket_size_type>(b / bpz, n_threads - 1u)) : n_threads - 1u;
+        };
+        // Rows of the first series processed by each thread in each round.
+        const auto bsize = safe_cast<size_type>(tuning::get_multiplication_block_size<term_type>());
+        const auto rpt = std::max<size_type>(static_cast<size_type>(bsize * bsize / size2), 1u);
+        // buffers[t][z] contains the products computed by thread t with destination zone z.
+        std::vector<buffer_type> buffers(n_threads, buffer_type(n_threads));
+        try {
+            // NOTE: the destructors of the future lists wait on the futures in case of exceptions.
+            for (size_type start = 0u; start < size1;) {
+                // Computation phase.
+                {
+                    future_list<void> f_list;
+                    for (unsigned t = 0u; t < n_threads && start < size1; ++t) {
+                        const auto end = static_cast<size_type>(size1 - start > rpt ? start + rpt : size1);
+                        auto tf = [this, t, start, end, &lf, &buffers, &retval, &container, &zone]() {
+                            std::array<term_type, key_type::multiply_arity> tmp_t;
+                            auto &buffer = buffers[t];
+                            auto f = [this, &tmp_t, &buffer, &retval, &container, &zone](const size_type &i,
+                                                                                        const size_type &j) {
+                                key_type::multiply(tmp_t, *(this->m_v1[i]), *(this->m_v2[j]),
+                                                   retval.get_symbol_set());
+                                for (auto &tmp_term : tmp_t) {
+                                    buffer[zone(container._bucket(tmp_term))].push_back(std::move(tmp_term));
+                                }
+                            };
+                            this->blocked_multiplication(f, start, end, lf);
+                        };
+                        f_list.push_back(thread_pool::enqueue(t, tf));
+                        start = end;
+                    }
+                    f_list.wait_all();
+                    f_list.get_all();
+                }
+                // Merge phase.
+                future_list<void> f_list;
+                for (unsigned z = 0u; z < n_threads; ++z) {
+                    auto mf = [z, &buffers, &container]() {
+                        const auto c_end = container.end();
+                        for (auto &buffer : buffers) {
+                            for (auto &tmp_term : buffer[z]) {
+                                const auto bucket_idx = container._bucket(tmp_term);
+                                const auto it = container._find(tmp_term, bucket_idx);
+                                if (it == c_end) {
+                                    container._unique_insert(std::move(tmp_term), bucket_idx);
+                                } else {
+                                    it->m_cf += tmp_term.m_cf;
+                                }
+                            }
+                            buffer[z].clear();
+                        }
+                    };
+                    f_list.push_back(thread_pool::enqueue(z, mf));
+                }
+                f_list.wait_all();
+                f_list.get_all();
+            }
+            this->sanitise_series(retval, n_threads);
+            this->finalise_series(retval);
+        } catch (...) {
+            // Clean up retval as it might be in an inconsistent state.
+            container.clear();
+            throw;
+        }
+        return retval;
+    }
+    // Copy the terms of the second series with halved coefficients, so that the factor 1/2 of Werner's
+    // formulae is applied during the accumulation of the products.
+    void halve_operand() const
+    {
+        m_halved_terms.clear();
+        m_halved_terms.reserve(this->m_v2.size());
+        for (const auto &ptr : this->m_v2) {
+            m_halved_terms.push_back(*ptr);
+            m_halved_terms.back().m_cf /= 2;
+        }
+        std::transform(m_halved_terms.begin(), m_halved_terms.end(), this->m_v2.begin(),
+                       [](const typename Series::term_type &t) { return &t; });
+    }
+    // Exact division by two: the halving is folded into the second operand (or into the diagonal
+    // when squaring), and no final pass over the result is needed.
+    template <typename T = Series, typename std::enable_if<detail::ps_exact_halving<T>::value, int>::type = 0>
+    Series execute() const
+    {
+        using size_type = typename base::size_type;
+        if (this->m_square) {
+            // NOTE: the off-diagonal products would be doubled and halved, hence they are used as they are.
+            auto diag = this->square_diagonal([](const size_type &) { return true; });
+            this->finalise_series(diag);
+            diag /= 2;
+            auto retval = zoned_multiplication([](const size_type &i) { return i; });
+            retval += diag;
+            return retval;
+        }
+        halve_operand();
+        const size_type size2 = this->m_v2.size();
+        return zoned_multiplication([size2](const size_type &) { return size2; });
+    }
+    // Inexact division by two (e.g., integral coefficients): divide the result at the end.
+    template <typename T = Series, typename std::enable_if<!detail::ps_exact_halving<T>::value, int>::type = 0>
+    Series execute() const
+    {
+        using size_type = typename base::size_type;
+        Series retval;
+        if (this->m_square) {
+            // Squaring: the off-diagonal products are computed only once, with doubled coefficients, and the
+            // diagonal is added at the end.
+            auto diag = this->square_diagonal([](const size_type &) { return true; });
+            this->finalise_series(diag);
+            this->square_double();
+            retval = zoned_multiplication([](const size_type &i) { return i; });
+            retval += diag;
+        } else {
+            const size_type size2 = this->m_v2.size();
+            retval = zoned_multiplication([size2](const size_type &) { return size2; });
+        }
+        divide_by_two(retval);
+        return retval;
+    }
 
 public:
     /// Inherit base constructors.
@@ -924,19 +1103,34 @@ public:
      * This operator is enabled only if the coefficient and key types of \p Series satisfy
      * piranha::key_is_multipliable.
      *
-     * The call operator will use base_series_multiplier::plain_multiplication().
+     * The call operator computes the term-by-term products via the formulae of Werner. In multi-threaded mode,
+     * the buckets of the result are partitioned into zones, one per thread: the term products are computed in
+     * parallel, buffered according to their destination zone and then merged into the result, zone by zone,
+     * without locking. If the division by two is exact for the coefficient type (e.g., floating-point types or
+     * series with rational coefficients), the factor 1/2 is folded into the coefficients of one of the operands.
+     * Otherwise, the result is divided by two at the end. If the two operands are the same object (see
+     * base_series_multiplier::m_square), only half of the off-diagonal term-by-term multiplications will
+     * be performed.
      *
      * @return the result of the multiplication.
      *
-     * @throws unspecified any exception thrown by base_series_multiplier::plain_multiplication().
+     * @throws unspecified any exception thrown by:
+     * - base_series_multiplier::plain_multiplication(),
+     *   base_series_multiplier::estimate_final_series_size(), base_series_multiplier::sanitise_series(),
+     * - the division operator of the coefficient type,
+     * - thread_pool::enqueue(), future_list::push_back(),
+     * - memory errors in standard containers,
+     * - the low-level interface of piranha::hash_set.
      */
     template <typename T = Series, call_enabler<T> = 0>
     Series operator()() const
     {
-        auto retval(this->plain_multiplication());
-        divide_by_two(retval);
-        return retval;
+        return execute();
     }
+
+private:
+    // Storage for the terms with halved coefficients.
+    mutable std::vector<typename Series::term_type> m_halved_terms;
 };
 }
 
@@ -30,6 +30,7 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_POLYNOMIAL_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <boost/numeric/conversion/cast.hpp>
 #include <cmath> // For std::ceil.
 #include <cstddef>
@@ -38,6 +39,7 @@ see https://www.gnu.org/licenses/. */
 #include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <numeric>
 #include <stdexcept>
@@ -51,8 +53,11 @@ see https://www.gnu.org/licenses/. */
 #include "config.hpp"
 #include "debug_access.hpp"
 #include "detail/atomic_flag_array.hpp"
+#include "detail/atomic_lock_guard.hpp"
 #include "detail/cf_mult_impl.hpp"
 #include "detail/divisor_series_fwd.hpp"
+#include "detail/fft.hpp"
+#include "detail/parallel_radix_sort.hpp"
 #include "detail/parallel_vector_transform.hpp"
 #include "detail/poisson_series_fwd.hpp"
 #include "detail/polynomial_fwd.hpp"
@@ -66,14 +71,17 @@ see https://www.gnu.org/licenses/. */
 #include "kronecker_array.hpp"
 #include "kronecker_monomial.hpp"
 #include "math.hpp"
+#include "memory.hpp"
 #include "monomial.hpp"
 #include "mp_integer.hpp"
+#include "mp_rational.hpp"
 #include "pow.hpp"
 #include "power_series.hpp"
 #include "safe_cast.hpp"
 #include "series.hpp"
 #include "series_multiplier.hpp"
 #include "settings.hpp"
+#include "sorted_term_vector.hpp"
 #include "substitutable_series.hpp"
 #include "symbol.hpp"
 #include "symbol_set.hpp"
@@ -228,8 +236,8 @@ inline PType gcd_prs_sr(PType a, PType b)
     // Store the content of a and b for later use.
     auto a_cont = a.content(), b_cont = b.content();
     // NOTE: it seems like removing the content from the inputs
-    // can help performance. Let's revisit this after we implement
-    // the sorted data structure for polys.
+    // can help performance. Let's revisit this now that the division
+    // routine works on the sorted representation (sorted_term_vector).
     // poly_exact_cf_div(a,a_cont);
     // poly_exact_cf_div(b,b_cont);
     std::vector<PType> F;
@@ -961,33 +969,25 @@ class polynomial
     using key_t = typename T::term_type::key_type;
     template <typename T>
     using expo_t = typename T::term_type::key_type::value_type;
-    // Multiply polynomial by a term. Preconditions:
+    // Multiply a polynomial in sorted form by a term. The products are returned
+    // in the same order as the terms of p. Preconditions:
     // - p is not zero,
     // - the coefficient of the term is not zero.
     // Type requirements:
     // - cf type supports multiplication,
     // - key type supports multiply.
-    template <typename PType>
-    static PType term_mult(const typename PType::term_type &t, const PType &p)
+    template <typename C, typename K>
+    static std::vector<term<C, K>> term_mult(const term<C, K> &t, const sorted_term_vector<C, K> &p)
     {
-        using term_type = typename PType::term_type;
-        using key_type = typename term_type::key_type;
         piranha_assert(p.size() != 0u);
         piranha_assert(!math::is_zero(t.m_cf));
-        // Initialise the return value.
-        PType retval;
-        retval.set_symbol_set(p.get_symbol_set());
-        // Prepare an adequate number of buckets (same as input poly).
-        retval._container().rehash(p._container().bucket_count());
-        // Go with the loop.
-        key_type tmp_key;
-        const auto it_f = p._container().end();
-        for (auto it = p._container().begin(); it != it_f; ++it) {
-            key_type::multiply(tmp_key, t.m_key, it->m_key, p.get_symbol_set());
-            piranha_assert(!math::is_zero(t.m_cf * it->m_cf));
-            // NOTE: here we could use the unique_insert machinery
-            // to improve performance.
-            retval.insert(term_type{t.m_cf * it->m_cf, tmp_key});
+        std::vector<term<C, K>> retval;
+        retval.reserve(p.size());
+        K tmp_key;
+        for (const auto &pt : p) {
+            K::multiply(tmp_key, t.m_key, pt.m_key, p.get_symbol_set());
+            piranha_assert(!math::is_zero(t.m_cf * pt.m_cf));
+            retval.emplace_back(t.m_cf * pt.m_cf, tmp_key);
         }
         return retval;
     }
@@ -1021,44 +1021,44 @@ class polynomial
             detail::poly_expo_checker(n);
             detail::poly_expo_checker(d);
         }
-        // Initialisation: quotient is empty, remainder is the numerator.
-        polynomial q, r(n);
+        // Number of threads to be used in the conversions to/from the sorted representation.
+        const unsigned n_threads
+            = thread_pool::use_threads(integer(n.size()), integer(settings::get_min_work_per_thread()));
+        // Initialisation: quotient is empty, remainder is the numerator. Numerator and denominator
+        // are stored in sorted form, so that the leading terms are located in constant time and
+        // the subtraction of the multiples of the denominator does not need to touch the terms of the
+        // remainder lower than the trailing term of the multiple.
+        using stv_type = sorted_term_vector<cf_type, key_type>;
+        polynomial q;
         q.set_symbol_set(args);
+        stv_type r(n, n_threads);
+        const stv_type sd(d, n_threads);
         // Leading term of the denominator, always the same.
-        const auto lden = detail::poly_lterm(d);
-        piranha_assert(!math::is_zero(lden->m_cf));
+        const auto &lden = sd.leading_term();
+        piranha_assert(!math::is_zero(lden.m_cf));
         // Temp cf and key used for computations in the loop.
         cf_type tmp_cf;
         key_type tmp_key;
         while (true) {
-            if (r.size() == 0u) {
+            if (r.empty()) {
                 break;
             }
             // Leading term of the remainder.
-            const auto lr = poly_lterm(r);
-            if (lr->m_key < lden->m_key) {
+            const auto &lr = r.leading_term();
+            if (lr.m_key < lden.m_key) {
                 break;
             }
             // NOTE: we want to check that the division is exact here,
             // and throw if this is not the case.
             // NOTE: this should be made configurable to optimise the case in which we
             // know the division will be exact (e.g., in GCD).
-            math::divexact(tmp_cf, lr->m_cf, lden->m_cf);
-            key_type::divide(tmp_key, lr->m_key, lden->m_key, args);
+            math::divexact(tmp_cf, lr.m_cf, lden.m_cf);
+            key_type::divide(tmp_key, lr.m_key, lden.m_key, args);
             term_type t{tmp_cf, tmp_key};
-            // NOTE: here we are basically progressively removing terms from r until
-            // it gets to zero. This sounds exactly like the kind of situation in which
-            // the iteration over the hash table could become really slow. This might
-            // matter when we need to re-determine the leading term of r above.
-            // We should consider adding a re-hashing every time we do a +/- operation on
-            // a series and the load factor gets below a certain threshold. We should also
-            // review uses of the insert() method of series to spot other possible
-            // places where this could be a problem (although once we have a good behaviour
-            // for +/- we should be mostly good - multiplication should already be ok).
-            r -= term_mult(t, d);
+            r.sub(stv_type(args, term_mult(t, sd)));
             q.insert(std::move(t));
         }
-        return std::make_pair(std::move(q), std::move(r));
+        return std::make_pair(std::move(q), r.template to_series<polynomial>(n_threads));
     }
     // Multivariate exact division.
     template <typename T>
@@ -2638,6 +2638,20 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
         typename std::enable_if<key_is_multipliable<cf_t<T>, key_t<T>>::value && has_multiply_accumulate<cf_t<T>>::value
                                     && detail::true_tt<detail::cf_mult_enabler<cf_t<T>>>::value,
                                 int>::type;
+    // Enabler for the sorted multiplication.
+    template <typename T>
+    using sm_enabler = typename std::enable_if<
+        detail::true_tt<call_enabler<T>>::value
+            && detail::true_tt<decltype(key_t<T>::multiply(std::declval<key_t<T> &>(), std::declval<const key_t<T> &>(),
+                                                           std::declval<const key_t<T> &>(),
+                                                           std::declval<const symbol_set &>()))>::value,
+        int>::type;
+    // Enabler for the zoned multiplication.
+    template <typename T>
+    using zm_enabler =
+        typename std::enable_if<detail::true_tt<call_enabler<T>>::value
+                                    && detail::is_kronecker_monomial<typename T::term_type::key_type>::value,
+                                int>::type;
     // Utility helpers for the subtraction of degree types in the truncation routines. The specialisation
     // for integral types will check the operation for overflow.
     template <typename T, typename std::enable_if<!std::is_integral<T>::value, int>::type = 0>
@@ -2665,10 +2679,52 @@ class series_multiplier<Series, detail::poly_multiplier_enabler<Series>> : publi
               = 0>
     Series um_impl() const
     {
+        if (this->m_square) {
+            const auto size2 = this->m_v2.size();
+            return plain_square([size2](const typename base::size_type &) { return size2; });
+        }
         return this->plain_multiplication();
     }
+    // Squaring via the plain multiplication, given the limit functor lf of the full multiplication.
+    // NOTE: the off-diagonal products are computed only once, with doubled coefficients, and the
+    // diagonal is added at the end.
+    template <typename LimitFunctor>
+    Series plain_square(const LimitFunctor &lf) const
+    {
+        using size_type = typename base::size_type;
+        auto diag = this->square_diagonal([&lf](const size_type &i) { return i < lf(i); });
+        this->finalise_series(diag);
+        this->square_double();
+        auto retval = this->plain_multiplication([&lf](const size_type &i) { return std::min(lf(i), i); });
+        retval += diag;
+        return retval;
+    }
+    // Dispatch of truncated multiplication, after the computation of the degrees and of the skip limits.
+    template <typename D, typename LimitFunctor, typename T = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    Series tm_impl(const std::vector<D> &v_d1, const std::vector<D> &v_d2, const D &max_degree,
+                   const LimitFunctor &lf) const
+    {
+        return truncated_kronecker_mult(v_d1, v_d2, max_degree, lf);
+    }
+    template <typename D, typename LimitFunctor, typename T = Series,
+              typename std::enable_if<!detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    Series tm_impl(const std::vector<D> &, const std::vector<D> &, const D &, const LimitFunctor &lf) const
+    {
+        if (this->m_square) {
+            return plain_square(lf);
+        }
+        return this->plain_multiplication(lf);
+    }
 
 public:
+    /// Zone statistics type.
+    /**
+     * See _get_zone_stats().
+     */
+    using zone_stats_type = std::vector<std::pair<std::size_t, std::size_t>>;
     /// Constructor.
     /**
      * The constructor will call the base constructor and run these additional checks:
@@ -2707,7 +2763,9 @@ public:
      *
      * This method will perform the multiplication of the series operands passed to the constructor. Depending on
      * the key type of \p Series, the implementation will use either base_series_multiplier::plain_multiplication()
-     * with base_series_multiplier::plain_multiplier or a different algorithm.
+     * with base_series_multiplier::plain_multiplier or a different algorithm. If the two operands are the same
+     * object (see base_series_multiplier::m_square), only half of the off-diagonal term-by-term multiplications
+     * will be performed.
      *
      * If a polynomial truncation threshold is defined and the degree type of the polynomial is a C++ integral type,
      * the integral arithmetic operations involved in the truncation logic will be checked for overflow.
@@ -2736,6 +2794,31 @@ public:
     {
         return execute();
     }
+    /// Multiply-accumulate.
+    /**
+     * \note
+     * This template method is enabled only if operator()() is enabled.
+     *
+     * This method will add to \p acc the result of the multiplication of the series operands passed to the
+     * constructor. If the key of \p Series is a piranha::kronecker_monomial, the coefficient type of \p Series is not
+     * a piranha::mp_rational, no truncation is active, \p acc has the same symbol set as the operands and it is not
+     * one of the operands, and the multiplication would not use the dense accumulator, then the products of the terms
+     * will be accumulated directly into \p acc, whose table will be enlarged in advance according to the estimated
+     * size of the multiplication. Otherwise, this method is equivalent to:
+     * @code
+     * acc += (*this)();
+     * @endcode
+     *
+     * @param acc the accumulator.
+     *
+     * @throws unspecified any exception thrown by operator()() or by the in-place addition operator of \p Series.
+     * If the products are accumulated directly into \p acc, \p acc will be left empty in case of errors.
+     */
+    template <typename T = Series, call_enabler<T> = 0>
+    void multiply_accumulate(Series &acc) const
+    {
+        macc_impl(acc);
+    }
     /** @name Low-level interface
      * Low-level methods, on top of which the call operator is implemented.
      */
@@ -2789,6 +2872,10 @@ public:
      * - a piranha::symbol_set::positions referring to the positions of the variables of the first argument
      *   in the merged symbol set of the two operands.
      *
+     * If the key type is piranha::kronecker_monomial, the multiplication will be performed with the same
+     * parallel algorithm used in the untruncated case, skipping the term-by-term multiplications producing terms
+     * whose degree exceeds \p max_degree.
+     *
      * @param max_degree the maximum degree of the result of the multiplication.
      * @param args either an empty argument, or a pair of arguments as described above.
      *
@@ -2806,7 +2893,7 @@ public:
     {
         // NOTE: a possible optimisation here is the following: if the sum degrees of the arguments is less than
         // or equal to the max truncation degree, just do the normal multiplication - which can also then take
-        // advantage of faster Kronecker multiplication, if the series are suitable.
+        // advantage of the dense Kronecker multiplication, if the series are suitable.
         using term_type = typename Series::term_type;
         // NOTE: degree type is the same in total and partial.
         using degree_type = decltype(ps_get_degree(term_type{}, this->m_ss));
@@ -2841,12 +2928,17 @@ public:
                        [&v_d2](const size_type &i) { return v_d2[static_cast<d_size_type>(i)]; });
         this->m_v2 = std::move(v2_copy);
         v_d2 = std::move(v_d2_copy);
+        if (this->m_square) {
+            // In case of squaring, the two series must be kept in the same order.
+            this->m_v1 = this->m_v2;
+            v_d1 = v_d2;
+        }
         // Now get the skip limits and we build the limits functor.
         const auto sl = _get_skip_limits(v_d1, v_d2, max_degree);
         auto lf = [&sl](const size_type &idx1) {
             return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
         };
-        return this->plain_multiplication(lf);
+        return tm_impl(v_d1, v_d2, max_degree, lf);
     }
     /// Establish skip limits for truncated multiplication.
     /**
@@ -2929,6 +3021,283 @@ public:
         piranha_assert(retval_checker());
         return retval;
     }
+    /// Sorted multiplication.
+    /**
+     * \note
+     * This method can be used only if operator()() can be called and if the key type of \p Series supports
+     * a static <tt>multiply()</tt> method operating on keys, as piranha::monomial and
+     * piranha::kronecker_monomial do.
+     *
+     * This method will return the (untruncated) result of multiplying the two polynomials used as input arguments in
+     * the class' constructor as a vector of terms sorted in descending order, as established by the
+     * <tt>operator<()</tt> of the key type. Terms with zero coefficient are not included in the output.
+     *
+     * The implementation uses a binary heap over the sorted operands (Johnson's algorithm as refined by Monagan and
+     * Pearce), which emits the terms of the result directly in monomial order. Apart from the output, the working
+     * memory is proportional to the number of terms in the smaller operand. This method always runs in
+     * single-threaded mode.
+     *
+     * @return the result of the multiplication of the two operands used in the construction of \p this, as a vector
+     * of terms sorted in descending order.
+     *
+     * @throws unspecified any exception thrown by:
+     * - piranha::base_series_multiplier::finalise_terms(),
+     * - memory errors in standard containers,
+     * - the multiplication and comparison operators of the key type,
+     * - piranha::math::mul3(),
+     * - piranha::math::multiply_accumulate(),
+     * - piranha::math::is_zero().
+     */
+    template <typename T = Series, sm_enabler<T> = 0>
+    std::vector<typename Series::term_type> _sorted_multiplication() const
+    {
+        using term_type = typename Series::term_type;
+        using key_type = typename term_type::key_type;
+        using size_type = typename base::size_type;
+        // Heap entry: the key of the product, the index in the second series and the index in the first series.
+        using h_entry = std::tuple<key_type, size_type, size_type>;
+        auto &v1 = this->m_v1;
+        auto &v2 = this->m_v2;
+        const auto size1 = v1.size(), size2 = v2.size();
+        std::vector<term_type> retval;
+        if (unlikely(!size1 || !size2)) {
+            return retval;
+        }
+        // Sort the operands in descending order.
+        auto term_cmp = [](term_type const *p1, term_type const *p2) { return p2->m_key < p1->m_key; };
+        std::stable_sort(v1.begin(), v1.end(), term_cmp);
+        std::stable_sort(v2.begin(), v2.end(), term_cmp);
+        // NOTE: the operator<() of the key is compatible with multiplication (i.e., a < b implies a * c < b * c),
+        // both for the lexicographic ordering of monomial and for the ordering of the codes of kronecker_monomial.
+        // Hence the product of the terms (j, i) is never greater than the products (j, i - 1) and (j - 1, 0). In the
+        // main loop, the extraction of (j, i) from the heap is followed by the insertion of (j, i + 1) and, if
+        // i == 0, of (j + 1, 0): the heap thus contains at most one entry per term of the second series, and the
+        // products are extracted in descending order.
+        auto h_cmp = [](const h_entry &e1, const h_entry &e2) { return std::get<0u>(e1) < std::get<0u>(e2); };
+        std::vector<h_entry> heap;
+        heap.reserve(size2);
+        auto h_push = [&heap, &v1, &v2, &h_cmp, this](const size_type &j, const size_type &i) {
+            key_type k;
+            key_type::multiply(k, v2[j]->m_key, v1[i]->m_key, this->m_ss);
+            heap.emplace_back(std::move(k), j, i);
+            std::push_heap(heap.begin(), heap.end(), h_cmp);
+        };
+        h_push(0u, 0u);
+        // The term being currently accumulated.
+        term_type cur;
+        bool cur_valid = false;
+        auto flush = [&cur, &cur_valid, &retval]() {
+            if (cur_valid && !math::is_zero(cur.m_cf)) {
+                retval.push_back(std::move(cur));
+                cur = term_type{};
+            }
+            cur_valid = false;
+        };
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), h_cmp);
+            auto &top = heap.back();
+            const size_type j = std::get<1u>(top), i = std::get<2u>(top);
+            if (cur_valid && std::get<0u>(top) == cur.m_key) {
+                fma_wrap(cur.m_cf, v2[j]->m_cf, v1[i]->m_cf);
+            } else {
+                flush();
+                cur.m_key = std::move(std::get<0u>(top));
+                detail::cf_mult_impl(cur.m_cf, v2[j]->m_cf, v1[i]->m_cf);
+                cur_valid = true;
+            }
+            heap.pop_back();
+            if (i + 1u < size1) {
+                h_push(j, static_cast<size_type>(i + 1u));
+            }
+            if (i == 0u && j + 1u < size2) {
+                h_push(static_cast<size_type>(j + 1u), 0u);
+            }
+        }
+        flush();
+        this->finalise_terms(retval);
+        return retval;
+    }
+    /// Zoned multiplication.
+    /**
+     * \note
+     * This method can be used only if operator()() can be called and if the key type of \p Series is
+     * piranha::kronecker_monomial.
+     *
+     * This method will compute the result of multiplying the two polynomials used as input arguments
+     * in the class' constructor without ever storing it as a whole. The hash table that would hold the result,
+     * sized according to the estimated number of terms in the result, is subdivided into zones of contiguous
+     * buckets, each one containing an estimated number of terms not greater than \p max_size. The zones are
+     * computed independently from each other by the available threads: each completed zone is passed, as an
+     * rvalue reference to \p Series together with its index, to \p f, and then discarded. The zones contain
+     * disjoint sets of terms, and their sum is the result of the multiplication. Empty zones are not passed to \p f.
+     *
+     * Apart from the operands, the memory used by the multiplication is thus roughly bounded by the size of one zone
+     * per thread. Note that \p f might be invoked concurrently from multiple threads, and that the zones passed to
+     * \p f before an exception is thrown will not be recomputed.
+     *
+     * If an automatic truncation is active (see polynomial::set_auto_truncate_degree()), it will be applied to each
+     * zone before passing it to \p f. Note that the zones are still computed in full and truncated afterwards,
+     * and that their sizes are estimated from the untruncated product.
+     *
+     * @param max_size the maximum estimated number of terms in each zone.
+     * @param f the functor that will be invoked on each zone.
+     *
+     * @throws std::invalid_argument if \p max_size is zero.
+     * @throws unspecified any exception thrown by:
+     * - piranha::base_series_multiplier::estimate_final_series_size(),
+     * - piranha::base_series_multiplier::sanitise_series(),
+     * - piranha::base_series_multiplier::finalise_series(),
+     * - the public interface of piranha::hash_set,
+     * - memory errors in standard containers,
+     * - piranha::math::mul3(),
+     * - piranha::math::multiply_accumulate(),
+     * - polynomial::get_auto_truncate_degree() and the truncation methods of piranha::power_series,
+     * - thread_pool::enqueue(),
+     * - future_list::push_back(),
+     * - the call operator of \p f.
+     */
+    template <typename F, typename T = Series, zm_enabler<T> = 0>
+    void _zoned_multiplication(const typename base::bucket_size_type &max_size, const F &f) const
+    {
+        using bucket_size_type = typename base::bucket_size_type;
+        using size_type = typename base::size_type;
+        using term_type = typename Series::term_type;
+        if (unlikely(!max_size)) {
+            piranha_throw(std::invalid_argument, "the maximum size of a zone must be strictly positive");
+        }
+        auto &v1 = this->m_v1;
+        auto &v2 = this->m_v2;
+        const auto size1 = v1.size(), size2 = v2.size();
+        if (unlikely(!size1 || !size2)) {
+            return;
+        }
+        // NOTE: read the auto-truncation settings only once, so that all the zones are truncated consistently.
+        const auto trunc = zm_truncator();
+        // Smallest power of two not less than x. The result is capped so that the sum of two bucket indices
+        // in the table of the result never overflows.
+        auto pow2 = [](const double &x) {
+            unsigned l = 0u;
+            while (l < unsigned(std::numeric_limits<bucket_size_type>::digits) - 2u
+                   && static_cast<double>(bucket_size_type(1u) << l) < x) {
+                ++l;
+            }
+            return static_cast<bucket_size_type>(bucket_size_type(1u) << l);
+        };
+        const double mlf = Series{}._container().max_load_factor();
+        // Number of buckets in the table of the result.
+        const bucket_size_type n_buckets = pow2(std::ceil(
+            static_cast<double>(
+                this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>())
+            / mlf));
+        // Number of buckets per zone: the largest power of two whose number of terms does not exceed max_size.
+        bucket_size_type bpz = pow2(static_cast<double>(max_size) / mlf);
+        if (bpz > 1u && static_cast<double>(bpz) * mlf > static_cast<double>(max_size)) {
+            bpz = static_cast<bucket_size_type>(bpz / 2u);
+        }
+        bpz = std::min(bpz, n_buckets);
+        const bucket_size_type n_zones = static_cast<bucket_size_type>(n_buckets / bpz);
+        // Sort the operands according to the bucket positions in the table of the result.
+        auto r_bucket
+            = [n_buckets](term_type const *p) { return static_cast<bucket_size_type>(p->hash() % n_buckets); };
+        detail::parallel_radix_sort(this->m_n_threads, v1, r_bucket);
+        detail::parallel_radix_sort(this->m_n_threads, v2, r_bucket);
+        std::vector<bucket_size_type> b1(safe_cast<typename std::vector<bucket_size_type>::size_type>(size1)),
+            b2(safe_cast<typename std::vector<bucket_size_type>::size_type>(size2));
+        std::transform(v1.begin(), v1.end(), b1.begin(), r_bucket);
+        std::transform(v2.begin(), v2.end(), b2.begin(), r_bucket);
+        // First index in the second series whose bucket is not less than x.
+        auto l_bound = [&b2](const bucket_size_type &x) {
+            return static_cast<size_type>(std::lower_bound(b2.begin(), b2.end(), x) - b2.begin());
+        };
+        std::atomic<bucket_size_type> next_zone(bucket_size_type(0u));
+        auto thread_functor = [&v1, &v2, &b1, &l_bound, &next_zone, &f, &trunc, n_buckets, bpz, n_zones, size1,
+                               this]() {
+            // NOTE: these will have to be adapted for kd_monomial.
+            using int_type = decltype(v1[0u]->m_key.get_int());
+            term_type tmp_term;
+            while (true) {
+                const bucket_size_type z = next_zone.fetch_add(1u);
+                if (z >= n_zones) {
+                    break;
+                }
+                // [a,b[ is the range of buckets of the zone in the table of the result. In the table of the zone,
+                // which has bpz buckets, the terms are thus placed in the same order.
+                const auto a = static_cast<bucket_size_type>(z * bpz), b = static_cast<bucket_size_type>(a + bpz);
+                Series zone;
+                zone.set_symbol_set(this->m_ss);
+                auto &container = zone._container();
+                container.rehash(bpz);
+                const auto it_end = container.end();
+                auto range_consume = [&v1, &v2, &container, &it_end, &tmp_term, this](
+                    const size_type &i, size_type start2, const size_type &end2) {
+                    const auto &cf1 = v1[i]->m_cf;
+                    const int_type key1 = v1[i]->m_key.get_int();
+                    for (; start2 < end2; ++start2) {
+                        const auto &cur = *v2[start2];
+                        tmp_term.m_key.set_int(static_cast<int_type>(key1 + cur.m_key.get_int()));
+                        auto bucket_idx = container._bucket(tmp_term);
+                        const auto it = container._find(tmp_term, bucket_idx);
+                        if (it == it_end) {
+                            detail::cf_mult_impl(tmp_term.m_cf, cf1, cur.m_cf);
+                            container._unique_insert(tmp_term, bucket_idx);
+                        } else {
+                            this->fma_wrap(it->m_cf, cf1, cur.m_cf);
+                        }
+                    }
+                };
+                for (size_type i = 0u; i < size1; ++i) {
+                    const bucket_size_type bi = b1[i];
+                    // The products landing in [a,b[, without and with wrap-around.
+                    // NOTE: the sums cannot overflow because of the cap on the number of buckets.
+                    range_consume(i, l_bound(a > bi ? static_cast<bucket_size_type>(a - bi) : bucket_size_type(0u)),
+                                  l_bound(b > bi ? static_cast<bucket_size_type>(b - bi) : bucket_size_type(0u)));
+                    range_consume(i, l_bound(static_cast<bucket_size_type>(a + n_buckets - bi)),
+                                  l_bound(static_cast<bucket_size_type>(b + n_buckets - bi)));
+                }
+                this->sanitise_series(zone, 1u);
+                this->finalise_series(zone, 1u);
+                if (trunc) {
+                    trunc(zone);
+                }
+                if (!zone.empty()) {
+                    f(z, std::move(zone));
+                }
+            }
+        };
+        if (this->m_n_threads == 1u) {
+            thread_functor();
+            return;
+        }
+        future_list<decltype(thread_functor())> ft_list;
+        try {
+            for (unsigned i = 0u; i < this->m_n_threads; ++i) {
+                ft_list.push_back(thread_pool::enqueue(i, thread_functor));
+            }
+            // First let's wait for everything to finish.
+            ft_list.wait_all();
+            // Then, let's handle the exceptions.
+            ft_list.get_all();
+        } catch (...) {
+            ft_list.wait_all();
+            throw;
+        }
+    }
+    /// Zone statistics.
+    /**
+     * In multithreaded mode, the multiplication of polynomials with Kronecker monomials subdivides the output
+     * series in zones, which are distributed among the threads: each thread first consumes the zones assigned to it,
+     * and then steals the zones left unprocessed by the other threads. This method returns, for each thread, the
+     * number of zones consumed from its own range (first element of the pair) and the number of zones stolen
+     * from the other threads (second element of the pair) during the last multiplication performed by \p this.
+     *
+     * The returned vector is empty if the last multiplication did not use the zoned multithreaded algorithm.
+     *
+     * @return a const reference to the zone statistics.
+     */
+    const zone_stats_type &_get_zone_stats() const
+    {
+        return m_zone_stats;
+    }
     //@}
 private:
     // NOTE: wrapper to multadd that treats specially rational coefficients. We need to decide in the future
@@ -2943,6 +3312,17 @@ private:
     {
         math::multiply_accumulate(a._num(), b.num(), c.num());
     }
+    // Same as above, for the addition of an accumulated value.
+    template <typename T, typename std::enable_if<!detail::is_mp_rational<T>::value, int>::type = 0>
+    static void add_wrap(T &a, const T &b)
+    {
+        a += b;
+    }
+    template <typename T, typename std::enable_if<detail::is_mp_rational<T>::value, int>::type = 0>
+    static void add_wrap(T &a, const T &b)
+    {
+        a._num() += b.num();
+    }
     // Wrapper for the plain multiplication routine.
     // Case 1: no auto truncation available, just run the plain multiplication.
     template <typename T = Series,
@@ -2971,6 +3351,30 @@ private:
         const symbol_set::positions pos(this->m_ss, symbol_set(std::get<2u>(t).begin(), std::get<2u>(t).end()));
         return _truncated_multiplication(std::get<1u>(t), std::get<2u>(t), pos);
     }
+    // Functor applying the active auto-truncation, if any, to the zones of the zoned multiplication. It is empty
+    // if no truncation is active.
+    template <typename T = Series,
+              typename std::enable_if<!detail::has_get_auto_truncate_degree<T>::value, int>::type = 0>
+    std::function<void(Series &)> zm_truncator() const
+    {
+        return std::function<void(Series &)>{};
+    }
+    template <typename T = Series,
+              typename std::enable_if<detail::has_get_auto_truncate_degree<T>::value, int>::type = 0>
+    std::function<void(Series &)> zm_truncator() const
+    {
+        const auto t = T::get_auto_truncate_degree();
+        if (std::get<0u>(t) == 0) {
+            return std::function<void(Series &)>{};
+        }
+        const auto max_degree = std::get<1u>(t);
+        if (std::get<0u>(t) == 1) {
+            return [max_degree](Series &zone) { zone = zone.truncate_degree(max_degree); };
+        }
+        piranha_assert(std::get<0u>(t) == 2);
+        const auto names = std::get<2u>(t);
+        return [max_degree, names](Series &zone) { zone = zone.truncate_degree(max_degree, names); };
+    }
     // NOTE: the existence of these functors is because GCC 4.8 has troubles capturing variadic arguments in lambdas
     // in _truncated_multiplication, and we need to use std::bind instead. Once we switch to 4.9, we can revert
     // to lambdas and drop the <functional> header.
@@ -2991,6 +3395,48 @@ private:
             return ps_get_degree(*p, args..., ss);
         }
     };
+    // Implementation of multiply_accumulate().
+    // Case 1: no Kronecker key or rational coefficients (the finalisation of the product would affect the terms
+    // already in acc), just do the multiplication and add the result.
+    template <typename T = Series,
+              typename std::enable_if<!detail::is_kronecker_monomial<typename T::term_type::key_type>::value
+                                          || detail::is_mp_rational<typename T::term_type::cf_type>::value,
+                                      int>::type
+              = 0>
+    void macc_impl(Series &acc) const
+    {
+        acc += execute();
+    }
+    // Case 2: accumulate directly into acc via the sparse Kronecker multiplication, if possible.
+    template <typename T = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value
+                                          && !detail::is_mp_rational<typename T::term_type::cf_type>::value,
+                                      int>::type
+              = 0>
+    void macc_impl(Series &acc) const
+    {
+        if (this->m_v1.empty() || this->m_v2.empty() || acc.get_symbol_set() != this->m_ss || check_truncation()
+            || macc_aliases(acc)) {
+            acc += execute();
+            return;
+        }
+        const auto cr = kronecker_code_range();
+        if (dense_kronecker_check(cr.second)) {
+            acc += dense_kronecker_multiplication(cr.first, static_cast<std::size_t>(cr.second));
+            return;
+        }
+        untruncated_sparse_kronecker_mult(acc, cr.second);
+    }
+    // Check if acc is one of the operands. For non-rational coefficients, the term pointers refer
+    // directly to the terms of the operands, and the operands are not empty.
+    bool macc_aliases(const Series &acc) const
+    {
+        auto check = [&acc](const typename Series::term_type *p) {
+            const auto it = acc._container().find(*p);
+            return it != acc._container().end() && &*it == p;
+        };
+        return check(this->m_v1[0u]) || check(this->m_v2[0u]);
+    }
     // execute() is the top level dispatch for the actual multiplication.
     // Case 1: not a Kronecker monomial, do the plain mult.
     template <typename T = Series,
@@ -3014,8 +3460,8 @@ private:
     {
         return false;
     }
-    // Case 2: Kronecker mult, do the special multiplication unless a truncation is active. In that case, run the
-    // plain mult.
+    // Case 2: Kronecker mult, do the special multiplication. If a truncation is active, go through the wrapper,
+    // which will dispatch to the truncated Kronecker multiplication.
     template <typename T = Series,
               typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
               = 0>
@@ -3033,20 +3479,6 @@ private:
     {
         // Cache the sizes.
         const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
-        // Determine whether we want to estimate or not. We check the threshold, and
-        // we force the estimation in multithreaded mode.
-        bool estimate = true;
-        const auto e_thr = tuning::get_estimate_threshold();
-        if (integer(size1) * size2 < integer(e_thr) * e_thr && this->m_n_threads == 1u) {
-            estimate = false;
-        }
-        // If estimation is not worth it, we go with the plain multiplication.
-        // NOTE: this is probably not optimal, but we have to do like this as the sparse
-        // Kronecker multiplication below requires estimation. Maybe in the future we can
-        // have a version without estimation.
-        if (!estimate) {
-            return this->plain_multiplication();
-        }
         // Setup the return value.
         Series retval;
         retval.set_symbol_set(this->m_ss);
@@ -3054,84 +3486,1144 @@ private:
         if (unlikely(!size1 || !size2)) {
             return retval;
         }
+        // Check first if the range of codes in the result is small enough to use the dense accumulator.
+        const auto cr = kronecker_code_range();
+        if (dense_kronecker_check(cr.second)) {
+            return dense_kronecker_multiplication(cr.first, static_cast<std::size_t>(cr.second));
+        }
+        untruncated_sparse_kronecker_mult(retval, cr.second);
+        return retval;
+    }
+    // Untruncated sparse Kronecker multiplication, accumulating into retval. n_codes is the number of codes in the
+    // range of the result.
+    void untruncated_sparse_kronecker_mult(Series &retval, const integer &n_codes) const
+    {
+        const auto size2 = this->m_v2.size();
+        kronecker_no_skip ns;
+        if (this->m_square) {
+            kronecker_square(retval, ns, [size2](const typename base::size_type &) { return size2; }, n_codes);
+            return;
+        }
+        sized_sparse_kronecker_mult(
+            retval, ns,
+            [this]() {
+                // Use the plain functor in normal mode for the estimation.
+                return this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>();
+            },
+            n_codes);
+    }
+    // Truncated Kronecker multiplication. v_d1 and v_d2 are the degrees of the terms in m_v1 and m_v2, m_v2 is
+    // sorted by degree and lf is the limit functor built from the skip limits.
+    template <typename T, typename LimitFunctor>
+    Series truncated_kronecker_mult(const std::vector<T> &v_d1, const std::vector<T> &v_d2, const T &max_degree,
+                                    const LimitFunctor &lf) const
+    {
+        const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        piranha_assert(v_d1.size() == size1 && v_d2.size() == size2);
+        if (unlikely(!size1 || !size2)) {
+            Series retval;
+            retval.set_symbol_set(this->m_ss);
+            return retval;
+        }
+        // Build the skip data: for each term in the first series, the max degree allowed in the second.
+        kronecker_degree_skip<T> ds;
+        ds.m_l1.reserve(v_d1.size());
+        for (const auto &d1 : v_d1) {
+            ds.m_l1.push_back(degree_sub(max_degree, d1));
+        }
+        ds.m_d2 = v_d2;
+        // NOTE: v_d2 is sorted and not empty.
+        ds.m_min_d2 = v_d2[0u];
+        Series retval;
+        retval.set_symbol_set(this->m_ss);
+        if (this->m_square) {
+            kronecker_square(retval, ds, lf, kronecker_code_range().second);
+            return retval;
+        }
+        sized_sparse_kronecker_mult(
+            retval, ds,
+            [this, &lf]() {
+                return this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>(
+                    lf);
+            },
+            kronecker_code_range().second);
+        return retval;
+    }
+    // Squaring via the sparse Kronecker multiplication, accumulating into retval, given the skip policy and the limit
+    // functor of the full multiplication, and the number of codes in the result.
+    template <typename Skip, typename LimitFunctor>
+    void kronecker_square(Series &retval, Skip &skip, const LimitFunctor &lf, const integer &n_codes) const
+    {
+        using size_type = typename base::size_type;
+        auto diag = this->square_diagonal([&lf](const size_type &i) { return i < lf(i); });
+        this->finalise_series(diag);
+        this->square_double();
+        auto sq_lf = [&lf](const size_type &i) { return std::min(lf(i), i); };
+        kronecker_square_skip<Skip> ss(skip);
+        sized_sparse_kronecker_mult(
+            retval, ss,
+            [this, &sq_lf]() {
+                return this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>(
+                    sq_lf);
+            },
+            n_codes);
+        retval += diag;
+    }
+    // Size the output series and run the sparse Kronecker multiplication, accumulating into retval. est_f is used to
+    // estimate the size of the result, n_codes is the number of codes in the range of the result.
+    // NOTE: retval might already contain terms (with the symbol set of the operands), in which case its table is
+    // grown to accommodate both the existing terms and the estimated size of the product.
+    template <typename Skip, typename EstFunctor>
+    void sized_sparse_kronecker_mult(Series &retval, Skip &skip, const EstFunctor &est_f, const integer &n_codes) const
+    {
+        const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        piranha_assert(size1 && size2);
+        piranha_assert(retval.get_symbol_set() == this->m_ss);
+        // Determine whether we want to estimate or not. We check the threshold, and
+        // we force the estimation in multithreaded mode.
+        bool estimate = true;
+        const auto e_thr = tuning::get_estimate_threshold();
+        if (integer(size1) * size2 < integer(e_thr) * e_thr && this->m_n_threads == 1u) {
+            estimate = false;
+        }
         // Rehash the retun value's container accordingly. Check the tuning flag to see if we want to use
         // multiple threads for initing the return value.
         // NOTE: it is important here that we use the same n_threads for multiplication and memset as
         // we tie together pinned threads with potentially different NUMA regions.
         const unsigned n_threads_rehash = tuning::get_parallel_memory_set() ? this->m_n_threads : 1u;
-        // Use the plain functor in normal mode for the estimation.
-        const auto est
-            = this->template estimate_final_series_size<1u, typename base::template plain_multiplier<false>>();
-        // NOTE: if something goes wrong here, no big deal as retval is still empty.
-        retval._container().rehash(boost::numeric_cast<typename Series::size_type>(
-                                       std::ceil(static_cast<double>(est) / retval._container().max_load_factor())),
-                                   n_threads_rehash);
+        typename Series::size_type est;
+        if (estimate) {
+            est = est_f();
+        } else {
+            // If estimation is not worth it, we start from a cheap initial size and let the output
+            // grow during the multiplication. The initial size is the sum of the sizes of the operands, or the
+            // number of term-by-term multiplications or the range of the codes in the result, if smaller
+            // (these two are upper bounds for the size of the result).
+            est = static_cast<typename Series::size_type>(
+                std::min(std::min(integer(size1) * size2, n_codes), integer(size1) + size2));
+        }
+        // NOTE: if something goes wrong here, no big deal as retval is either still empty or cleared by the rehash.
+        const auto n_buckets = boost::numeric_cast<typename Series::size_type>(
+            std::ceil(static_cast<double>(integer(est) + retval.size()) / retval._container().max_load_factor()));
+        if (n_buckets > retval._container().bucket_count()) {
+            retval._container().rehash(n_buckets, n_threads_rehash);
+        }
         piranha_assert(retval._container().bucket_count());
-        sparse_kronecker_multiplication(retval);
-        return retval;
+        sparse_kronecker_multiplication(retval, skip, !estimate);
     }
-    void sparse_kronecker_multiplication(Series &retval) const
+    // Range of the Kronecker codes in the result of the multiplication. The first element of the returned
+    // pair is the smallest code, the second element is the number of codes in the range.
+    // NOTE: the Kronecker codification is linear, hence the codes of the result span the interval
+    // [min1 + min2, max1 + max2]. The extremes are codes of actual products, which have been checked
+    // in the constructor, so there is no danger of overflow here.
+    template <typename T = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    std::pair<typename key_t<T>::value_type, integer> kronecker_code_range() const
     {
-        using bucket_size_type = typename base::bucket_size_type;
-        using size_type = typename base::size_type;
+        using int_type = typename key_t<T>::value_type;
         using term_type = typename Series::term_type;
-        // Type representing multiplication tasks:
-        // - the current term index from s1,
-        // - the first term index in s2,
-        // - the last term index in s2.
-        using task_type = std::tuple<size_type, size_type, size_type>;
-        // Cache a few quantities.
-        auto &v1 = this->m_v1;
-        auto &v2 = this->m_v2;
-        const auto size1 = v1.size();
-        const auto size2 = v2.size();
-        auto &container = retval._container();
-        // A convenience functor to compute the destination bucket
-        // of a term into retval.
-        auto r_bucket = [&container](term_type const *p) { return container._bucket_from_hash(p->hash()); };
-        // Sort input terms according to bucket positions in retval.
-        auto term_cmp = [&r_bucket](term_type const *p1, term_type const *p2) { return r_bucket(p1) < r_bucket(p2); };
-        std::stable_sort(v1.begin(), v1.end(), term_cmp);
-        std::stable_sort(v2.begin(), v2.end(), term_cmp);
-        // Task comparator. It will compare the bucket index of the terms resulting from
-        // the multiplication of the term in the first series by the first term in the block
-        // of the second series. This is essentially the first bucket index of retval in which the task
-        // will write.
-        // NOTE: this is guaranteed not to overflow as the max bucket size in the hash set is 2**(nbits-1),
-        // and the max value of bucket_size_type is 2**nbits - 1.
-        auto task_cmp = [&r_bucket, &v1, &v2](const task_type &t1, const task_type &t2) {
-            return r_bucket(v1[std::get<0u>(t1)]) + r_bucket(v2[std::get<1u>(t1)])
-                   < r_bucket(v1[std::get<0u>(t2)]) + r_bucket(v2[std::get<1u>(t2)]);
-        };
-        // Task block size.
-        const size_type block_size = safe_cast<size_type>(tuning::get_multiplication_block_size());
-        // Task splitter: split a task in block_size sized tasks and append them to out.
-        auto task_split = [block_size](const task_type &t, std::vector<task_type> &out) {
-            size_type start = std::get<1u>(t), end = std::get<2u>(t);
-            while (static_cast<size_type>(end - start) > block_size) {
-                out.emplace_back(std::get<0u>(t), start, static_cast<size_type>(start + block_size));
-                start = static_cast<size_type>(start + block_size);
-            }
-            if (end != start) {
-                out.emplace_back(std::get<0u>(t), start, end);
-            }
-        };
-        // End of the container, always the same value.
-        const auto it_end = container.end();
-        // Function to perform all the term-by-term multiplications in a task, using tmp_term
-        // as a temporary value for the computation of the result.
-        auto task_consume = [&v1, &v2, &container, it_end, this](const task_type &task, term_type &tmp_term) {
+        piranha_assert(this->m_v1.size() && this->m_v2.size());
+        auto code_cmp
+            = [](term_type const *p1, term_type const *p2) { return p1->m_key.get_int() < p2->m_key.get_int(); };
+        const auto mm1 = std::minmax_element(this->m_v1.begin(), this->m_v1.end(), code_cmp),
+                   mm2 = std::minmax_element(this->m_v2.begin(), this->m_v2.end(), code_cmp);
+        const auto min_code
+            = static_cast<int_type>((*mm1.first)->m_key.get_int() + (*mm2.first)->m_key.get_int()),
+            max_code = static_cast<int_type>((*mm1.second)->m_key.get_int() + (*mm2.second)->m_key.get_int());
+        return std::make_pair(min_code, integer(max_code) - min_code + 1);
+    }
+    // Establish if the dense accumulator should be used, given the number of codes in the range of the result.
+    template <typename T = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    bool dense_kronecker_check(const integer &n_codes) const
+    {
+        using int_type = typename key_t<T>::value_type;
+        const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        // NOTE: Hard-coded value for the density multiplier. This establishes how much memory we are willing to spend
+        // on the accumulator with respect to the size of the operands.
+        const unsigned dense_mult = 16u;
+        // The conditions are:
+        // - the number of slots must not be greater than the number of term-by-term multiplications, so that the
+        //   final scan of the accumulator is amortised by the multiplication,
+        // - the memory used by the accumulator must be proportional to the size of the operands,
+        // - the offsets into the accumulator must be representable by the integral type of the Kronecker codes.
+        return n_codes <= integer(size1) * size2 && n_codes <= integer(dense_mult) * (integer(size1) + size2)
+               && n_codes <= integer(std::numeric_limits<int_type>::max());
+    }
+    // Accumulation policies for the dense Kronecker multiplication. A policy defines the type of the accumulator,
+    // the type of the factors extracted from the coefficients of the operands, the multiply-accumulate operation,
+    // the zero check and the conversion of the accumulator to a coefficient.
+    // Default policy: accumulate directly into the coefficients.
+    template <typename Cf>
+    struct cf_acc_policy {
+        using type = Cf;
+        using factor_type = const Cf *;
+        static factor_type factor(const Cf &c)
+        {
+            return &c;
+        }
+        static void fma(type &a, const factor_type &b, const factor_type &c)
+        {
+            fma_wrap(a, *b, *c);
+        }
+        static bool is_zero(const type &a)
+        {
+            return math::is_zero(a);
+        }
+        static Cf get(type &a)
+        {
+            return std::move(a);
+        }
+    };
+    // Integral coefficients (or rational coefficients, whose numerators are accumulated as in fma_wrap()).
+    template <int NBits>
+    static const mp_integer<NBits> &acc_num(const mp_integer<NBits> &n)
+    {
+        return n;
+    }
+    template <int NBits>
+    static const mp_integer<NBits> &acc_num(const mp_rational<NBits> &q)
+    {
+        return q.num();
+    }
+    template <int NBits>
+    static detail::mp_integer_accumulator<NBits> acc_type(const mp_integer<NBits> &);
+    template <typename Cf>
+    using acc_int_type = typename std::decay<decltype(acc_num(std::declval<const Cf &>()))>::type;
+    // Deferred normalisation, for coefficients fitting in a single limb. See detail::mp_integer_accumulator.
+    template <typename Cf>
+    struct wide_acc_policy {
+        using type = decltype(acc_type(acc_num(std::declval<const Cf &>())));
+        using factor_type = const acc_int_type<Cf> *;
+        static factor_type factor(const Cf &c)
+        {
+            return &acc_num(c);
+        }
+        static void fma(type &a, const factor_type &b, const factor_type &c)
+        {
+            a.multiply_accumulate(*b, *c);
+        }
+        static bool is_zero(const type &a)
+        {
+            return a.is_zero();
+        }
+        static Cf get(type &a)
+        {
+            return Cf(a.get());
+        }
+    };
+#if defined(PIRANHA_UINT128_T)
+    // Multimodular accumulation with K moduli, for larger coefficients. See detail::mp_integer_crt_accumulator.
+    template <std::size_t K, int NBits>
+    static detail::mp_integer_crt_accumulator<NBits, K> crt_acc_type(const mp_integer<NBits> &);
+    template <typename Cf, std::size_t K>
+    struct crt_acc_policy {
+        using type = decltype(crt_acc_type<K>(acc_num(std::declval<const Cf &>())));
+        using factor_type = typename type::residues;
+        static factor_type factor(const Cf &c)
+        {
+            return type::reduce(acc_num(c));
+        }
+        static void fma(type &a, const factor_type &b, const factor_type &c)
+        {
+            a.multiply_accumulate(b, c);
+        }
+        static bool is_zero(const type &a)
+        {
+            return a.is_zero();
+        }
+        static Cf get(type &a)
+        {
+            return Cf(a.get());
+        }
+    };
+#endif
+    template <typename T>
+    using has_wide_acc = std::integral_constant<bool, detail::is_mp_integer<typename T::term_type::cf_type>::value
+                                                          || detail::is_mp_rational<
+                                                                 typename T::term_type::cf_type>::value>;
+    // Dense Kronecker multiplication for integral and rational coefficients. In order of preference:
+    // - if the operands are large and dense enough, use the Kronecker substitution;
+    // - if all the coefficients fit in a single limb, use the deferred normalisation;
+    // - if the bit size of the coefficients of the result is small enough, use the multimodular accumulation,
+    //   which replaces the multiprecision products with a fixed number of machine products;
+    // - otherwise, accumulate into the coefficients.
+    // NOTE: for a fixed term of one operand, the products by the terms of the other operand are all distinct,
+    // hence each slot of the accumulator receives at most min(size1, size2) products, and the absolute value
+    // of the coefficients of the result is bounded by min(size1, size2) * max|c1| * max|c2|.
+    template <typename T = Series, typename std::enable_if<has_wide_acc<T>::value, int>::type = 0>
+    Series dense_kronecker_multiplication(const typename key_t<T>::value_type &min_code,
+                                          const std::size_t &n_codes) const
+    {
+        using cf_type = typename T::term_type::cf_type;
+        using acc_type = typename wide_acc_policy<cf_type>::type;
+        const auto n_prods = std::min(this->m_v1.size(), this->m_v2.size());
+        auto max_bits = [](const typename base::v_ptr &v) {
+            std::size_t retval = 0u;
+            for (const auto &p : v) {
+                retval = std::max(retval, acc_num(p->m_cf).bits_size());
+            }
+            return retval;
+        };
+        // Bit size of the bound on the coefficients of the result.
+        const auto n_bits = max_bits(this->m_v1) + max_bits(this->m_v2) + integer(n_prods).bits_size();
+        if (ks_check(n_codes, n_bits)) {
+            return ks_multiplication(min_code, n_codes, n_bits);
+        }
+        auto eligible = [](typename Series::term_type const *p) { return acc_type::is_eligible(acc_num(p->m_cf)); };
+        if (acc_type::can_accumulate(n_prods) && std::all_of(this->m_v1.begin(), this->m_v1.end(), eligible)
+            && std::all_of(this->m_v2.begin(), this->m_v2.end(), eligible)) {
+            return dense_kronecker_impl<wide_acc_policy<cf_type>>(min_code, n_codes);
+        }
+#if defined(PIRANHA_UINT128_T)
+        using crt_type = typename crt_acc_policy<cf_type, 16u>::type;
+        if (crt_type::can_accumulate(n_prods)) {
+            if (n_bits <= crt_acc_policy<cf_type, 4u>::type::max_bits()) {
+                return dense_kronecker_impl<crt_acc_policy<cf_type, 4u>>(min_code, n_codes);
+            }
+            if (n_bits <= crt_acc_policy<cf_type, 8u>::type::max_bits()) {
+                return dense_kronecker_impl<crt_acc_policy<cf_type, 8u>>(min_code, n_codes);
+            }
+            if (n_bits <= crt_type::max_bits()) {
+                return dense_kronecker_impl<crt_acc_policy<cf_type, 16u>>(min_code, n_codes);
+            }
+        }
+#endif
+        return dense_kronecker_impl<cf_acc_policy<cf_type>>(min_code, n_codes);
+    }
+    // Number of limbs per coefficient in the Kronecker substitution, given the bit size of the bound on the
+    // coefficients of the result. The extra bit accounts for the sign.
+    static std::size_t ks_n_limbs(const std::size_t &n_bits)
+    {
+        return n_bits / unsigned(GMP_NUMB_BITS) + 1u;
+    }
+    // Establish if the Kronecker substitution should be used, given the number of codes in the range of the result
+    // and the bit size of the bound on its coefficients.
+    bool ks_check(const std::size_t &n_codes, const std::size_t &n_bits) const
+    {
+        const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        // NOTE: hard-coded tuning parameters. The substitution pays off when the operands are large enough
+        // for the subquadratic multiplication algorithms of GMP to kick in, and when the packed integers are not
+        // much larger than the operands (that is, when most of the slots are occupied).
+        const typename base::size_type ks_min_size = 64u;
+        const unsigned ks_density = 4u;
+        // The conditions are:
+        // - GMP limbs have no nail bits, as the packing works directly on the limbs,
+        // - the operands are large and dense enough,
+        // - the size of the product, in limbs, is representable in an mpz_t.
+        return GMP_NAIL_BITS == 0 && std::min(size1, size2) >= ks_min_size
+               && integer(n_codes) <= integer(ks_density) * (integer(size1) + size2)
+               && integer(n_codes) * ks_n_limbs(n_bits) <= integer(std::numeric_limits<int>::max());
+    }
+    // Multiplication via Kronecker substitution. The (numerators of the) coefficients of each operand are packed
+    // into a single multiprecision integer, in slots of ks_n_limbs(n_bits) limbs indexed by the codes of the keys,
+    // and the two integers are multiplied via GMP. The slots of the product contain then the coefficients of
+    // the result, in a balanced representation: the coefficients are recovered from the lowest slot upwards,
+    // propagating a carry into the next slot whenever the content of a slot is to be read as negative.
+    template <typename T = Series>
+    Series ks_multiplication(const typename key_t<T>::value_type &min_code, const std::size_t &n_codes,
+                             const std::size_t &n_bits) const
+    {
+        using int_type = typename key_t<T>::value_type;
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        using key_type = typename term_type::key_type;
+        using mp_int_type = acc_int_type<cf_type>;
+        using bucket_size_type = typename base::bucket_size_type;
+        const auto nl = ks_n_limbs(n_bits);
+        // Pack the coefficients of v, whose smallest code is min, into out.
+        auto pack = [nl](const typename base::v_ptr &v, const int_type &min, detail::mpz_raii &out) {
+            // The positive and negative coefficients are packed separately, and then subtracted.
+            detail::mpz_raii neg;
+            const auto max_code = (*std::max_element(v.begin(), v.end(), [](term_type const *p1, term_type const *p2) {
+                                      return p1->m_key.get_int() < p2->m_key.get_int();
+                                  }))->m_key.get_int();
+            const auto n_limbs = (static_cast<std::size_t>(static_cast<int_type>(max_code - min)) + 1u) * nl;
+            ::_mpz_realloc(&out.m_mpz, static_cast<::mp_size_t>(n_limbs));
+            ::_mpz_realloc(&neg.m_mpz, static_cast<::mp_size_t>(n_limbs));
+            std::fill(out.m_mpz._mp_d, out.m_mpz._mp_d + n_limbs, ::mp_limb_t(0u));
+            std::fill(neg.m_mpz._mp_d, neg.m_mpz._mp_d + n_limbs, ::mp_limb_t(0u));
+            for (const auto &p : v) {
+                const auto &n = acc_num(p->m_cf);
+                if (n.sign() == 0) {
+                    continue;
+                }
+                const auto view = n.get_mpz_view();
+                const detail::mpz_struct_t *z = view;
+                piranha_assert(::mpz_size(z) <= nl);
+                std::copy(z->_mp_d, z->_mp_d + ::mpz_size(z),
+                          (n.sign() > 0 ? out : neg).m_mpz._mp_d
+                              + static_cast<std::size_t>(static_cast<int_type>(p->m_key.get_int() - min)) * nl);
+            }
+            // Set the sizes, skipping the most significant zero limbs.
+            auto set_size = [n_limbs](detail::mpz_raii &m) {
+                auto size = n_limbs;
+                for (; size != 0u && m.m_mpz._mp_d[size - 1u] == 0u; --size) {
+                }
+                m.m_mpz._mp_size = static_cast<int>(size);
+            };
+            set_size(out);
+            set_size(neg);
+            ::mpz_sub(&out.m_mpz, &out.m_mpz, &neg.m_mpz);
+        };
+        auto min_code_of = [](const typename base::v_ptr &v) {
+            return (*std::min_element(v.begin(), v.end(), [](term_type const *p1, term_type const *p2) {
+                       return p1->m_key.get_int() < p2->m_key.get_int();
+                   }))->m_key.get_int();
+        };
+        detail::mpz_raii a, b, prod;
+        pack(this->m_v1, min_code_of(this->m_v1), a);
+        if (this->m_square) {
+            ::mpz_mul(&prod.m_mpz, &a.m_mpz, &a.m_mpz);
+        } else {
+            pack(this->m_v2, min_code_of(this->m_v2), b);
+            ::mpz_mul(&prod.m_mpz, &a.m_mpz, &b.m_mpz);
+        }
+        // Unpack the product. If the product is negative, the coefficients are recovered from its absolute
+        // value and then negated.
+        const bool neg = prod.m_mpz._mp_size < 0;
+        const std::size_t p_size = ::mpz_size(&prod.m_mpz);
+        const ::mp_limb_t *p_ptr = prod.m_mpz._mp_d;
+        mp_int_type half(1), full(1);
+        half <<= nl * unsigned(GMP_NUMB_BITS) - 1u;
+        full <<= nl * unsigned(GMP_NUMB_BITS);
+        std::vector<term_type> terms;
+        bool carry = false;
+        for (std::size_t k = 0u; k < n_codes; ++k) {
+            mp_int_type c;
+            const std::size_t begin = k * nl;
+            if (begin < p_size) {
+                // Read-only mpz_t view on the slot.
+                auto size = std::min(nl, p_size - begin);
+                for (; size != 0u && p_ptr[begin + size - 1u] == 0u; --size) {
+                }
+                detail::mpz_struct_t slot;
+                slot._mp_alloc = static_cast<int>(nl);
+                slot._mp_size = static_cast<int>(size);
+                slot._mp_d = const_cast<::mp_limb_t *>(p_ptr + begin);
+                c = mp_int_type(&slot);
+            }
+            if (carry) {
+                c += 1;
+            }
+            carry = c >= half;
+            if (carry) {
+                c -= full;
+            }
+            if (c.sign() == 0) {
+                continue;
+            }
+            if (neg) {
+                c.negate();
+            }
+            terms.emplace_back(cf_type(std::move(c)),
+                               key_type(static_cast<int_type>(min_code + static_cast<int_type>(k))));
+        }
+        piranha_assert(!carry);
+        Series retval;
+        retval.set_symbol_set(this->m_ss);
+        if (terms.empty()) {
+            return retval;
+        }
+        auto &container = retval._container();
+        try {
+            // NOTE: if something goes wrong here, no big deal as retval is still empty.
+            container.rehash(boost::numeric_cast<bucket_size_type>(
+                std::ceil(static_cast<double>(terms.size()) / container.max_load_factor())));
+            // The keys are all distinct and compatible, and the coefficients are not zero.
+            for (auto &t : terms) {
+                const auto bucket_idx = container._bucket(t);
+                container._unique_insert(std::move(t), bucket_idx);
+            }
+            container._update_size(static_cast<bucket_size_type>(terms.size()));
+            this->finalise_series(retval);
+        } catch (...) {
+            container.clear();
+            throw;
+        }
+        return retval;
+    }
+    template <typename T>
+    using has_fft = std::integral_constant<bool, std::is_same<typename T::term_type::cf_type, double>::value
+                                                     && std::numeric_limits<double>::is_iec559>;
+    // Dense Kronecker multiplication for double-precision coefficients: use the FFT if the operands are large
+    // and dense enough, and if the error of the transform is small enough.
+    template <typename T = Series, typename std::enable_if<has_fft<T>::value, int>::type = 0>
+    Series dense_kronecker_multiplication(const typename key_t<T>::value_type &min_code,
+                                          const std::size_t &n_codes) const
+    {
+        Series retval;
+        if (fft_multiplication(min_code, n_codes, retval)) {
+            return retval;
+        }
+        return dense_kronecker_impl<cf_acc_policy<double>>(min_code, n_codes);
+    }
+    template <typename T = Series,
+              typename std::enable_if<!has_wide_acc<T>::value && !has_fft<T>::value, int>::type = 0>
+    Series dense_kronecker_multiplication(const typename key_t<T>::value_type &min_code,
+                                          const std::size_t &n_codes) const
+    {
+        return dense_kronecker_impl<cf_acc_policy<typename T::term_type::cf_type>>(min_code, n_codes);
+    }
+    // Multiplication via FFT, for double-precision coefficients. The coefficients of each operand are laid out
+    // in a vector indexed by the codes of the keys, and the result is computed as the convolution of the two
+    // vectors. Each coefficient of the result is affected by an absolute error bounded by the error of the
+    // transform, hence:
+    // - the FFT is used only if this bound is smaller than the absolute value of any term-by-term product, so that
+    //   the transform does not swamp any of the products contributing to the result,
+    // - the coefficients of the result not greater than the bound in absolute value are set to zero, as they are
+    //   indistinguishable from zero (this includes the coefficients whose products cancel out exactly).
+    // The function returns false, without doing anything, if the FFT is not to be used.
+    template <typename T = Series>
+    bool fft_multiplication(const typename key_t<T>::value_type &min_code, const std::size_t &n_codes,
+                            Series &retval) const
+    {
+        using int_type = typename key_t<T>::value_type;
+        using term_type = typename Series::term_type;
+        const auto size1 = this->m_v1.size(), size2 = this->m_v2.size();
+        // Size of the transform.
+        std::size_t n = 1u, log_n = 0u;
+        for (; n < n_codes; n <<= 1u, ++log_n) {
+            if (unlikely(n > std::numeric_limits<std::size_t>::max() / 2u)) {
+                return false;
+            }
+        }
+        // NOTE: hard-coded tuning parameter. The FFT costs O(n * log(n)) floating-point operations, the direct
+        // multiplication O(size1 * size2).
+        const unsigned fft_mult = 8u;
+        if (integer(size1) * size2 < integer(fft_mult) * n * (log_n + 1u)) {
+            return false;
+        }
+        auto code_cmp
+            = [](term_type const *p1, term_type const *p2) { return p1->m_key.get_int() < p2->m_key.get_int(); };
+        auto abs_cmp = [](term_type const *p1, term_type const *p2) {
+            return std::abs(p1->m_cf) < std::abs(p2->m_cf);
+        };
+        // Lay out the coefficients.
+        auto layout = [&code_cmp](const typename base::v_ptr &v) {
+            const auto mm = std::minmax_element(v.begin(), v.end(), code_cmp);
+            const int_type min = (*mm.first)->m_key.get_int();
+            std::vector<double> out(
+                static_cast<std::size_t>(static_cast<int_type>((*mm.second)->m_key.get_int() - min)) + 1u, 0.);
+            for (const auto &p : v) {
+                out[static_cast<std::size_t>(static_cast<int_type>(p->m_key.get_int() - min))] = p->m_cf;
+            }
+            return out;
+        };
+        const auto a = layout(this->m_v1), b = layout(this->m_v2);
+        piranha_assert(a.size() + b.size() - 1u == n_codes);
+        const double err = detail::fft_real_convolution_error(detail::fft_norm2(a), detail::fft_norm2(b), n),
+                     min_prod = std::abs((*std::min_element(this->m_v1.begin(), this->m_v1.end(), abs_cmp))->m_cf)
+                                * std::abs((*std::min_element(this->m_v2.begin(), this->m_v2.end(), abs_cmp))->m_cf);
+        // NOTE: this also excludes non-finite coefficients, for which err is not finite.
+        if (!(err < min_prod)) {
+            return false;
+        }
+        const auto c = detail::fft_real_convolution(a, b, n);
+        // Copy the coefficients into the accumulator, flushing to zero those within the error bound,
+        // and count the nonzero slots.
+        const unsigned n_threads = this->m_n_threads;
+        const unsigned n_threads_init = tuning::get_parallel_memory_set() ? n_threads : 1u;
+        auto acc = make_parallel_array<double>(n_codes, n_threads_init);
+        const auto n_zones = dense_n_zones(n_codes);
+        std::vector<std::size_t> nz_counts(n_zones, 0u);
+        dense_run_zones(n_threads, n_zones, [&acc, &c, &nz_counts, err, n_zones, n_codes](const std::size_t &z) {
+            const auto zb = dense_zone_bounds(z, n_zones, n_codes);
+            std::size_t count = 0u;
+            for (auto s = zb.first; s != zb.second; ++s) {
+                if (std::abs(c[s]) > err) {
+                    acc[s] = c[s];
+                    ++count;
+                }
+            }
+            nz_counts[z] = count;
+        });
+        retval = dense_kronecker_insert<cf_acc_policy<double>>(acc.get(), min_code, n_codes, nz_counts);
+        return true;
+    }
+    // Dense Kronecker multiplication. The terms of the result are accumulated into a flat array of
+    // accumulators indexed by the code of the key minus min_code. The array is split in contiguous zones,
+    // each of which is processed by a single thread, and the nonzero slots are then inserted into the result.
+    template <typename AccPolicy, typename T = Series,
+              typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value, int>::type
+              = 0>
+    Series dense_kronecker_impl(const typename key_t<T>::value_type &min_code, const std::size_t &n_codes) const
+    {
+        using int_type = typename key_t<T>::value_type;
+        using term_type = typename Series::term_type;
+        using size_type = typename base::size_type;
+        auto &v1 = this->m_v1;
+        auto &v2 = this->m_v2;
+        const auto size1 = v1.size(), size2 = v2.size();
+        piranha_assert(size1 && size2 && n_codes);
+        // Sort the operands according to the codes, and cache the codes of the second series
+        // in a contiguous vector.
+        auto code_cmp
+            = [](term_type const *p1, term_type const *p2) { return p1->m_key.get_int() < p2->m_key.get_int(); };
+        std::sort(v1.begin(), v1.end(), code_cmp);
+        std::sort(v2.begin(), v2.end(), code_cmp);
+        std::vector<int_type> c2;
+        c2.reserve(static_cast<typename std::vector<int_type>::size_type>(size2));
+        std::transform(v2.begin(), v2.end(), std::back_inserter(c2),
+                       [](term_type const *p) { return p->m_key.get_int(); });
+        // Extract the accumulation factors from the coefficients of the operands.
+        using factor_type = typename AccPolicy::factor_type;
+        std::vector<factor_type> f1, f2;
+        f1.reserve(static_cast<typename std::vector<factor_type>::size_type>(size1));
+        f2.reserve(static_cast<typename std::vector<factor_type>::size_type>(size2));
+        auto factor = [](term_type const *p) { return AccPolicy::factor(p->m_cf); };
+        std::transform(v1.begin(), v1.end(), std::back_inserter(f1), factor);
+        std::transform(v2.begin(), v2.end(), std::back_inserter(f2), factor);
+        const unsigned n_threads = this->m_n_threads;
+        // NOTE: it is important here that we use the same n_threads for multiplication and memset as
+        // we tie together pinned threads with potentially different NUMA regions.
+        const unsigned n_threads_init = tuning::get_parallel_memory_set() ? n_threads : 1u;
+        // The accumulator, with all slots initialised to zero.
+        auto acc = make_parallel_array<typename AccPolicy::type>(n_codes, n_threads_init);
+        const auto n_zones = dense_n_zones(n_codes);
+        // Slot of the product of the term with code c1 by the term with code c2. The difference
+        // is always within the limits of int_type, as checked in dense_kronecker_check().
+        auto slot = [min_code](const int_type &c1, const int_type &c2) {
+            return static_cast<std::size_t>(static_cast<int_type>(c1 + c2) - min_code);
+        };
+        auto zone_bounds
+            = [n_zones, n_codes](const std::size_t &z) { return dense_zone_bounds(z, n_zones, n_codes); };
+        // Number of nonzero slots in each zone.
+        std::vector<std::size_t> nz_counts(n_zones, 0u);
+        // Accumulate all the products falling into zone z, and count the nonzero slots.
+        auto zone_mult = [&v1, &c2, &f1, &f2, &acc, &slot, &zone_bounds, &nz_counts, size1, size2](
+            const std::size_t &z) {
+            const auto zb = zone_bounds(z);
+            for (size_type i = 0u; i < size1; ++i) {
+                const auto &t1 = *v1[i];
+                const int_type code1 = t1.m_key.get_int();
+                // The operands are sorted, so once the first product of t1 goes past the zone
+                // all the following terms in the first series will too.
+                if (slot(code1, c2.front()) >= zb.second) {
+                    break;
+                }
+                if (slot(code1, c2.back()) < zb.first) {
+                    continue;
+                }
+                // Locate the range in the second series whose products with t1 end up in the zone.
+                auto it = std::lower_bound(
+                    c2.begin(), c2.end(), zb.first,
+                    [code1, &slot](const int_type &c, const std::size_t &n) { return slot(code1, c) < n; });
+                for (auto j = static_cast<size_type>(it - c2.begin()); j < size2; ++j) {
+                    const auto s = slot(code1, c2[j]);
+                    if (s >= zb.second) {
+                        break;
+                    }
+                    AccPolicy::fma(acc[s], f1[i], f2[j]);
+                }
+            }
+            std::size_t count = 0u;
+            for (auto s = zb.first; s != zb.second; ++s) {
+                if (!AccPolicy::is_zero(acc[s])) {
+                    ++count;
+                }
+            }
+            nz_counts[z] = count;
+        };
+        dense_run_zones(n_threads, n_zones, zone_mult);
+        return dense_kronecker_insert<AccPolicy>(acc.get(), min_code, n_codes, nz_counts);
+    }
+    // Number of zones in which the dense accumulator is subdivided, given the number of slots.
+    std::size_t dense_n_zones(const std::size_t &n_codes) const
+    {
+        const auto zm = safe_cast<unsigned>(tuning::get_multiplication_zone_multiplier());
+        return (this->m_n_threads == 1u) ? 1u : std::min<std::size_t>(n_codes,
+                                                                       safe_cast<std::size_t>(this->m_n_threads) * zm);
+    }
+    // Range of slots in the zone z.
+    static std::pair<std::size_t, std::size_t> dense_zone_bounds(const std::size_t &z, const std::size_t &n_zones,
+                                                                 const std::size_t &n_codes)
+    {
+        const std::size_t spz = n_codes / n_zones;
+        return std::make_pair(static_cast<std::size_t>(z * spz),
+                              (z == n_zones - 1u) ? n_codes : static_cast<std::size_t>((z + 1u) * spz));
+    }
+    // Run the zone functor f over all zones, using multiple threads if needed.
+    static void dense_run_zones(const unsigned &n_threads, const std::size_t &n_zones,
+                                const std::function<void(const std::size_t &)> &f)
+    {
+        if (n_threads == 1u) {
+            for (std::size_t z = 0u; z < n_zones; ++z) {
+                f(z);
+            }
+            return;
+        }
+        // Each thread owns a contiguous block of zones, which matches the portion of the accumulator it
+        // initialised in make_parallel_array() (and which is thus local to it on NUMA machines). The threads
+        // claim the zones of their own block first, and then help the other threads with theirs.
+        auto block_begin = [n_threads, n_zones](const unsigned &i) {
+            return static_cast<std::size_t>(n_zones / n_threads * i);
+        };
+        std::unique_ptr<std::atomic<std::size_t>[]> next_zone(new std::atomic<std::size_t>[n_threads]);
+        for (unsigned i = 0u; i < n_threads; ++i) {
+            next_zone[i].store(block_begin(i));
+        }
+        auto thread_func = [&next_zone, &block_begin, n_threads, n_zones, &f](const unsigned &idx) {
+            for (unsigned k = 0u; k < n_threads; ++k) {
+                const unsigned i = (idx + k) % n_threads;
+                const auto end = (i == n_threads - 1u) ? n_zones : block_begin(i + 1u);
+                while (true) {
+                    const auto z = next_zone[i].fetch_add(1u);
+                    if (z >= end) {
+                        break;
+                    }
+                    f(z);
+                }
+            }
+        };
+        future_list<decltype(thread_func(0u))> ff_list;
+        try {
+            for (unsigned i = 0u; i < n_threads; ++i) {
+                ff_list.push_back(thread_pool::enqueue(i, thread_func, i));
+            }
+            // First let's wait for everything to finish.
+            ff_list.wait_all();
+            // Then, let's handle the exceptions.
+            ff_list.get_all();
+        } catch (...) {
+            ff_list.wait_all();
+            throw;
+        }
+    }
+    // Build the result of a dense multiplication from the array of accumulators acc, given the number of nonzero
+    // slots in each zone. The nonzero slots of each zone are moved into the result by a single thread.
+    template <typename AccPolicy, typename T = Series>
+    Series dense_kronecker_insert(typename AccPolicy::type *acc, const typename key_t<T>::value_type &min_code,
+                                  const std::size_t &n_codes, const std::vector<std::size_t> &nz_counts) const
+    {
+        using int_type = typename key_t<T>::value_type;
+        using term_type = typename Series::term_type;
+        using key_type = typename term_type::key_type;
+        using bucket_size_type = typename base::bucket_size_type;
+        const unsigned n_threads = this->m_n_threads;
+        const unsigned n_threads_init = tuning::get_parallel_memory_set() ? n_threads : 1u;
+        const auto n_zones = nz_counts.size();
+        Series retval;
+        retval.set_symbol_set(this->m_ss);
+        // Move the nonzero slots of zone z into the result.
+        auto zone_insert = [acc, &retval, n_zones, n_codes, min_code](const std::size_t &z,
+                                                                      detail::atomic_flag_array *sl) {
+            auto &container = retval._container();
+            const auto zb = dense_zone_bounds(z, n_zones, n_codes);
+            for (auto s = zb.first; s != zb.second; ++s) {
+                if (AccPolicy::is_zero(acc[s])) {
+                    continue;
+                }
+                term_type tmp{AccPolicy::get(acc[s]),
+                              key_type(static_cast<int_type>(min_code + static_cast<int_type>(s)))};
+                const auto bucket_idx = container._bucket(tmp);
+                if (sl == nullptr) {
+                    container._unique_insert(std::move(tmp), bucket_idx);
+                } else {
+                    detail::atomic_lock_guard alg((*sl)[static_cast<std::size_t>(bucket_idx)]);
+                    container._unique_insert(std::move(tmp), bucket_idx);
+                }
+            }
+        };
+        const auto tot_count = std::accumulate(nz_counts.begin(), nz_counts.end(), integer(0));
+        if (tot_count.sign() == 0) {
+            return retval;
+        }
+        auto &container = retval._container();
+        try {
+            // NOTE: if something goes wrong here, no big deal as retval is still empty.
+            container.rehash(boost::numeric_cast<bucket_size_type>(
+                                 std::ceil(static_cast<double>(tot_count) / container.max_load_factor())),
+                             n_threads_init);
+            if (n_threads == 1u) {
+                for (std::size_t z = 0u; z < n_zones; ++z) {
+                    zone_insert(z, nullptr);
+                }
+            } else {
+                detail::atomic_flag_array sl_array(safe_cast<std::size_t>(container.bucket_count()));
+                dense_run_zones(n_threads, n_zones,
+                                [&zone_insert, &sl_array](const std::size_t &z) { zone_insert(z, &sl_array); });
+            }
+            // The keys in the accumulator are all distinct and compatible, and we did not insert
+            // zero coefficients: we just need to update the number of terms.
+            container._update_size(static_cast<bucket_size_type>(tot_count));
+            this->finalise_series(retval);
+        } catch (...) {
+            container.clear();
+            throw;
+        }
+        return retval;
+    }
+    // Skip policies for the sparse Kronecker multiplication. A policy sorts the operands according to an unsigned
+    // integral key (keeping its own data in sync with the ordering of the terms), and establishes which term-by-term
+    // multiplications are to be skipped. The terms of the second series involved in the multiplication by the i-th
+    // term of the first series are at most those in the index range [0, row_limit(i, size2)[.
+    // No skipping: used in the untruncated multiplication.
+    struct kronecker_no_skip {
+        template <typename Key>
+        void sort(typename base::v_ptr &v1, typename base::v_ptr &v2, const Key &key, unsigned n_threads)
+        {
+            detail::parallel_radix_sort(n_threads, v1, key);
+            detail::parallel_radix_sort(n_threads, v2, key);
+        }
+        bool skip_row(const typename base::size_type &) const
+        {
+            return false;
+        }
+        typename base::size_type row_limit(const typename base::size_type &,
+                                           const typename base::size_type &size2) const
+        {
+            return size2;
+        }
+        bool operator()(const typename base::size_type &, const typename base::size_type &) const
+        {
+            return false;
+        }
+    };
+    // Degree-based skipping: used in the truncated multiplication. The multiplication of the i-th term
+    // of the first series by the j-th term of the second series is skipped if m_d2[j] > m_l1[i], where m_d2
+    // contains the degrees of the terms of the second series and m_l1 the max degree allowed in the second series
+    // for each term of the first series. m_min_d2 is the minimum degree in the second series.
+    template <typename T>
+    struct kronecker_degree_skip {
+        using size_type = typename base::size_type;
+        template <typename Key>
+        static void sort_impl(typename base::v_ptr &v, std::vector<T> &d, const Key &key, unsigned n_threads)
+        {
+            piranha_assert(v.size() == d.size());
+            std::vector<size_type> idx(safe_cast<typename std::vector<size_type>::size_type>(v.size()));
+            std::iota(idx.begin(), idx.end(), size_type(0u));
+            detail::parallel_radix_sort(n_threads, idx, [&v, &key](const size_type &i) { return key(v[i]); });
+            typename base::v_ptr v_copy(v.size());
+            std::vector<T> d_copy;
+            d_copy.reserve(d.size());
+            for (decltype(idx.size()) i = 0u; i < idx.size(); ++i) {
+                v_copy[i] = v[idx[i]];
+                d_copy.push_back(std::move(d[idx[i]]));
+            }
+            v = std::move(v_copy);
+            d = std::move(d_copy);
+        }
+        template <typename Key>
+        void sort(typename base::v_ptr &v1, typename base::v_ptr &v2, const Key &key, unsigned n_threads)
+        {
+            sort_impl(v1, m_l1, key, n_threads);
+            sort_impl(v2, m_d2, key, n_threads);
+        }
+        bool skip_row(const size_type &i) const
+        {
+            return m_min_d2 > m_l1[i];
+        }
+        size_type row_limit(const size_type &, const size_type &size2) const
+        {
+            return size2;
+        }
+        bool operator()(const size_type &i, const size_type &j) const
+        {
+            return m_d2[j] > m_l1[i];
+        }
+        std::vector<T> m_l1;
+        std::vector<T> m_d2;
+        T m_min_d2;
+    };
+    // Squaring: on top of the skipping of the policy m_skip, only the products of the i-th term of the first series
+    // by the j-th term of the second series with j < i are considered. This requires that the terms in the first
+    // and second series are in the same order (the diagonal is dealt with separately, see base::square_double()).
+    template <typename Skip>
+    struct kronecker_square_skip {
+        using size_type = typename base::size_type;
+        explicit kronecker_square_skip(Skip &s) : m_skip(s)
+        {
+        }
+        template <typename Key>
+        void sort(typename base::v_ptr &v1, typename base::v_ptr &v2, const Key &key, unsigned n_threads)
+        {
+            // NOTE: the terms in v1 and v2 have the same keys in the same order, hence the
+            // stable sorting will produce the same permutation.
+            m_skip.sort(v1, v2, key, n_threads);
+            piranha_assert(std::equal(v1.begin(), v1.end(), v2.begin(),
+                                      [](typename base::v_ptr::value_type p1, typename base::v_ptr::value_type p2) {
+                                          return p1->m_key == p2->m_key;
+                                      }));
+        }
+        bool skip_row(const size_type &i) const
+        {
+            return m_skip.skip_row(i);
+        }
+        size_type row_limit(const size_type &i, const size_type &size2) const
+        {
+            return std::min(i, m_skip.row_limit(i, size2));
+        }
+        bool operator()(const size_type &i, const size_type &j) const
+        {
+            return m_skip(i, j);
+        }
+        Skip &m_skip;
+    };
+    // Accumulators for the sparse Kronecker multiplication. An accumulator is used by a single thread, and it collects
+    // the products falling into a zone [a,b[ of buckets of the output table. The factors of the accumulation policy,
+    // extracted from the coefficients of the operands, are shared among the accumulators of all threads.
+    // Side accumulator: the coefficient of the term stored in the first node of each bucket of the zone is
+    // accumulated into a slot of an array of AccPolicy::type, and added to the term when the zone is complete.
+    // The first node of a bucket never changes once occupied, as the new nodes are linked after it. The terms
+    // stored in the other nodes of the buckets, which are few for reasonable load factors, are accumulated directly
+    // into their coefficients.
+    template <typename AccPolicy>
+    class sparse_acc
+    {
+        using term_type = typename Series::term_type;
+        using cf_type = typename term_type::cf_type;
+        using size_type = typename base::size_type;
+        using bucket_size_type = typename base::bucket_size_type;
+        using container_type = uncvref_t<decltype(std::declval<Series &>()._container())>;
+        using factor_type = typename AccPolicy::factor_type;
+
+    public:
+        using shared_type = std::pair<std::vector<factor_type>, std::vector<factor_type>>;
+        static shared_type make_shared(const typename base::v_ptr &v1, const typename base::v_ptr &v2)
+        {
+            shared_type retval;
+            retval.first.reserve(static_cast<typename std::vector<factor_type>::size_type>(v1.size()));
+            retval.second.reserve(static_cast<typename std::vector<factor_type>::size_type>(v2.size()));
+            auto factor = [](term_type const *p) { return AccPolicy::factor(p->m_cf); };
+            std::transform(v1.begin(), v1.end(), std::back_inserter(retval.first), factor);
+            std::transform(v2.begin(), v2.end(), std::back_inserter(retval.second), factor);
+            return retval;
+        }
+        explicit sparse_acc(const shared_type &shared) : m_shared(shared), m_a(0u)
+        {
+        }
+        void start_zone(const bucket_size_type &a, const bucket_size_type &b)
+        {
+            m_a = a;
+            m_acc.clear();
+            m_acc.resize(static_cast<typename std::vector<acc_type>::size_type>(b - a));
+        }
+        // Set the coefficient of the new term t, which is going to be inserted in the bucket bucket_idx, to the
+        // product of the i-th term of the first series by the j-th term of the second series.
+        void insert(term_type &t, const cf_type &c1, const cf_type &c2, const size_type &i, const size_type &j,
+                    const container_type &container, const bucket_size_type &bucket_idx)
+        {
+            const auto &list = container._get_bucket_list(bucket_idx);
+            if (list.begin() == list.end()) {
+                t.m_cf = cf_type(0);
+                AccPolicy::fma(slot(bucket_idx), m_shared.first[i], m_shared.second[j]);
+            } else {
+                detail::cf_mult_impl(t.m_cf, c1, c2);
+            }
+        }
+        // Accumulate the product of the i-th term of the first series by the j-th term of the second series
+        // into the existing term pointed to by it, in the bucket bucket_idx.
+        template <typename It>
+        void fma(const It &it, const cf_type &c1, const cf_type &c2, const size_type &i, const size_type &j,
+                 const container_type &container, const bucket_size_type &bucket_idx)
+        {
+            if (&*it == &*container._get_bucket_list(bucket_idx).begin()) {
+                AccPolicy::fma(slot(bucket_idx), m_shared.first[i], m_shared.second[j]);
+            } else {
+                fma_wrap(it->m_cf, c1, c2);
+            }
+        }
+        // Add the accumulated values to the terms in the first nodes of the buckets of the zone.
+        void end_zone(const container_type &container)
+        {
+            for (decltype(m_acc.size()) k = 0u; k < m_acc.size(); ++k) {
+                if (AccPolicy::is_zero(m_acc[k])) {
+                    continue;
+                }
+                const auto &list = container._get_bucket_list(static_cast<bucket_size_type>(m_a + k));
+                piranha_assert(list.begin() != list.end());
+                // NOTE: the coefficients of the terms are mutable.
+                add_wrap(list.begin()->m_cf, AccPolicy::get(m_acc[k]));
+            }
+        }
+
+    private:
+        using acc_type = typename AccPolicy::type;
+        acc_type &slot(const bucket_size_type &bucket_idx)
+        {
+            piranha_assert(bucket_idx >= m_a && bucket_idx - m_a < m_acc.size());
+            return m_acc[static_cast<typename std::vector<acc_type>::size_type>(bucket_idx - m_a)];
+        }
+        const shared_type &m_shared;
+        bucket_size_type m_a;
+        std::vector<acc_type> m_acc;
+    };
+    // Direct accumulation into the coefficients of the terms of the output table.
+    template <typename Cf>
+    class sparse_acc<cf_acc_policy<Cf>>
+    {
+        using term_type = typename Series::term_type;
+        using size_type = typename base::size_type;
+        using bucket_size_type = typename base::bucket_size_type;
+        using container_type = uncvref_t<decltype(std::declval<Series &>()._container())>;
+
+    public:
+        struct shared_type {
+        };
+        static shared_type make_shared(const typename base::v_ptr &, const typename base::v_ptr &)
+        {
+            return shared_type{};
+        }
+        explicit sparse_acc(const shared_type &)
+        {
+        }
+        void start_zone(const bucket_size_type &, const bucket_size_type &)
+        {
+        }
+        void insert(term_type &t, const Cf &c1, const Cf &c2, const size_type &, const size_type &,
+                    const container_type &, const bucket_size_type &)
+        {
+            // NOTE: for coefficient series, we might want to insert with move() below,
+            // as we are not going to re-use the allocated resources in tmp.m_cf.
+            // Take care of multiplying the coefficient.
+            detail::cf_mult_impl(t.m_cf, c1, c2);
+        }
+        template <typename It>
+        void fma(const It &it, const Cf &c1, const Cf &c2, const size_type &, const size_type &,
+                 const container_type &, const bucket_size_type &)
+        {
+            // NOTE: here we need to decide if we want to give the same treatment to fmp as we did with
+            // cf_mult_impl.
+            // For the moment it is an implementation detail of this class.
+            fma_wrap(it->m_cf, c1, c2);
+        }
+        void end_zone(const container_type &)
+        {
+        }
+    };
+    // Sparse Kronecker multiplication: select the accumulation policy and run the multiplication. As in the dense
+    // Kronecker multiplication, the deferred normalisation is used if all the coefficients fit in a single limb,
+    // and the multimodular accumulation is used if the bit size of the coefficients of the result is small enough.
+    // The side accumulators are not used when the output table is grown during the multiplication (which would
+    // move the terms around), or with containers whose buckets do not have stable first nodes.
+    // NOTE: each term of the first series generates distinct terms when multiplied by the terms of the second
+    // series, hence each term of the result receives at most min(size1, size2) products, as in the dense case.
+    template <typename Skip, typename T = Series, typename std::enable_if<!has_wide_acc<T>::value, int>::type = 0>
+    void sparse_kronecker_multiplication(Series &retval, Skip &skip, bool grow = false) const
+    {
+        sparse_kronecker_impl<cf_acc_policy<typename Series::term_type::cf_type>>(retval, skip, grow);
+    }
+    template <typename Skip, typename T = Series, typename std::enable_if<has_wide_acc<T>::value, int>::type = 0>
+    void sparse_kronecker_multiplication(Series &retval, Skip &skip, bool grow = false) const
+    {
+        using cf_type = typename T::term_type::cf_type;
+        using acc_type = typename wide_acc_policy<cf_type>::type;
+        using container_type = uncvref_t<decltype(retval._container())>;
+        if (grow || !detail::has_concurrent_buckets<container_type>::value) {
+            sparse_kronecker_impl<cf_acc_policy<cf_type>>(retval, skip, grow);
+            return;
+        }
+        const auto n_prods = std::min(this->m_v1.size(), this->m_v2.size());
+        auto eligible = [](typename Series::term_type const *p) { return acc_type::is_eligible(acc_num(p->m_cf)); };
+        if (acc_type::can_accumulate(n_prods) && std::all_of(this->m_v1.begin(), this->m_v1.end(), eligible)
+            && std::all_of(this->m_v2.begin(), this->m_v2.end(), eligible)) {
+            sparse_kronecker_impl<wide_acc_policy<cf_type>>(retval, skip, grow);
+            return;
+        }
+#if defined(PIRANHA_UINT128_T)
+        // NOTE: the side accumulators are as large as the output table, hence here we limit the number of moduli.
+        using crt_type = typename crt_acc_policy<cf_type, 8u>::type;
+        if (crt_type::can_accumulate(n_prods)) {
+            auto max_bits = [](const typename base::v_ptr &v) {
+                std::size_t retval = 0u;
+                for (const auto &p : v) {
+                    retval = std::max(retval, acc_num(p->m_cf).bits_size());
+                }
+                return retval;
+            };
+            // Bit size of the bound on the coefficients of the result.
+            const auto n_bits = max_bits(this->m_v1) + max_bits(this->m_v2) + integer(n_prods).bits_size();
+            if (n_bits <= crt_acc_policy<cf_type, 4u>::type::max_bits()) {
+                sparse_kronecker_impl<crt_acc_policy<cf_type, 4u>>(retval, skip, grow);
+                return;
+            }
+            if (n_bits <= crt_type::max_bits()) {
+                sparse_kronecker_impl<crt_acc_policy<cf_type, 8u>>(retval, skip, grow);
+                return;
+            }
+        }
+#endif
+        sparse_kronecker_impl<cf_acc_policy<cf_type>>(retval, skip, grow);
+    }
+    // NOTE: if grow is true, the output table will be enlarged during the multiplication as needed. This is
+    // supported only in single-threaded mode, and with the direct accumulation policy.
+    template <typename AccPolicy, typename Skip>
+    void sparse_kronecker_impl(Series &retval, Skip &skip, bool grow) const
+    {
+        using bucket_size_type = typename base::bucket_size_type;
+        using size_type = typename base::size_type;
+        using term_type = typename Series::term_type;
+        // Type representing multiplication tasks:
+        // - the current term index from s1,
+        // - the first term index in s2,
+        // - the last term index in s2.
+        using task_type = std::tuple<size_type, size_type, size_type>;
+        // Cache a few quantities.
+        auto &v1 = this->m_v1;
+        auto &v2 = this->m_v2;
+        const auto size1 = v1.size();
+        const auto size2 = v2.size();
+        auto &container = retval._container();
+        // A convenience functor to compute the destination bucket
+        // of a term into retval.
+        auto r_bucket = [&container](term_type const *p) { return container._bucket_from_hash(p->hash()); };
+        // Sort input terms according to bucket positions in retval.
+        skip.sort(v1, v2, r_bucket, this->m_n_threads);
+        // Task sorting key. It is the sum of the bucket indices of the term in the first series
+        // and of the first term in the block of the second series. This is essentially the first bucket
+        // index of retval in which the task will write. The tasks are sorted with a radix sort on this key.
+        // NOTE: this is guaranteed not to overflow as the max bucket size in the hash set is 2**(nbits-1),
+        // and the max value of bucket_size_type is 2**nbits - 1.
+        auto task_key = [&r_bucket, &v1, &v2](const task_type &t) {
+            return static_cast<bucket_size_type>(r_bucket(v1[std::get<0u>(t)]) + r_bucket(v2[std::get<1u>(t)]));
+        };
+        // Task block size.
+        const size_type block_size = safe_cast<size_type>(tuning::get_multiplication_block_size<term_type>());
+        // Task splitter: split a task in block_size sized tasks and append them to out.
+        auto task_split = [block_size](const task_type &t, std::vector<task_type> &out) {
+            size_type start = std::get<1u>(t), end = std::get<2u>(t);
+            while (static_cast<size_type>(end - start) > block_size) {
+                out.emplace_back(std::get<0u>(t), start, static_cast<size_type>(start + block_size));
+                start = static_cast<size_type>(start + block_size);
+            }
+            if (end != start) {
+                out.emplace_back(std::get<0u>(t), start, end);
+            }
+        };
+        // End of the container. This changes only if the container is grown on the fly.
+        auto it_end = container.end();
+        piranha_assert((!grow || std::is_same<AccPolicy, cf_acc_policy<typename term_type::cf_type>>::value));
+        // The factors of the accumulation policy. They are indexed as v1 and v2 (and the replicas of v2).
+        using acc_t = sparse_acc<AccPolicy>;
+        const auto acc_shared = acc_t::make_shared(v1, v2);
+        // Function to perform all the term-by-term multiplications in a task, using tmp_term
+        // as a temporary value for the computation of the result. The terms of the second series
+        // are read from lv2, which is either v2 or a replica of it, and the products are accumulated
+        // via acc. It will return the number of new terms inserted in retval.
+        auto task_consume = [&v1, &container, &it_end, &skip](const task_type &task, term_type &tmp_term,
+                                                            const typename base::v_ptr &lv2, acc_t &acc) {
             // Get the term in the first series.
-            term_type const *t1 = v1[std::get<0u>(task)];
+            const size_type idx1 = std::get<0u>(task);
+            term_type const *t1 = v1[idx1];
             // Get pointers to the second series.
-            term_type const **start2 = &(v2[std::get<1u>(task)]), **end2 = &(v2[std::get<2u>(task)]);
+            term_type const *const *start2 = lv2.data() + std::get<1u>(task),
+                                   *const *end2 = lv2.data() + std::get<2u>(task);
+            // Index in the second series, used for skipping.
+            size_type idx2 = std::get<1u>(task);
             // NOTE: these will have to be adapted for kd_monomial.
             using int_type = decltype(t1->m_key.get_int());
             // Get shortcuts to cf and key in t1.
             const auto &cf1 = t1->m_cf;
             const int_type key1 = t1->m_key.get_int();
+            bucket_size_type n_new = 0u;
             // Iterate over the task.
-            for (; start2 != end2; ++start2) {
+            for (; start2 != end2; ++start2, ++idx2) {
+                if (skip(idx1, idx2)) {
+                    continue;
+                }
                 // Const ref to the current term in the second series.
                 const auto &cur = **start2;
                 // Add the keys.
@@ -3141,34 +4633,58 @@ private:
                 auto bucket_idx = container._bucket(tmp_term);
                 const auto it = container._find(tmp_term, bucket_idx);
                 if (it == it_end) {
-                    // NOTE: for coefficient series, we might want to insert with move() below,
-                    // as we are not going to re-use the allocated resources in tmp.m_cf.
-                    // Take care of multiplying the coefficient.
-                    detail::cf_mult_impl(tmp_term.m_cf, cf1, cur.m_cf);
+                    acc.insert(tmp_term, cf1, cur.m_cf, idx1, idx2, container, bucket_idx);
                     container._unique_insert(tmp_term, bucket_idx);
+                    ++n_new;
                 } else {
-                    // NOTE: here we need to decide if we want to give the same treatment to fmp as we did with
-                    // cf_mult_impl.
-                    // For the moment it is an implementation detail of this class.
-                    this->fma_wrap(it->m_cf, cf1, cur.m_cf);
+                    acc.fma(it, cf1, cur.m_cf, idx1, idx2, container, bucket_idx);
                 }
             }
+            return n_new;
         };
+        // The zone statistics are collected only in multithreaded mode.
+        m_zone_stats.clear();
         if (this->m_n_threads == 1u) {
             try {
                 // Single threaded case.
                 // Create the vector of tasks.
                 std::vector<task_type> tasks;
                 for (decltype(v1.size()) i = 0u; i < size1; ++i) {
-                    task_split(std::make_tuple(i, size_type(0u), size2), tasks);
+                    if (!skip.skip_row(i)) {
+                        task_split(std::make_tuple(i, size_type(0u), skip.row_limit(i, size2)), tasks);
+                    }
                 }
                 // Sort the tasks.
-                std::stable_sort(tasks.begin(), tasks.end(), task_cmp);
-                // Iterate over the tasks and run the multiplication.
+                detail::parallel_radix_sort(1u, tasks, task_key);
+                // Iterate over the tasks and run the multiplication. The whole table is a single zone.
                 term_type tmp_term;
+                acc_t acc(acc_shared);
+                acc.start_zone(0u, container.bucket_count());
+                // Number of terms in retval and max number of terms allowed by the load factor,
+                // used only if we need to grow retval.
+                auto max_n_terms = [&container]() {
+                    return static_cast<bucket_size_type>(static_cast<double>(container.bucket_count())
+                                                         * container.max_load_factor());
+                };
+                // NOTE: the size of the container has not been updated yet, and it accounts for the terms
+                // which were already in retval.
+                bucket_size_type n_terms = container.size(), max_n = max_n_terms();
                 for (const auto &t : tasks) {
-                    task_consume(t, tmp_term);
+                    const auto n_new = task_consume(t, tmp_term, v2, acc);
+                    if (grow) {
+                        // NOTE: n_terms is bounded by the number of term-by-term multiplications, which
+                        // in grow mode is small.
+                        n_terms = static_cast<bucket_size_type>(n_terms + n_new);
+                        if (n_terms > max_n) {
+                            // NOTE: the size of the container is not updated during the multiplication,
+                            // so the rehash will never be blocked by the load factor check.
+                            container.rehash(safe_cast<bucket_size_type>(integer(container.bucket_count()) * 2));
+                            it_end = container.end();
+                            max_n = max_n_terms();
+                        }
+                    }
                 }
+                acc.end_zone(container);
                 this->sanitise_series(retval, this->m_n_threads);
                 this->finalise_series(retval);
             } catch (...) {
@@ -3177,12 +4693,12 @@ private:
             }
             return;
         }
+        piranha_assert(!grow);
         // Number of buckets in retval.
         const bucket_size_type bucket_count = container.bucket_count();
         // Compute the number of zones in which the output container will be subdivided,
         // a multiple of the number of threads.
-        // NOTE: zm is a tuning parameter.
-        const unsigned zm = 10u;
+        const auto zm = safe_cast<unsigned>(tuning::get_multiplication_zone_multiplier());
         const bucket_size_type n_zones = static_cast<bucket_size_type>(integer(this->m_n_threads) * zm);
         // Number of buckets per zone (can be zero).
         const bucket_size_type bpz = static_cast<bucket_size_type>(bucket_count / n_zones);
@@ -3222,8 +4738,8 @@ private:
             return first;
         };
         // Fill the task table.
-        auto table_filler = [&task_table, bpz, zm, this, bucket_count, size1, size2, &l_bound, &task_split,
-                             &task_cmp](const unsigned &thread_idx) {
+        auto table_filler = [&task_table, bpz, zm, this, bucket_count, size1, size2, &l_bound, &task_split, &task_key,
+                             &skip](const unsigned &thread_idx) {
             for (unsigned n = 0u; n < zm; ++n) {
                 std::vector<task_type> cur_tasks;
                 // [a,b[ is the container zone.
@@ -3237,7 +4753,13 @@ private:
                 }
                 // First batch of tasks.
                 for (size_type i = 0u; i < size1; ++i) {
-                    auto t = std::make_tuple(i, l_bound(0u, size2, a, i), l_bound(0u, size2, b, i));
+                    const size_type lim = skip.row_limit(i, size2);
+                    // NOTE: we need to check for an empty row here, otherwise the check below
+                    // on the output of l_bound() would end the loop too early.
+                    if (skip.skip_row(i) || lim == 0u) {
+                        continue;
+                    }
+                    auto t = std::make_tuple(i, l_bound(0u, lim, a, i), l_bound(0u, lim, b, i));
                     if (std::get<1u>(t) == 0u && std::get<2u>(t) == 0u) {
                         // This means that all the next tasks we will compute will be empty,
                         // no sense in calculating them.
@@ -3249,15 +4771,20 @@ private:
                 // Note: we can always compute a,b + bucket_count because of the limits on the maximum value of
                 // bucket_count.
                 for (size_type i = 0u; i < size1; ++i) {
-                    auto t = std::make_tuple(i, l_bound(0u, size2, static_cast<bucket_size_type>(a + bucket_count), i),
-                                             l_bound(0u, size2, static_cast<bucket_size_type>(b + bucket_count), i));
+                    const size_type lim = skip.row_limit(i, size2);
+                    if (skip.skip_row(i) || lim == 0u) {
+                        continue;
+                    }
+                    auto t = std::make_tuple(i, l_bound(0u, lim, static_cast<bucket_size_type>(a + bucket_count), i),
+                                             l_bound(0u, lim, static_cast<bucket_size_type>(b + bucket_count), i));
                     if (std::get<1u>(t) == 0u && std::get<2u>(t) == 0u) {
                         break;
                     }
                     task_split(t, cur_tasks);
                 }
                 // Sort the task vector.
-                std::stable_sort(cur_tasks.begin(), cur_tasks.end(), task_cmp);
+                // NOTE: we are already running in a thread of the pool here.
+                detail::parallel_radix_sort(1u, cur_tasks, task_key);
                 // Move the vector of tasks in the table.
                 task_table[static_cast<decltype(task_table.size())>(thread_idx * zm + n)] = std::move(cur_tasks);
             }
@@ -3276,23 +4803,90 @@ private:
             ff_list.wait_all();
             throw;
         }
+        using t_size_type = decltype(task_table.size());
+        // Number of term-by-term multiplications in a vector of tasks.
+        auto tasks_work = [](const std::vector<task_type> &v) {
+            integer retval(0);
+            for (const auto &t : v) {
+                retval += std::get<2u>(t) - std::get<1u>(t);
+            }
+            return retval;
+        };
+        // Split the oversized zones. The zones in the new table are still sorted by bucket index. A zone is split
+        // by bisecting its bucket range: each task is split at the index in the second series from which the
+        // products land in the upper half of the range.
+        // NOTE: a zone is considered oversized if its work is more than twice the average. This is a tuning
+        // parameter. We never split zones with less work than a single block.
+        std::vector<integer> zone_work;
+        integer tot_work(0);
+        for (const auto &v : task_table) {
+            zone_work.push_back(tasks_work(v));
+            tot_work += zone_work.back();
+        }
+        const integer max_work = std::max(tot_work * 2 / n_zones, integer(block_size));
+        std::vector<std::vector<task_type>> new_table;
+        std::vector<std::pair<bucket_size_type, bucket_size_type>> zone_bounds;
+        std::vector<integer> new_work;
+        std::function<void(std::vector<task_type> &, bucket_size_type, bucket_size_type, const integer &)> zone_split;
+        zone_split = [&zone_split, &new_table, &zone_bounds, &new_work, &max_work, &v1, &v2, &r_bucket, &l_bound,
+                      &task_key, bucket_count, this](std::vector<task_type> &tasks, bucket_size_type a,
+                                                     bucket_size_type b, const integer &work) {
+            if (work <= max_work || b - a < 2u) {
+                new_table.push_back(std::move(tasks));
+                zone_bounds.emplace_back(a, b);
+                new_work.push_back(work);
+                return;
+            }
+            const auto mid = static_cast<bucket_size_type>(a + (b - a) / 2u);
+            std::vector<task_type> lower, upper;
+            integer l_work(0), u_work(0);
+            for (const auto &t : tasks) {
+                const size_type i = std::get<0u>(t), start2 = std::get<1u>(t), end2 = std::get<2u>(t);
+                // Tasks writing into [a + bucket_count, b + bucket_count[ (the second batch in the table filler).
+                // NOTE: this cannot overflow, see above.
+                const bucket_size_type offset
+                    = (r_bucket(v1[i]) + r_bucket(v2[start2]) >= bucket_count) ? bucket_count : 0u;
+                // NOTE: l_bound() returns zero if all the products in the task are above the limit.
+                const auto k
+                    = std::max(start2, l_bound(start2, end2, static_cast<bucket_size_type>(mid + offset), i));
+                if (k != start2) {
+                    lower.emplace_back(i, start2, k);
+                    l_work += k - start2;
+                }
+                if (k != end2) {
+                    upper.emplace_back(i, k, end2);
+                    u_work += end2 - k;
+                }
+            }
+            std::vector<task_type>().swap(tasks);
+            // NOTE: the tasks in the lower half keep their starting points, hence they are still sorted.
+            detail::parallel_radix_sort(this->m_n_threads, upper, task_key);
+            zone_split(lower, a, mid, l_work);
+            zone_split(upper, mid, b, u_work);
+        };
+        for (t_size_type z = 0u; z < task_table.size(); ++z) {
+            const auto a = static_cast<bucket_size_type>(bpz * z);
+            const auto b = (z == task_table.size() - 1u) ? bucket_count : static_cast<bucket_size_type>(a + bpz);
+            zone_split(task_table[z], a, b, zone_work[static_cast<decltype(zone_work.size())>(z)]);
+        }
+        task_table = std::move(new_table);
+        zone_work = std::move(new_work);
         // Check the consistency of the table for debug purposes.
-        auto table_checker = [&task_table, size1, size2, &r_bucket, bpz, bucket_count, &v1, &v2]() -> bool {
+        auto table_checker = [&task_table, &zone_bounds, size1, size2, &r_bucket, &v1, &v2, &skip]() -> bool {
             // Total number of term-by-term multiplications. Needs to be equal
-            // to size1 * size2 at the end.
-            integer tot_n(0);
+            // to the sum of the row limits of the rows which are not skipped at the end.
+            integer tot_n(0), n_expected(0);
+            for (size_type i = 0u; i < size1; ++i) {
+                if (!skip.skip_row(i)) {
+                    n_expected += skip.row_limit(i, size2);
+                }
+            }
             // Tmp term for multiplications.
             term_type tmp_term;
             for (decltype(task_table.size()) i = 0u; i < task_table.size(); ++i) {
                 const auto &v = task_table[i];
                 // Bucket limits of each zone.
-                bucket_size_type a = static_cast<bucket_size_type>(bpz * i), b;
-                // Special casing for the last zone in the table.
-                if (i == task_table.size() - 1u) {
-                    b = bucket_count;
-                } else {
-                    b = static_cast<bucket_size_type>(a + bpz);
-                }
+                const bucket_size_type a = zone_bounds[i].first, b = zone_bounds[i].second;
                 for (const auto &t : v) {
                     auto idx1 = std::get<0u>(t), start2 = std::get<1u>(t), end2 = std::get<2u>(t);
                     using int_type = decltype(v1[idx1]->m_key.get_int());
@@ -3308,38 +4902,122 @@ private:
                     }
                 }
             }
-            return tot_n == integer(size1) * size2;
+            return tot_n == n_expected;
         };
         (void)table_checker;
         piranha_assert(table_checker());
+        // Assign to each thread a contiguous range of zones, so that the ranges contain roughly the
+        // same amount of work. The range of thread i is [range_start[i], range_start[i + 1][.
+        const t_size_type n_tz = task_table.size();
+        std::vector<t_size_type> range_start(static_cast<decltype(range_start.size())>(this->m_n_threads + 1u), n_tz);
+        range_start[0u] = 0u;
+        integer cur_work(0);
+        unsigned cur_thread = 1u;
+        for (t_size_type z = 0u; z < n_tz; ++z) {
+            cur_work += zone_work[static_cast<decltype(zone_work.size())>(z)];
+            while (cur_thread < this->m_n_threads && cur_work * this->m_n_threads >= tot_work * cur_thread) {
+                range_start[cur_thread] = static_cast<t_size_type>(z + 1u);
+                ++cur_thread;
+            }
+        }
+        // Front and back of the ranges. The owner of a range claims zones from the front, the other threads
+        // steal zones from the back. The actual claim of a zone is confirmed via the vector of atomic flags.
+        std::vector<std::atomic<t_size_type>> fronts(this->m_n_threads), backs(this->m_n_threads);
+        for (unsigned i = 0u; i < this->m_n_threads; ++i) {
+            fronts[i].store(range_start[i]);
+            backs[i].store(range_start[i + 1u]);
+        }
         // Init the vector of atomic flags.
-        detail::atomic_flag_array af(safe_cast<std::size_t>(task_table.size()));
+        detail::atomic_flag_array af(safe_cast<std::size_t>(n_tz));
+        // Init the statistics.
+        m_zone_stats.assign(this->m_n_threads, std::make_pair(std::size_t(0u), std::size_t(0u)));
+        // On NUMA machines, each thread would read the terms of the second series (which are accessed
+        // repeatedly by all the tasks) from the memory of a single node. Replicate them on each node instead.
+        const auto numa_nodes = thread_pool_numa_nodes(this->m_n_threads);
+        std::vector<std::vector<term_type>> replicas;
+        std::vector<typename base::v_ptr> replica_ptrs;
+        if (!numa_nodes.empty()) {
+            const auto n_nodes = static_cast<std::size_t>(*std::max_element(numa_nodes.begin(), numa_nodes.end())) + 1u;
+            replicas.resize(n_nodes);
+            replica_ptrs.resize(n_nodes);
+            // NOTE: the replica of a node is built by the first thread running on it, so that the
+            // memory is allocated (and first touched) on the node.
+            auto build_replica = [&v2, &replicas, &replica_ptrs](const std::size_t &n) {
+                auto &r = replicas[n];
+                auto &rp = replica_ptrs[n];
+                r.reserve(static_cast<typename std::vector<term_type>::size_type>(v2.size()));
+                rp.reserve(v2.size());
+                for (const auto &p : v2) {
+                    r.push_back(*p);
+                }
+                for (const auto &t : r) {
+                    rp.push_back(&t);
+                }
+            };
+            future_list<decltype(build_replica(0u))> fr_list;
+            try {
+                for (unsigned i = 0u; i < this->m_n_threads; ++i) {
+                    const auto n = static_cast<std::size_t>(numa_nodes[i]);
+                    if (std::find(numa_nodes.begin(), numa_nodes.begin() + i, numa_nodes[i])
+                        == numa_nodes.begin() + i) {
+                        fr_list.push_back(thread_pool::enqueue(i, build_replica, n));
+                    }
+                }
+                fr_list.wait_all();
+                fr_list.get_all();
+            } catch (...) {
+                fr_list.wait_all();
+                throw;
+            }
+        }
         // Thread functor.
-        auto thread_functor = [zm, &task_table, &af, &v1, &v2, &container, &task_consume](const unsigned &thread_idx) {
-            using t_size_type = decltype(task_table.size());
+        auto thread_functor = [&task_table, &zone_bounds, &range_start, &fronts, &backs, &af, &task_consume, &v2,
+                               &numa_nodes, &replica_ptrs, &acc_shared, &container, this](const unsigned &thread_idx) {
             // Temporary term_type for caching.
             term_type tmp_term;
-            // The starting index in the task table.
-            auto t_idx = static_cast<t_size_type>(t_size_type(thread_idx) * zm);
-            const auto start_t_idx = t_idx;
-            while (true) {
-                // If this returns false, it means that the tasks still need to be consumed;
-                if (!af[static_cast<std::size_t>(t_idx)].test_and_set()) {
-                    // Current vector of tasks.
-                    const auto &cur_tasks = task_table[t_idx];
-                    for (const auto &t : cur_tasks) {
-                        task_consume(t, tmp_term);
-                    }
+            // The accumulator of this thread, reused for all the zones it consumes.
+            acc_t acc(acc_shared);
+            auto &stats = this->m_zone_stats[thread_idx];
+            // The terms of the second series local to this thread.
+            const auto &lv2 = numa_nodes.empty() ? v2 : replica_ptrs[static_cast<std::size_t>(numa_nodes[thread_idx])];
+            // Consume the tasks of the zone z, if nobody claimed it yet.
+            auto zone_consume = [&task_table, &zone_bounds, &af, &task_consume, &tmp_term, &lv2, &acc,
+                                 &container](const t_size_type &z) -> bool {
+                if (af[static_cast<std::size_t>(z)].test_and_set()) {
+                    return false;
                 }
-                // Update the index, wrapping around if necessary.
-                t_idx = static_cast<t_size_type>(t_idx + 1u);
-                if (t_idx == task_table.size()) {
-                    t_idx = 0u;
+                acc.start_zone(zone_bounds[z].first, zone_bounds[z].second);
+                for (const auto &t : task_table[z]) {
+                    task_consume(t, tmp_term, lv2, acc);
                 }
-                // If we got back to the original index, get out.
-                if (t_idx == start_t_idx) {
+                acc.end_zone(container);
+                return true;
+            };
+            // First we consume the zones in our range.
+            const t_size_type hi = range_start[thread_idx + 1u];
+            while (true) {
+                const t_size_type z = fronts[thread_idx].fetch_add(1u);
+                if (z >= hi) {
                     break;
                 }
+                if (zone_consume(z)) {
+                    ++stats.first;
+                }
+            }
+            // Then we steal from the other threads.
+            for (unsigned k = 1u; k < this->m_n_threads; ++k) {
+                const unsigned victim = (thread_idx + k) % this->m_n_threads;
+                const t_size_type v_lo = range_start[victim], v_hi = range_start[victim + 1u];
+                while (true) {
+                    const t_size_type old = backs[victim].fetch_sub(1u);
+                    // NOTE: if the back wrapped around, old will be greater than v_hi.
+                    if (old <= v_lo || old > v_hi) {
+                        break;
+                    }
+                    if (zone_consume(static_cast<t_size_type>(old - 1u))) {
+                        ++stats.second;
+                    }
+                }
             }
         };
         // Go with the multiplication threads.
@@ -3362,6 +5040,9 @@ private:
             throw;
         }
     }
+
+private:
+    mutable zone_stats_type m_zone_stats;
 };
 }
 
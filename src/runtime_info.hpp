@@ -46,6 +46,7 @@ extern "C" {
 extern "C" {
 #include <sys/sysctl.h>
 #include <sys/types.h>
+#include <unistd.h>
 }
 #include <cstddef>
 
@@ -70,7 +71,10 @@ extern "C" {
 #endif
 
 #include <memory>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "config.hpp"
 #include "exceptions.hpp"
@@ -80,6 +84,54 @@ extern "C" {
 namespace piranha
 {
 
+inline namespace impl
+{
+
+// Parse a list of indices in the format used by the Linux kernel (e.g., "0-3,8,10-11"). The first element of the
+// returned pair is false in case of errors.
+inline std::pair<bool, std::vector<unsigned>> parse_index_list(const std::string &str)
+{
+    std::pair<bool, std::vector<unsigned>> retval{true, {}};
+    auto to_unsigned = [](const std::string &s, unsigned &out) {
+        if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+        try {
+            out = static_cast<unsigned>(std::stoul(s));
+        } catch (...) {
+            return false;
+        }
+        return true;
+    };
+    std::string::size_type start = 0u;
+    while (start < str.size()) {
+        auto end = str.find(',', start);
+        if (end == std::string::npos) {
+            end = str.size();
+        }
+        const auto item = str.substr(start, end - start);
+        const auto dash = item.find('-');
+        unsigned a, b;
+        if (dash == std::string::npos) {
+            if (!to_unsigned(item, a)) {
+                return {false, {}};
+            }
+            b = a;
+        } else if (!to_unsigned(item.substr(0u, dash), a) || !to_unsigned(item.substr(dash + 1u), b) || b < a) {
+            return {false, {}};
+        }
+        for (auto i = a; i <= b; ++i) {
+            retval.second.push_back(i);
+            if (i == b) {
+                break;
+            }
+        }
+        start = end + 1u;
+    }
+    return retval;
+}
+}
+
 /// Runtime information.
 /**
  * This class allows to query information about the runtime environment.
@@ -213,6 +265,140 @@ public:
         return 0u;
 #endif
     }
+    /// Size of a data cache.
+    /**
+     * @param level the cache level (1 for the L1 cache, 2 for the L2 cache, etc.).
+     *
+     * @return the size (in bytes) of the data (or unified) cache of level \p level of the first CPU,
+     * or 0 if the value cannot be determined.
+     */
+    static unsigned long get_cache_size(unsigned level)
+    {
+#if defined(__linux__)
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+        const long cs = (level == 1u) ? ::sysconf(_SC_LEVEL1_DCACHE_SIZE) : (level == 2u)
+                                                                                 ? ::sysconf(_SC_LEVEL2_CACHE_SIZE)
+                                                                                 : (level == 3u)
+                                                                                       ? ::sysconf(_SC_LEVEL3_CACHE_SIZE)
+                                                                                       : 0;
+        if (cs > 0) {
+            return static_cast<unsigned long>(cs);
+        }
+#endif
+        // This can fail on some systems, resort to the /sys entries.
+        auto read_line = [](const std::string &filename) {
+            std::ifstream sys_file(filename);
+            std::string line;
+            if (sys_file.is_open() && sys_file.good()) {
+                std::getline(sys_file, line);
+            }
+            return line;
+        };
+        try {
+            for (unsigned i = 0u; i < 16u; ++i) {
+                const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(i) + "/";
+                const auto l = read_line(dir + "level");
+                if (l.empty()) {
+                    break;
+                }
+                if (boost::lexical_cast<unsigned>(l) != level || read_line(dir + "type") == "Instruction") {
+                    continue;
+                }
+                // The size is in the format "32K".
+                auto size = read_line(dir + "size");
+                unsigned long mult = 1u;
+                if (!size.empty() && (size.back() == 'K' || size.back() == 'M')) {
+                    mult = (size.back() == 'K') ? 1024ul : 1024ul * 1024ul;
+                    size.pop_back();
+                }
+                return boost::lexical_cast<unsigned long>(size) * mult;
+            }
+        } catch (...) {
+        }
+        return 0u;
+#elif defined(__APPLE_CC__)
+        const char *name = (level == 1u) ? "hw.l1dcachesize" : (level == 2u) ? "hw.l2cachesize"
+                                                                              : (level == 3u) ? "hw.l3cachesize" : nullptr;
+        if (name == nullptr) {
+            return 0u;
+        }
+        std::size_t cs, size = sizeof(cs);
+        try {
+            return ::sysctlbyname(name, &cs, &size, NULL, 0) ? 0u : safe_cast<unsigned long>(cs);
+        } catch (...) {
+            return 0u;
+        }
+#else
+        // TODO: Windows, FreeBSD, etc.?
+        (void)level;
+        return 0u;
+#endif
+    }
+    /// Size of a memory page.
+    /**
+     * @return the size (in bytes) of a memory page, or 0 if the value cannot be determined.
+     */
+    static unsigned get_page_size()
+    {
+#if defined(__linux__) || defined(__APPLE_CC__) || defined(__FreeBSD__)
+        try {
+            const auto ps = ::sysconf(_SC_PAGESIZE);
+            return (ps > 0) ? safe_cast<unsigned>(ps) : 0u;
+        } catch (...) {
+            return 0u;
+        }
+#elif defined(_WIN32)
+        ::SYSTEM_INFO info = ::SYSTEM_INFO();
+        ::GetSystemInfo(&info);
+        try {
+            return safe_cast<unsigned>(info.dwPageSize);
+        } catch (...) {
+            return 0u;
+        }
+#else
+        return 0u;
+#endif
+    }
+    /// NUMA topology.
+    /**
+     * The NUMA topology is returned as a vector of NUMA nodes, listed in ascending order of their system identifiers.
+     * Each node is represented by the sorted list of the indices of the logical CPUs belonging to it (the list can be
+     * empty for nodes providing only memory).
+     *
+     * The topology is currently detected only on Linux, via the \p sysfs filesystem.
+     *
+     * @return the NUMA topology, or an empty vector if the topology cannot be determined.
+     *
+     * @throws unspecified any exception thrown by memory errors in standard containers.
+     */
+    static std::vector<std::vector<unsigned>> get_numa_topology()
+    {
+        std::vector<std::vector<unsigned>> retval;
+#if defined(__linux__)
+        // Read the first line of a sysfs file and parse it as a list of indices.
+        auto read_list = [](const std::string &filename) {
+            std::ifstream sys_file(filename);
+            if (!sys_file.is_open() || !sys_file.good()) {
+                return std::make_pair(false, std::vector<unsigned>{});
+            }
+            std::string line;
+            std::getline(sys_file, line);
+            return parse_index_list(line);
+        };
+        const auto nodes = read_list("/sys/devices/system/node/online");
+        if (!nodes.first) {
+            return retval;
+        }
+        for (const auto &n : nodes.second) {
+            auto cpus = read_list("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+            if (!cpus.first) {
+                return std::vector<std::vector<unsigned>>{};
+            }
+            retval.push_back(std::move(cpus.second));
+        }
+#endif
+        return retval;
+    }
 };
 }
 
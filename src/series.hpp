@@ -63,6 +63,7 @@ see https://www.gnu.org/licenses/. */
 #include "detail/series_fwd.hpp"
 #include "detail/sfinae_types.hpp"
 #include "exceptions.hpp"
+#include "frozen_term_view.hpp"
 #include "hash_set.hpp"
 #include "invert.hpp"
 #include "is_cf.hpp"
@@ -1266,6 +1267,10 @@ public:
  * - \p Derived must derive from piranha::series of \p Cf, \p Key and \p Derived.
  * - \p Derived must satisfy piranha::is_series.
  * - \p Derived must satisfy piranha::is_container_element.
+ * - \p Container must be either piranha::hash_set (the default) or piranha::flat_hash_set.
+ *
+ * The \p Container template is used to store the terms of the series. piranha::flat_hash_set is an open-addressing
+ * table which can speed up term lookups, at the price of running the series multiplication in a single thread.
  *
  * ## Exception safety guarantee ##
  *
@@ -1285,16 +1290,21 @@ public:
 * - test with mock_cfs that are not addable to scalars.
 * - the unary + and - operators should probably follow the type promotion rules for consistency.
 */
-template <typename Cf, typename Key, typename Derived>
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container>
 class series : detail::series_tag, series_operators
 {
 public:
     /// Alias for term type.
     typedef term<Cf, Key> term_type;
+    /// Alias for the frozen view type.
+    /**
+     * See series::frozen_view().
+     */
+    using frozen_view_type = frozen_term_view<Cf, Key>;
 
 private:
     // Make friend with all series.
-    template <typename, typename, typename>
+    template <typename, typename, typename, template <typename, typename, typename> class>
     friend class series;
     // Make friend with debugging class.
     template <typename>
@@ -1307,7 +1317,7 @@ private:
 
 protected:
     /// Container type for terms.
-    using container_type = hash_set<term_type, detail::term_hasher<term_type>>;
+    using container_type = Container<term_type, detail::term_hasher<term_type>, std::equal_to<term_type>>;
 
 private:
 #if !defined(PIRANHA_DOXYGEN_INVOKED)
@@ -1422,13 +1432,15 @@ private:
     template <bool Sign, typename T>
     void merge_terms_impl0(T &&s)
     {
+        m_frozen_view.reset();
         // NOTE: here we can take the pointer to series and compare it to this because we know that
         // series derives from the type of this.
         if (unlikely(&s == this)) {
             // If the two series are the same object, we need to make a copy.
             // NOTE: here we are making sure we are doing a real deep copy (as opposed, say, to a move,
             // which could happen if we used std::forward.).
-            merge_terms_impl1<Sign>(series<Cf, Key, Derived>(static_cast<const series<Cf, Key, Derived> &>(s)));
+            merge_terms_impl1<Sign>(
+                series<Cf, Key, Derived, Container>(static_cast<const series<Cf, Key, Derived, Container> &>(s)));
         } else {
             merge_terms_impl1<Sign>(std::forward<T>(s));
         }
@@ -1440,7 +1452,8 @@ private:
         const auto it_f = s.m_container.end();
         try {
             for (auto it = s.m_container.begin(); it != it_f; ++it) {
-                insert<Sign>(*it);
+                // NOTE: the cached view of this was already dropped in merge_terms_impl0().
+                dispatch_insertion<Sign>(*it);
             }
         } catch (...) {
             // In case of any insertion error, zero out this series.
@@ -1486,13 +1499,16 @@ private:
     template <bool Sign, typename T>
     void merge_terms_impl1(T &&s, typename std::enable_if<is_nonconst_rvalue_ref<T &&>::value>::type * = nullptr)
     {
+        // NOTE: the terms of s are going to be moved out, drop its cached view (the cached view of this
+        // was already dropped in merge_terms_impl0()).
+        s.m_frozen_view.reset();
         bool swap = false;
         // Try to steal memory from other.
         swap_for_merge(std::move(m_container), std::move(s.m_container), swap);
         try {
             const auto it_f = s.m_container._m_end();
             for (auto it = s.m_container._m_begin(); it != it_f; ++it) {
-                insert<Sign>(std::move(*it));
+                dispatch_insertion<Sign>(std::move(*it));
             }
             // If we swapped the operands and a negative merge was performed, we need to change
             // the signs of all coefficients.
@@ -1522,7 +1538,8 @@ private:
     template <bool Sign, typename T>
     void merge_terms(T &&s, typename std::enable_if<is_series<typename std::decay<T>::type>::value>::type * = nullptr)
     {
-        static_assert(std::is_base_of<series<Cf, Key, Derived>, typename std::decay<T>::type>::value, "Type error.");
+        static_assert(std::is_base_of<series<Cf, Key, Derived, Container>, typename std::decay<T>::type>::value,
+                      "Type error.");
         merge_terms_impl0<Sign>(std::forward<T>(s));
     }
     // Generic construction
@@ -1594,6 +1611,13 @@ private:
     // Enabler for is_identical.
     template <typename T>
     using is_identical_enabler = typename std::enable_if<is_equality_comparable<T>::value, int>::type;
+    // Type of the product of a range of series: the values in the range must be of type Derived,
+    // and they must be multipliable via math::multiply_all().
+    template <typename Range>
+    using product_value_t = uncvref_t<decltype(*std::begin(std::declval<const Range &>()))>;
+    template <typename Range>
+    using product_type = enable_if_t<std::is_same<detected_t<product_value_t, Range>, Derived>::value,
+                                     decltype(math::multiply_all(std::declval<const Range &>()))>;
     // Iterator utilities.
     typedef boost::transform_iterator<std::function<std::pair<typename term_type::cf_type, Derived>(const term_type &)>,
                                       typename container_type::const_iterator>
@@ -2014,6 +2038,9 @@ public:
     series() = default;
     /// Defaulted copy constructor.
     /**
+     * The terms container is copied via its copy constructor: with piranha::hash_set as container,
+     * the terms of large series are copied in parallel using piranha::thread_pool.
+     *
      * @throws unspecified any exception thrown by the copy constructor of piranha::hash_set.
      */
     series(const series &) = default;
@@ -2178,6 +2205,7 @@ public:
     template <bool Sign, typename T, insert_enabler<T> = 0>
     void insert(T &&term)
     {
+        m_frozen_view.reset();
         dispatch_insertion<Sign>(std::forward<T>(term));
     }
     /// Insert generic term with <tt>Sign = true</tt>.
@@ -2231,6 +2259,7 @@ public:
      */
     void negate()
     {
+        m_frozen_view.reset();
         try {
             const auto it_f = m_container.end();
             for (auto it = m_container.begin(); it != it_f;) {
@@ -2391,6 +2420,26 @@ public:
         std::lock_guard<std::mutex> lock(s_pow_mutex);
         get_pow_cache().clear();
     }
+    /// Product of a range of series.
+    /**
+     * \note
+     * This method is enabled only if the value type of \p Range is the type deriving from piranha::series,
+     * and if piranha::math::multiply_all() can be called on \p r.
+     *
+     * This method is a thin wrapper around piranha::math::multiply_all(), which will multiply the series in \p r
+     * via a product tree built according to the sizes of the operands.
+     *
+     * @param r the input range.
+     *
+     * @return the product of the series in \p r (or a series constructed from 1, if \p r is empty).
+     *
+     * @throws unspecified any exception thrown by piranha::math::multiply_all().
+     */
+    template <typename Range>
+    static product_type<Range> product(const Range &r)
+    {
+        return math::multiply_all(r);
+    }
     /// Partial derivative.
     /**
      * \note
@@ -2628,6 +2677,10 @@ public:
      * of all terms in the series via the product of the evaluations of the coefficient-key pairs in each term.
      * The input dictionary \p dict specifies with which value each symbolic quantity will be evaluated.
      *
+     * If the view returned by frozen_view() is currently cached, the terms will be read from its contiguous arrays
+     * (in the same order as the iteration order of the series). Calling frozen_view() beforehand is thus
+     * beneficial when a series is evaluated repeatedly.
+     *
      * @param dict dictionary of that will be used for evaluation.
      *
      * @return evaluation of the series according to the evaluation dictionary \p dict.
@@ -2668,6 +2721,18 @@ public:
         }
         // Init return value and accumulate it.
         return_type retval = return_type(0);
+        if (m_frozen_view.has_value()) {
+            // If a frozen view is available, run over its contiguous arrays rather than over the buckets.
+            // NOTE: the view is never built here, as for a one-off evaluation the copy of the terms would
+            // cost more than what is saved.
+            const auto &v = frozen_view();
+            const auto &keys = v.keys();
+            const auto &cfs = v.cfs();
+            for (decltype(v.size()) j = 0u; j < v.size(); ++j) {
+                retval += math::evaluate(cfs[j], dict) * keys[j].evaluate(pmap, m_symbol_set);
+            }
+            return retval;
+        }
         for (const auto &t : this->m_container) {
             // NOTE: restore use of multiply_accumulate once we sort out evaluation (enable it if supported).
             retval += math::evaluate(t.m_cf, dict) * t.m_key.evaluate(pmap, m_symbol_set);
@@ -2850,6 +2915,7 @@ public:
         if (unlikely(!empty())) {
             piranha_throw(std::invalid_argument, "cannot set arguments on a non-empty series");
         }
+        m_frozen_view.reset();
         m_symbol_set = args;
     }
     /// Extend symbol set.
@@ -2886,16 +2952,49 @@ public:
         }
         return merge_arguments(new_ss);
     }
+    /// Frozen structure-of-arrays view.
+    /**
+     * This method will return a piranha::frozen_term_view of \p this, i.e., a read-only snapshot of the terms
+     * of the series stored as a contiguous array of keys and a contiguous array of coefficients. The view is built
+     * on the first call (in parallel for large series, depending on piranha::settings::get_n_threads() and
+     * piranha::settings::get_min_work_per_thread()) and cached within \p this: subsequent calls will return
+     * the cached view, until \p this is modified. Copies of a series do not share the cached view. When the view is
+     * cached, evaluate() will use it.
+     *
+     * This method can be called concurrently from multiple threads. The returned reference is invalidated by
+     * any modification of \p this (including any call to the non-const overload of _container()) and by the
+     * destruction of \p this.
+     *
+     * @return a const reference to the frozen view of \p this.
+     *
+     * @throws unspecified any exception thrown by:
+     * - the constructor of piranha::frozen_term_view from series,
+     * - piranha::thread_pool::use_threads(),
+     * - memory allocation errors.
+     */
+    const frozen_view_type &frozen_view() const
+    {
+        return m_frozen_view.get([this]() {
+            const unsigned n_threads
+                = empty() ? 1u : thread_pool::use_threads(integer(size()),
+                                                          integer(settings::get_min_work_per_thread()));
+            return frozen_view_type(*this, n_threads);
+        });
+    }
     /** @name Low-level interface
      * Low-level methods.
      */
     //@{
     /// Get a mutable reference to the container of terms.
     /**
+     * As the container might be modified via the returned reference, this method will drop the view cached
+     * by frozen_view().
+     *
      * @return a reference to the internal container of terms.
      */
     container_type &_container()
     {
+        m_frozen_view.reset();
         return m_container;
     }
     /// Get a const reference to the container of terms.
@@ -2914,17 +3013,19 @@ protected:
     container_type m_container;
 
 private:
+    // Cache for frozen_view().
+    detail::frozen_view_cache<frozen_view_type> m_frozen_view;
     // Custom derivatives machinery.
     static std::mutex s_cp_mutex;
     // Pow cache machinery;
     static std::mutex s_pow_mutex;
 };
 
-template <typename Cf, typename Key, typename Derived>
-std::mutex series<Cf, Key, Derived>::s_cp_mutex;
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container>
+std::mutex series<Cf, Key, Derived, Container>::s_cp_mutex;
 
-template <typename Cf, typename Key, typename Derived>
-std::mutex series<Cf, Key, Derived>::s_pow_mutex;
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container>
+std::mutex series<Cf, Key, Derived, Container>::s_pow_mutex;
 
 /// Specialisation of piranha::print_coefficient_impl for series.
 /**
@@ -3027,6 +3128,60 @@ struct is_zero_impl<Series, typename std::enable_if<is_series<Series>::value>::t
 inline namespace impl
 {
 
+// Enabler for the multiply_accumulate() specialisation for series.
+template <typename Series>
+using series_multiplier_macc_t = decltype(
+    std::declval<const series_multiplier<Series> &>().multiply_accumulate(std::declval<Series &>()));
+
+template <typename Series>
+using series_multiply_accumulate_enabler
+    = enable_if_t<conjunction<is_series<Series>, is_detected<series_multiplier_macc_t, Series>>::value>;
+}
+
+namespace math
+{
+
+/// Specialisation of the piranha::math::multiply_accumulate() functor for piranha::series.
+/**
+ * This specialisation is enabled if \p Series is an instance of piranha::series whose piranha::series_multiplier
+ * provides a <tt>multiply_accumulate()</tt> method, accepting a mutable reference to \p Series. Such a method
+ * accumulates the result of the multiplication into its argument, thus avoiding the creation of a temporary
+ * series for the product.
+ */
+template <typename Series>
+struct multiply_accumulate_impl<Series, series_multiply_accumulate_enabler<Series>> {
+    /// Call operator.
+    /**
+     * If \p y and \p z have the same symbol set, the body of this operator is equivalent to
+     * @code
+     * series_multiplier<Series>(y, z).multiply_accumulate(x);
+     * @endcode
+     * otherwise it is equivalent to
+     * @code
+     * x += y * z;
+     * @endcode
+     *
+     * @param x target value for accumulation.
+     * @param y first argument.
+     * @param z second argument.
+     *
+     * @throws unspecified any exception thrown by the construction of piranha::series_multiplier,
+     * its <tt>multiply_accumulate()</tt> method, or by in-place addition or binary multiplication on the operands.
+     */
+    void operator()(Series &x, const Series &y, const Series &z) const
+    {
+        if (likely(y.get_symbol_set() == z.get_symbol_set())) {
+            series_multiplier<Series>(y, z).multiply_accumulate(x);
+        } else {
+            x += y * z;
+        }
+    }
+};
+}
+
+inline namespace impl
+{
+
 // Enabler for the pow() specialisation for series.
 template <typename Series, typename T>
 using series_pow_member_t = decltype(std::declval<const Series &>().pow(std::declval<const T &>()));
@@ -3112,7 +3267,7 @@ struct series_cf_invert_functor {
 // type.
 // This is used, e.g., in the sin/cos overrides for poisson_series, and it is similar to what it is done for the pow()
 // overrides.
-template <typename Cf, typename Key, typename Derived,
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container,
           typename std::
               enable_if<is_series<Derived>::value
                             && std::is_same<typename Derived::term_type::cf_type,
@@ -3120,14 +3275,14 @@ template <typename Cf, typename Key, typename Derived,
                                                 std::declval<const typename Derived::term_type::cf_type &>()))>::value,
                         int>::type
           = 0>
-inline Derived series_invert_impl(const series<Cf, Key, Derived> &s)
+inline Derived series_invert_impl(const series<Cf, Key, Derived, Container> &s)
 {
     return apply_cf_functor<series_cf_invert_functor, Derived>(s);
 }
 
 // 3. coefficient type supports math::invert() with a result different from the original coefficient type and the series
 // can be rebound to this new type.
-template <typename Cf, typename Key, typename Derived,
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container,
           typename std::
               enable_if<is_series<Derived>::value
                             && !std::is_same<typename Derived::term_type::cf_type,
@@ -3136,7 +3291,7 @@ template <typename Cf, typename Key, typename Derived,
                         int>::type
           = 0>
 inline series_rebind<Derived, decltype(math::invert(std::declval<const typename Derived::term_type::cf_type &>()))>
-series_invert_impl(const series<Cf, Key, Derived> &s)
+series_invert_impl(const series<Cf, Key, Derived, Container> &s)
 {
     using ret_type
         = series_rebind<Derived, decltype(math::invert(std::declval<const typename Derived::term_type::cf_type &>()))>;
@@ -3216,7 +3371,7 @@ struct series_cf_sin_functor {
 // NOTE: this overload and the one below do not conflict with the one above because it takes a series
 // as input argument: when used on a concrete series type, it will have to go through a to-base
 // conversion in order to be selected.
-template <typename Cf, typename Key, typename Derived,
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container,
           typename std::
               enable_if<is_series<Derived>::value
                             && std::is_same<typename Derived::term_type::cf_type,
@@ -3224,14 +3379,14 @@ template <typename Cf, typename Key, typename Derived,
                                                 std::declval<const typename Derived::term_type::cf_type &>()))>::value,
                         int>::type
           = 0>
-inline Derived series_sin_impl(const series<Cf, Key, Derived> &s)
+inline Derived series_sin_impl(const series<Cf, Key, Derived, Container> &s)
 {
     return apply_cf_functor<series_cf_sin_functor, Derived>(s);
 }
 
 // 3. coefficient type supports math::sin() with a result different from the original coefficient type and the series
 // can be rebound to this new type.
-template <typename Cf, typename Key, typename Derived,
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container,
           typename std::
               enable_if<is_series<Derived>::value
                             && !std::is_same<typename Derived::term_type::cf_type,
@@ -3240,7 +3395,7 @@ template <typename Cf, typename Key, typename Derived,
                         int>::type
           = 0>
 inline series_rebind<Derived, decltype(math::sin(std::declval<const typename Derived::term_type::cf_type &>()))>
-series_sin_impl(const series<Cf, Key, Derived> &s)
+series_sin_impl(const series<Cf, Key, Derived, Container> &s)
 {
     using ret_type
         = series_rebind<Derived, decltype(math::sin(std::declval<const typename Derived::term_type::cf_type &>()))>;
@@ -3279,7 +3434,7 @@ struct series_cf_cos_functor {
     static constexpr const char *name = "cosine";
 };
 
-template <typename Cf, typename Key, typename Derived,
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container,
           typename std::
               enable_if<is_series<Derived>::value
                             && std::is_same<typename Derived::term_type::cf_type,
@@ -3287,12 +3442,12 @@ template <typename Cf, typename Key, typename Derived,
                                                 std::declval<const typename Derived::term_type::cf_type &>()))>::value,
                         int>::type
           = 0>
-inline Derived series_cos_impl(const series<Cf, Key, Derived> &s)
+inline Derived series_cos_impl(const series<Cf, Key, Derived, Container> &s)
 {
     return apply_cf_functor<series_cf_cos_functor, Derived>(s);
 }
 
-template <typename Cf, typename Key, typename Derived,
+template <typename Cf, typename Key, typename Derived, template <typename, typename, typename> class Container,
           typename std::
               enable_if<is_series<Derived>::value
                             && !std::is_same<typename Derived::term_type::cf_type,
@@ -3301,7 +3456,7 @@ template <typename Cf, typename Key, typename Derived,
                         int>::type
           = 0>
 inline series_rebind<Derived, decltype(math::cos(std::declval<const typename Derived::term_type::cf_type &>()))>
-series_cos_impl(const series<Cf, Key, Derived> &s)
+series_cos_impl(const series<Cf, Key, Derived, Container> &s)
 {
     using ret_type
         = series_rebind<Derived, decltype(math::cos(std::declval<const typename Derived::term_type::cf_type &>()))>;
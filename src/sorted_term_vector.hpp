@@ -0,0 +1,527 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_SORTED_TERM_VECTOR_HPP
+#define PIRANHA_SORTED_TERM_VECTOR_HPP
+
+#include <algorithm>
+#include <boost/numeric/conversion/cast.hpp>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "detail/parallel_radix_sort.hpp"
+#include "detail/parallel_run.hpp"
+#include "exceptions.hpp"
+#include "flat_hash_set.hpp"
+#include "is_cf.hpp"
+#include "is_key.hpp"
+#include "math.hpp"
+#include "series.hpp"
+#include "symbol_set.hpp"
+#include "term.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+/// Sorted vector of terms.
+/**
+ * This class stores a set of terms with coefficient type \p Cf and key type \p Key in a contiguous vector, sorted in
+ * ascending order according to the <tt>operator<()</tt> of \p Key. It represents the same mathematical object as a
+ * series whose terms are those stored in the vector (i.e., the terms are unique, compatible with the reference
+ * piranha::symbol_set and not ignorable), and it can be constructed from, and converted back to, a piranha::series.
+ * Both conversions can be performed in parallel.
+ *
+ * With respect to the hash-based storage of piranha::series, the sorted representation allows to:
+ * - locate the leading term (i.e., the term with the greatest key) in constant time,
+ * - look up a term in logarithmic time,
+ * - add and subtract via a linear-time merge, which moreover leaves untouched all the terms whose keys are less than
+ *   the smallest key of the other operand.
+ *
+ * This makes the class suitable for workloads dominated by repeated additions and leading term extractions, such as
+ * polynomial division.
+ *
+ * ## Type requirements ##
+ *
+ * - \p Cf must satisfy piranha::is_cf and it must be addable and subtractable in-place,
+ * - \p Key must satisfy piranha::is_key and piranha::is_less_than_comparable.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations apart from add() and sub(), which
+ * provide the basic guarantee.
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object in an unspecified but valid state.
+ */
+template <typename Cf, typename Key>
+class sorted_term_vector
+{
+    PIRANHA_TT_CHECK(is_cf, Cf);
+    PIRANHA_TT_CHECK(is_key, Key);
+    PIRANHA_TT_CHECK(is_less_than_comparable, Key);
+
+public:
+    /// Alias for the term type.
+    using term_type = term<Cf, Key>;
+    /// Alias for the coefficient type.
+    using cf_type = Cf;
+    /// Alias for the key type.
+    using key_type = Key;
+    /// Container type.
+    using container_type = std::vector<term_type>;
+    /// Size type.
+    using size_type = typename container_type::size_type;
+    /// Const iterator type.
+    using const_iterator = typename container_type::const_iterator;
+
+private:
+    // Enabler for the conversions from/to series.
+    template <typename Series>
+    using series_enabler = typename std::enable_if<
+        is_series<Series>::value && std::is_same<typename Series::term_type, term_type>::value, int>::type;
+    static bool key_less(const term_type &t1, const term_type &t2)
+    {
+        return t1.m_key < t2.m_key;
+    }
+    static void check_n_threads(unsigned n_threads)
+    {
+        if (unlikely(n_threads == 0u)) {
+            piranha_throw(std::invalid_argument, "the number of threads must be strictly positive");
+        }
+    }
+    // Merge the consecutive sorted runs of v delimited by bounds (which contains the beginning
+    // of each run plus the size of v), merging adjacent pairs of runs in parallel.
+    static void merge_runs(container_type &v, std::vector<size_type> bounds, unsigned n_threads)
+    {
+        piranha_assert(bounds.size() >= 2u && bounds.front() == 0u && bounds.back() == v.size());
+        while (bounds.size() > 2u) {
+            const auto n_pairs = static_cast<size_type>((bounds.size() - 1u) / 2u);
+            const auto nt = static_cast<unsigned>(std::min<size_type>(n_threads, n_pairs));
+            detail::parallel_run(nt, [&v, &bounds, n_pairs, nt](unsigned i) {
+                for (size_type p = i; p < n_pairs; p += nt) {
+                    std::inplace_merge(v.begin() + static_cast<std::ptrdiff_t>(bounds[2u * p]),
+                                       v.begin() + static_cast<std::ptrdiff_t>(bounds[2u * p + 1u]),
+                                       v.begin() + static_cast<std::ptrdiff_t>(bounds[2u * p + 2u]), key_less);
+                }
+            });
+            std::vector<size_type> new_bounds;
+            for (size_type j = 0u; j < bounds.size(); j += 2u) {
+                new_bounds.push_back(bounds[j]);
+            }
+            if (new_bounds.back() != bounds.back()) {
+                new_bounds.push_back(bounds.back());
+            }
+            bounds = std::move(new_bounds);
+        }
+    }
+    // Sort the terms in v, accumulate the terms with equal keys and drop the ignorable terms.
+    void canonicalise(container_type &v, unsigned n_threads) const
+    {
+        // NOTE: typical inputs (e.g., the products of a term by a sorted vector) are already sorted.
+        if (!std::is_sorted(v.begin(), v.end(), key_less)) {
+            n_threads = static_cast<unsigned>(std::min<size_type>(n_threads, std::max<size_type>(1u, v.size())));
+            std::vector<size_type> bounds;
+            for (unsigned i = 0u; i < n_threads; ++i) {
+                bounds.push_back(detail::parallel_chunk(v.size(), n_threads, i).first);
+            }
+            bounds.push_back(v.size());
+            detail::parallel_run(n_threads, [&v, &bounds](unsigned i) {
+                std::sort(v.begin() + static_cast<std::ptrdiff_t>(bounds[i]),
+                          v.begin() + static_cast<std::ptrdiff_t>(bounds[i + 1u]), key_less);
+            });
+            merge_runs(v, std::move(bounds), n_threads);
+        }
+        size_type w = 0u;
+        for (size_type r = 0u; r != v.size();) {
+            if (unlikely(!v[r].is_compatible(m_symbol_set))) {
+                piranha_throw(std::invalid_argument, "cannot construct a sorted_term_vector from a term which is "
+                                                     "incompatible with the reference symbol set");
+            }
+            term_type tmp(std::move(v[r]));
+            for (++r; r != v.size() && v[r].m_key == tmp.m_key; ++r) {
+                tmp.m_cf += v[r].m_cf;
+            }
+            if (!tmp.is_ignorable(m_symbol_set)) {
+                v[w] = std::move(tmp);
+                ++w;
+            }
+        }
+        v.erase(v.begin() + static_cast<std::ptrdiff_t>(w), v.end());
+    }
+    // Merge other into this, adding (Sign == true) or subtracting (Sign == false) the coefficients.
+    template <bool Sign>
+    void merge_impl(const sorted_term_vector &other)
+    {
+        if (unlikely(other.m_symbol_set != m_symbol_set)) {
+            piranha_throw(std::invalid_argument, "cannot add or subtract sorted_term_vector objects with different "
+                                                 "symbol sets");
+        }
+        if (other.empty()) {
+            return;
+        }
+        if (unlikely(&other == this)) {
+            const auto tmp(other);
+            merge_impl<Sign>(tmp);
+            return;
+        }
+        auto new_term = [](const term_type &t) {
+            term_type retval(t);
+            if (!Sign) {
+                math::negate(retval.m_cf);
+            }
+            return retval;
+        };
+        // The terms of this preceding the first term of other are not affected by the merge.
+        const auto pos = std::lower_bound(m_terms.begin(), m_terms.end(), other.m_terms.front(), key_less);
+        const auto pos_idx = static_cast<size_type>(pos - m_terms.begin());
+        try {
+            container_type tail;
+            tail.reserve(static_cast<size_type>(m_terms.end() - pos) + other.size());
+            auto it1 = pos;
+            auto it2 = other.m_terms.begin();
+            while (it1 != m_terms.end() && it2 != other.m_terms.end()) {
+                if (it1->m_key < it2->m_key) {
+                    tail.push_back(std::move(*it1));
+                    ++it1;
+                } else if (it2->m_key < it1->m_key) {
+                    tail.push_back(new_term(*it2));
+                    ++it2;
+                } else {
+                    term_type tmp(std::move(*it1));
+                    if (Sign) {
+                        tmp.m_cf += it2->m_cf;
+                    } else {
+                        tmp.m_cf -= it2->m_cf;
+                    }
+                    if (!tmp.is_ignorable(m_symbol_set)) {
+                        tail.push_back(std::move(tmp));
+                    }
+                    ++it1;
+                    ++it2;
+                }
+            }
+            std::move(it1, m_terms.end(), std::back_inserter(tail));
+            std::transform(it2, other.m_terms.end(), std::back_inserter(tail), new_term);
+            m_terms.erase(pos, m_terms.end());
+            m_terms.insert(m_terms.end(), std::make_move_iterator(tail.begin()), std::make_move_iterator(tail.end()));
+        } catch (...) {
+            // The terms from pos onwards might have been moved-from: drop them.
+            m_terms.erase(m_terms.begin() + static_cast<std::ptrdiff_t>(pos_idx), m_terms.end());
+            throw;
+        }
+    }
+
+public:
+    /// Default constructor.
+    /**
+     * The default constructor will initialise an empty vector with an empty reference symbol set.
+     */
+    sorted_term_vector() = default;
+    /// Defaulted copy constructor.
+    sorted_term_vector(const sorted_term_vector &) = default;
+    /// Defaulted move constructor.
+    sorted_term_vector(sorted_term_vector &&) = default;
+    /// Constructor from symbol set and terms.
+    /**
+     * The terms in \p terms will be sorted (using up to \p n_threads threads from piranha::thread_pool), the
+     * coefficients of the terms with equal keys will be accumulated and the resulting ignorable terms will be
+     * discarded.
+     *
+     * @param args the reference symbol set.
+     * @param terms the terms that will be stored in \p this.
+     * @param n_threads the number of threads to be used for sorting.
+     *
+     * @throws std::invalid_argument if \p n_threads is zero, or if any term in \p terms is not compatible with
+     * \p args.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the comparison and copy/move operations of the terms,
+     * - the in-place addition operator of the coefficient type,
+     * - piranha::thread_pool::enqueue() or piranha::future_list::push_back().
+     */
+    explicit sorted_term_vector(const symbol_set &args, container_type terms, unsigned n_threads = 1u)
+        : m_symbol_set(args)
+    {
+        check_n_threads(n_threads);
+        canonicalise(terms, n_threads);
+        m_terms = std::move(terms);
+    }
+    /// Constructor from series.
+    /**
+     * \note
+     * This constructor is enabled only if \p Series satisfies piranha::is_series and its term type is
+     * sorted_term_vector::term_type.
+     *
+     * The terms of \p s are copied into \p this and sorted. Up to \p n_threads threads from piranha::thread_pool will
+     * be used: each thread copies and sorts the terms in a separate range of buckets of \p s, and the sorted runs
+     * are then merged pairwise in parallel.
+     *
+     * @param s the input series.
+     * @param n_threads the number of threads to be used.
+     *
+     * @throws std::invalid_argument if \p n_threads is zero.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the comparison and copy/move operations of the terms,
+     * - piranha::thread_pool::enqueue() or piranha::future_list::push_back().
+     */
+    template <typename Series, series_enabler<Series> = 0>
+    explicit sorted_term_vector(const Series &s, unsigned n_threads = 1u) : m_symbol_set(s.get_symbol_set())
+    {
+        check_n_threads(n_threads);
+        if (s.empty()) {
+            return;
+        }
+        const auto &c = s._container();
+        using bucket_size_type = typename std::decay<decltype(c)>::type::size_type;
+        const bucket_size_type b_count = c.bucket_count();
+        n_threads = static_cast<unsigned>(std::min<bucket_size_type>(n_threads, b_count));
+        std::vector<container_type> parts(n_threads);
+        detail::parallel_run(n_threads, [&c, &parts, b_count, n_threads](unsigned i) {
+            const auto r = detail::parallel_chunk(b_count, n_threads, i);
+            auto &part = parts[i];
+            for (auto idx = r.first; idx != r.second; ++idx) {
+                const auto &list = c._get_bucket_list(idx);
+                for (const auto &t : list) {
+                    part.push_back(t);
+                }
+            }
+            std::sort(part.begin(), part.end(), key_less);
+        });
+        m_terms.reserve(s.size());
+        std::vector<size_type> bounds{0u};
+        for (auto &part : parts) {
+            if (part.size()) {
+                m_terms.insert(m_terms.end(), std::make_move_iterator(part.begin()),
+                               std::make_move_iterator(part.end()));
+                bounds.push_back(m_terms.size());
+            }
+        }
+        merge_runs(m_terms, std::move(bounds), n_threads);
+        piranha_assert(m_terms.size() == s.size());
+    }
+    /// Defaulted destructor.
+    ~sorted_term_vector() = default;
+    /// Defaulted copy assignment operator.
+    sorted_term_vector &operator=(const sorted_term_vector &) = default;
+    /// Defaulted move assignment operator.
+    sorted_term_vector &operator=(sorted_term_vector &&) = default;
+    /// Convert to series.
+    /**
+     * \note
+     * This method is enabled only if \p Series satisfies piranha::is_series and its term type is
+     * sorted_term_vector::term_type.
+     *
+     * The returned series will have the same symbol set and the same terms as \p this. Up to \p n_threads threads
+     * from piranha::thread_pool will be used: the terms are sorted by destination bucket, and each thread then inserts
+     * the terms belonging to a separate range of buckets. If the terms container of \p Series cannot be filled
+     * concurrently (e.g., piranha::flat_hash_set), the insertion is performed by the calling thread.
+     *
+     * @param n_threads the number of threads to be used.
+     *
+     * @return a series equal to \p this.
+     *
+     * @throws std::invalid_argument if \p n_threads is zero.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the copy constructor of the terms,
+     * - the public and low-level interface of the terms container of \p Series,
+     * - <tt>boost::numeric_cast()</tt>,
+     * - piranha::thread_pool::enqueue() or piranha::future_list::push_back().
+     */
+    template <typename Series, series_enabler<Series> = 0>
+    Series to_series(unsigned n_threads = 1u) const
+    {
+        check_n_threads(n_threads);
+        Series retval;
+        retval.set_symbol_set(m_symbol_set);
+        if (m_terms.empty()) {
+            return retval;
+        }
+        auto &c = retval._container();
+        using c_type = typename std::decay<decltype(c)>::type;
+        using bucket_size_type = typename c_type::size_type;
+        try {
+            c.rehash(boost::numeric_cast<bucket_size_type>(
+                         std::ceil(static_cast<double>(m_terms.size()) / c.max_load_factor())),
+                     n_threads);
+            if (n_threads == 1u || !detail::has_concurrent_buckets<c_type>::value) {
+                for (const auto &t : m_terms) {
+                    c._unique_insert(t, c._bucket(t));
+                }
+            } else {
+                // Pair the index of each term with its destination bucket, and sort by bucket.
+                using idx_pair = std::pair<bucket_size_type, size_type>;
+                std::vector<idx_pair> idx(m_terms.size());
+                detail::parallel_run(n_threads, [this, &c, &idx, n_threads](unsigned i) {
+                    const auto r = detail::parallel_chunk(m_terms.size(), n_threads, i);
+                    for (auto j = r.first; j != r.second; ++j) {
+                        idx[j] = std::make_pair(c._bucket(m_terms[j]), j);
+                    }
+                });
+                detail::parallel_radix_sort(n_threads, idx, [](const idx_pair &p) { return p.first; });
+                const bucket_size_type b_count = c.bucket_count();
+                detail::parallel_run(n_threads, [this, &c, &idx, b_count, n_threads](unsigned i) {
+                    const auto r = detail::parallel_chunk(b_count, n_threads, i);
+                    auto cmp = [](const idx_pair &p, const bucket_size_type &b) { return p.first < b; };
+                    auto it = std::lower_bound(idx.begin(), idx.end(), r.first, cmp);
+                    const auto it_f = std::lower_bound(it, idx.end(), r.second, cmp);
+                    for (; it != it_f; ++it) {
+                        c._unique_insert(m_terms[it->second], it->first);
+                    }
+                });
+            }
+            c._update_size(static_cast<bucket_size_type>(m_terms.size()));
+        } catch (...) {
+            c.clear();
+            throw;
+        }
+        return retval;
+    }
+    /// Symbol set getter.
+    /**
+     * @return a const reference to the reference piranha::symbol_set.
+     */
+    const symbol_set &get_symbol_set() const
+    {
+        return m_symbol_set;
+    }
+    /// Number of terms.
+    /**
+     * @return the number of terms stored in \p this.
+     */
+    size_type size() const
+    {
+        return m_terms.size();
+    }
+    /// Empty test.
+    /**
+     * @return \p true if \p this does not contain any term, \p false otherwise.
+     */
+    bool empty() const
+    {
+        return m_terms.empty();
+    }
+    /// Begin iterator.
+    /**
+     * @return an iterator to the term with the smallest key.
+     */
+    const_iterator begin() const
+    {
+        return m_terms.begin();
+    }
+    /// End iterator.
+    /**
+     * @return the end iterator.
+     */
+    const_iterator end() const
+    {
+        return m_terms.end();
+    }
+    /// Find term.
+    /**
+     * The term is located via binary search.
+     *
+     * @param k the key of the term to be searched.
+     *
+     * @return an iterator to the term with key \p k, or end() if no such term exists.
+     *
+     * @throws unspecified any exception thrown by the comparison operators of the key type.
+     */
+    const_iterator find(const key_type &k) const
+    {
+        const auto it = std::lower_bound(m_terms.begin(), m_terms.end(), k,
+                                         [](const term_type &t, const key_type &key) { return t.m_key < key; });
+        return (it != m_terms.end() && it->m_key == k) ? it : m_terms.end();
+    }
+    /// Leading term.
+    /**
+     * @return a const reference to the term with the greatest key.
+     *
+     * @throws std::invalid_argument if \p this is empty.
+     */
+    const term_type &leading_term() const
+    {
+        if (unlikely(m_terms.empty())) {
+            piranha_throw(std::invalid_argument, "cannot extract the leading term of an empty sorted_term_vector");
+        }
+        return m_terms.back();
+    }
+    /// In-place addition.
+    /**
+     * The terms of \p other are merged into \p this, and the terms whose coefficients cancel out are removed. The
+     * complexity is linear in the size of \p other and in the number of terms of \p this whose keys are not less
+     * than the smallest key of \p other.
+     *
+     * In case of errors, the terms of \p this whose keys are not less than the smallest key of \p other are erased.
+     *
+     * @param other the addend.
+     *
+     * @throws std::invalid_argument if the symbol sets of \p this and \p other differ.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the comparison and copy/move operations of the terms,
+     * - the in-place addition operator of the coefficient type.
+     */
+    void add(const sorted_term_vector &other)
+    {
+        merge_impl<true>(other);
+    }
+    /// In-place subtraction.
+    /**
+     * Equivalent to add(), but the coefficients of \p other are subtracted.
+     *
+     * @param other the subtrahend.
+     *
+     * @throws std::invalid_argument if the symbol sets of \p this and \p other differ.
+     * @throws unspecified any exception thrown by:
+     * - memory errors in standard containers,
+     * - the comparison and copy/move operations of the terms,
+     * - the in-place subtraction operator of the coefficient type,
+     * - piranha::math::negate().
+     */
+    void sub(const sorted_term_vector &other)
+    {
+        merge_impl<false>(other);
+    }
+
+private:
+    symbol_set m_symbol_set;
+    container_type m_terms;
+};
+}
+
+#endif
@@ -0,0 +1,276 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#ifndef PIRANHA_SPILLED_SERIES_HPP
+#define PIRANHA_SPILLED_SERIES_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "exceptions.hpp"
+#include "s11n.hpp"
+#include "series.hpp"
+#include "series_multiplier.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+inline namespace impl
+{
+
+// A functor accepting anything, used to detect the availability of the zoned multiplication.
+struct zm_any_functor {
+    template <typename... Args>
+    void operator()(Args &&...) const
+    {
+    }
+};
+
+template <typename Series>
+using series_zoned_multiplication_t = decltype(std::declval<const series_multiplier<Series> &>()._zoned_multiplication(
+    std::declval<const typename Series::size_type &>(), std::declval<const zm_any_functor &>()));
+}
+
+/// Series multiplication spilled to disk.
+/**
+ * This class computes the multiplication of two series and stores the result on disk rather than in memory.
+ * The multiplication is performed via the <tt>_zoned_multiplication()</tt> method of piranha::series_multiplier,
+ * which splits the result into zones containing disjoint sets of terms. Each zone is saved to a separate file as soon
+ * as it is complete, so that the peak memory usage of the multiplication is bounded by the size of the operands
+ * plus a user-defined number of terms per thread, rather than by the size of the whole result.
+ *
+ * The result can then be loaded zone by zone via load() or for_each(), or as a whole via to_series(). The files are
+ * deleted on destruction.
+ *
+ * ## Type requirements ##
+ *
+ * \p Series must satisfy piranha::is_series, and the piranha::series_multiplier of \p Series must provide a
+ * <tt>_zoned_multiplication()</tt> method (as the multiplier of piranha::polynomial with
+ * piranha::kronecker_monomial keys does).
+ *
+ * ## Exception safety guarantee ##
+ *
+ * Unless otherwise specified, this class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * After a move operation, an object of this class contains no zones.
+ */
+template <typename Series>
+class spilled_series
+{
+    PIRANHA_TT_CHECK(is_series, Series);
+    static_assert(is_detected<series_zoned_multiplication_t, Series>::value,
+                  "the series multiplier does not support the zoned multiplication");
+
+public:
+    /// Size type.
+    using size_type = std::vector<std::string>::size_type;
+    /// Constructor.
+    /**
+     * The constructor will compute the product of \p s1 and \p s2, saving each zone of the result to a file
+     * called <tt>prefix.n</tt>, where \p n is the index of the zone, using the data format \p f and the compression
+     * format \p c. Each zone will contain an estimated number of terms not greater than \p max_size.
+     *
+     * If the multiplication of \p Series supports automatic truncation and a truncation is active (e.g., via
+     * piranha::polynomial::set_auto_truncate_degree()), the stored result will be truncated accordingly, as in
+     * the multiplication <tt>s1 * s2</tt>.
+     *
+     * Contrary to the multiplication operator of \p Series, this constructor does not merge the symbol sets of
+     * the operands, which must be identical.
+     *
+     * @param s1 the first operand.
+     * @param s2 the second operand.
+     * @param prefix the prefix of the file names.
+     * @param max_size the maximum estimated number of terms in each zone.
+     * @param f the data format.
+     * @param c the compression format.
+     *
+     * @throws std::invalid_argument if the symbol sets of \p s1 and \p s2 differ.
+     * @throws unspecified any exception thrown by:
+     * - the construction of piranha::series_multiplier and its <tt>_zoned_multiplication()</tt> method,
+     * - piranha::save_file(),
+     * - threading primitives,
+     * - memory errors in standard containers.
+     */
+    explicit spilled_series(const Series &s1, const Series &s2, const std::string &prefix,
+                            const typename Series::size_type &max_size, data_format f = data_format::boost_binary,
+                            compression c = compression::none)
+        : m_format(f), m_compression(c)
+    {
+        std::vector<std::pair<typename Series::size_type, std::string>> zones;
+        std::mutex m;
+        try {
+            series_multiplier<Series> sm(s1, s2);
+            sm._zoned_multiplication(max_size, [&zones, &m, &prefix, f,
+                                                c](const typename Series::size_type &idx, Series &&zone) {
+                std::string filename = prefix + "." + std::to_string(idx);
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    zones.emplace_back(idx, filename);
+                }
+                save_file(zone, filename, f, c);
+            });
+        } catch (...) {
+            for (const auto &p : zones) {
+                std::remove(p.second.c_str());
+            }
+            throw;
+        }
+        std::sort(zones.begin(), zones.end());
+        for (auto &p : zones) {
+            m_files.push_back(std::move(p.second));
+        }
+    }
+    /// Deleted copy constructor.
+    spilled_series(const spilled_series &) = delete;
+    /// Move constructor.
+    /**
+     * @param other the object that will be moved into \p this.
+     */
+    spilled_series(spilled_series &&other) noexcept : m_files(std::move(other.m_files)),
+                                                      m_format(other.m_format),
+                                                      m_compression(other.m_compression)
+    {
+        other.m_files.clear();
+    }
+    /// Deleted copy assignment operator.
+    spilled_series &operator=(const spilled_series &) = delete;
+    /// Move assignment operator.
+    /**
+     * The files of \p this will be deleted before the assignment.
+     *
+     * @param other the assignment argument.
+     *
+     * @return a reference to \p this.
+     */
+    spilled_series &operator=(spilled_series &&other) noexcept
+    {
+        if (likely(this != &other)) {
+            remove_files();
+            m_files = std::move(other.m_files);
+            other.m_files.clear();
+            m_format = other.m_format;
+            m_compression = other.m_compression;
+        }
+        return *this;
+    }
+    /// Destructor.
+    /**
+     * The destructor will delete the files storing the zones.
+     */
+    ~spilled_series()
+    {
+        remove_files();
+    }
+    /// Number of zones.
+    /**
+     * @return the number of non-empty zones in the result of the multiplication.
+     */
+    size_type size() const
+    {
+        return m_files.size();
+    }
+    /// Get the file names.
+    /**
+     * @return a const reference to the names of the files storing the zones.
+     */
+    const std::vector<std::string> &get_files() const
+    {
+        return m_files;
+    }
+    /// Load a zone.
+    /**
+     * @param i the index of the zone.
+     *
+     * @return the <tt>i</tt>-th zone of the result of the multiplication.
+     *
+     * @throws std::out_of_range if \p i is not less than size().
+     * @throws unspecified any exception thrown by piranha::load_file().
+     */
+    Series load(const size_type &i) const
+    {
+        if (unlikely(i >= m_files.size())) {
+            piranha_throw(std::out_of_range, "zone index out of range");
+        }
+        Series retval;
+        load_file(retval, m_files[i], m_format, m_compression);
+        return retval;
+    }
+    /// Iterate over the zones.
+    /**
+     * This method will load the zones one at a time, and pass each one of them as an rvalue to \p f.
+     *
+     * @param f the functor that will be invoked on the zones.
+     *
+     * @throws unspecified any exception thrown by load() or by the call operator of \p f.
+     */
+    template <typename F>
+    void for_each(const F &f) const
+    {
+        for (size_type i = 0u; i < m_files.size(); ++i) {
+            f(load(i));
+        }
+    }
+    /// Load the whole result.
+    /**
+     * @return the result of the multiplication.
+     *
+     * @throws unspecified any exception thrown by load() or by the in-place addition operator of \p Series.
+     */
+    Series to_series() const
+    {
+        Series retval;
+        for_each([&retval](Series &&zone) { retval += std::move(zone); });
+        return retval;
+    }
+
+private:
+    void remove_files() noexcept
+    {
+        for (const auto &s : m_files) {
+            std::remove(s.c_str());
+        }
+        m_files.clear();
+    }
+
+private:
+    std::vector<std::string> m_files;
+    data_format m_format;
+    compression m_compression;
+};
+}
+
+#endif
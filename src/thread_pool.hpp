@@ -516,6 +516,35 @@ inline void thread_pool_shutdown()
 {
     thread_pool::shutdown();
 }
+
+// Determine the NUMA node hosting each of the first n_threads threads in the pool. The mapping is known only if the
+// threads in the pool are bound to processors (so that the i-th thread runs on the i-th logical CPU) and if they
+// span more than one NUMA node. Otherwise, an empty vector is returned.
+inline std::vector<unsigned> thread_pool_numa_nodes(unsigned n_threads)
+{
+    // NOTE: the topology of the machine is not going to change during the execution of the program,
+    // detect it only once.
+    static const std::vector<std::vector<unsigned>> topology = runtime_info::get_numa_topology();
+    std::vector<unsigned> retval;
+    if (topology.size() < 2u || !thread_pool::get_binding()) {
+        return retval;
+    }
+    for (unsigned i = 0u; i < n_threads; ++i) {
+        const auto it = std::find_if(topology.begin(), topology.end(), [i](const std::vector<unsigned> &cpus) {
+            return std::binary_search(cpus.begin(), cpus.end(), i);
+        });
+        if (it == topology.end()) {
+            // Unknown CPU, give up.
+            return std::vector<unsigned>{};
+        }
+        retval.push_back(static_cast<unsigned>(it - topology.begin()));
+    }
+    if (std::adjacent_find(retval.begin(), retval.end(), std::not_equal_to<unsigned>()) == retval.end()) {
+        // All the threads run on the same node.
+        return std::vector<unsigned>{};
+    }
+    return retval;
+}
 }
 
 /// Class to store a list of futures.
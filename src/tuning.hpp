@@ -30,7 +30,15 @@ see https://www.gnu.org/licenses/. */
 #define PIRANHA_TUNING_HPP
 
 #include <atomic>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <map>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 #include "config.hpp"
 #include "exceptions.hpp"
@@ -47,6 +55,10 @@ struct base_tuning {
     static std::atomic<bool> s_parallel_memory_set;
     static std::atomic<unsigned long> s_mult_block_size;
     static std::atomic<unsigned long> s_estimate_threshold;
+    static std::atomic<unsigned long> s_mult_zone_multiplier;
+    // Block sizes for specific term types, indexed by type name.
+    static std::map<std::string, unsigned long> s_type_block_sizes;
+    static std::mutex s_type_block_sizes_mutex;
 };
 
 template <typename T>
@@ -57,6 +69,15 @@ std::atomic<unsigned long> base_tuning<T>::s_mult_block_size(256u);
 
 template <typename T>
 std::atomic<unsigned long> base_tuning<T>::s_estimate_threshold(200u);
+
+template <typename T>
+std::atomic<unsigned long> base_tuning<T>::s_mult_zone_multiplier(10u);
+
+template <typename T>
+std::map<std::string, unsigned long> base_tuning<T>::s_type_block_sizes;
+
+template <typename T>
+std::mutex base_tuning<T>::s_type_block_sizes_mutex;
 }
 
 /// Performance tuning.
@@ -128,9 +149,7 @@ public:
      */
     static void set_multiplication_block_size(unsigned long size)
     {
-        if (unlikely(size < 16u || size > 4096u)) {
-            piranha_throw(std::invalid_argument, "invalid block size");
-        }
+        check_block_size(size);
         s_mult_block_size.store(size);
     }
     /// Reset the multiplication block size.
@@ -143,6 +162,103 @@ public:
     {
         s_mult_block_size.store(256u);
     }
+    /// Get the multiplication block size for a term type.
+    /**
+     * The block size can be customised for each type of term \p T (e.g., via piranha::autotune_multiplication()).
+     * If no block size was set for \p T, the global value returned by
+     * piranha::tuning::get_multiplication_block_size() will be returned.
+     *
+     * @return the block size used in some series multiplication routines for series with terms of type \p T.
+     *
+     * @throws unspecified any exception thrown by threading primitives.
+     */
+    template <typename T>
+    static unsigned long get_multiplication_block_size()
+    {
+        std::lock_guard<std::mutex> lock(s_type_block_sizes_mutex);
+        const auto it = s_type_block_sizes.find(typeid(T).name());
+        return (it == s_type_block_sizes.end()) ? s_mult_block_size.load() : it->second;
+    }
+    /// Set the multiplication block size for a term type.
+    /**
+     * @see piranha::tuning::get_multiplication_block_size() for an explanation of the meaning of this value.
+     *
+     * @param size desired value for the block size of the terms of type \p T.
+     *
+     * @throws std::invalid_argument if \p size is outside an implementation-defined range.
+     * @throws unspecified any exception thrown by threading primitives or by memory errors in standard containers.
+     */
+    template <typename T>
+    static void set_multiplication_block_size(unsigned long size)
+    {
+        check_block_size(size);
+        std::lock_guard<std::mutex> lock(s_type_block_sizes_mutex);
+        s_type_block_sizes[typeid(T).name()] = size;
+    }
+    /// Test if a multiplication block size was set for a term type.
+    /**
+     * @return \p true if a block size specific to the terms of type \p T was set (and not reset afterwards),
+     * \p false if the global block size is used for \p T.
+     *
+     * @throws unspecified any exception thrown by threading primitives.
+     */
+    template <typename T>
+    static bool has_multiplication_block_size()
+    {
+        std::lock_guard<std::mutex> lock(s_type_block_sizes_mutex);
+        return s_type_block_sizes.find(typeid(T).name()) != s_type_block_sizes.end();
+    }
+    /// Reset the multiplication block size for a term type.
+    /**
+     * After this call, the block size for terms of type \p T will be the global one.
+     *
+     * @throws unspecified any exception thrown by threading primitives.
+     */
+    template <typename T>
+    static void reset_multiplication_block_size()
+    {
+        std::lock_guard<std::mutex> lock(s_type_block_sizes_mutex);
+        s_type_block_sizes.erase(typeid(T).name());
+    }
+    /// Get the multiplication zone multiplier.
+    /**
+     * In multithreaded mode, some multiplication algorithms (e.g., for polynomials) subdivide the output
+     * of the multiplication in a number of zones equal to the number of threads times this value. The zones are
+     * the units of work that are distributed among the threads.
+     *
+     * Larger values allow for a better load balancing among the threads, but they increase the overhead.
+     *
+     * The default value of this flag is 10.
+     *
+     * @return the multiplication zone multiplier.
+     */
+    static unsigned long get_multiplication_zone_multiplier()
+    {
+        return s_mult_zone_multiplier.load();
+    }
+    /// Set the multiplication zone multiplier.
+    /**
+     * @see piranha::tuning::get_multiplication_zone_multiplier() for an explanation of the meaning of this value.
+     *
+     * @param zm desired value for the zone multiplier.
+     *
+     * @throws std::invalid_argument if \p zm is outside an implementation-defined range.
+     */
+    static void set_multiplication_zone_multiplier(unsigned long zm)
+    {
+        check_zone_multiplier(zm);
+        s_mult_zone_multiplier.store(zm);
+    }
+    /// Reset the multiplication zone multiplier.
+    /**
+     * This method will reset the multiplication zone multiplier to its default value.
+     *
+     * @see piranha::tuning::get_multiplication_zone_multiplier() for an explanation of the meaning of this value.
+     */
+    static void reset_multiplication_zone_multiplier()
+    {
+        s_mult_zone_multiplier.store(10u);
+    }
     /// Get the series estimation threshold.
     /**
      * In series multiplication it can be advantageous to employ a heuristic to estimate the final size
@@ -180,6 +296,128 @@ public:
     {
         s_estimate_threshold.store(200u);
     }
+    /// Save the tuning parameters to file.
+    /**
+     * This method will write the current values of the tuning parameters (including the block sizes
+     * set for specific term types) to the text file \p filename, which can later be read by load_parameters().
+     *
+     * \note
+     * The block sizes set for specific term types are identified in the file via the names of the types as returned by
+     * <tt>typeid().name()</tt>, which are specific to the compiler.
+     *
+     * @param filename the name of the output file.
+     *
+     * @throws std::runtime_error if the file cannot be opened or written.
+     * @throws unspecified any exception thrown by threading primitives, by memory errors in standard containers,
+     * or by \p boost::lexical_cast().
+     */
+    static void save_parameters(const std::string &filename)
+    {
+        std::ofstream ofile(filename, std::ios::out | std::ios::trunc);
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for saving");
+        }
+        ofile << "parallel_memory_set " << (get_parallel_memory_set() ? 1 : 0) << '\n';
+        ofile << "multiplication_block_size " << get_multiplication_block_size() << '\n';
+        ofile << "multiplication_zone_multiplier " << get_multiplication_zone_multiplier() << '\n';
+        ofile << "estimate_threshold " << get_estimate_threshold() << '\n';
+        {
+            std::lock_guard<std::mutex> lock(s_type_block_sizes_mutex);
+            for (const auto &p : s_type_block_sizes) {
+                ofile << "multiplication_block_size[" << p.first << "] " << p.second << '\n';
+            }
+        }
+        if (unlikely(!ofile.good())) {
+            piranha_throw(std::runtime_error, "error while writing to file '" + filename + "'");
+        }
+    }
+    /// Load the tuning parameters from file.
+    /**
+     * This method will set the tuning parameters to the values stored in the file \p filename
+     * by save_parameters(). The parameters not present in the file are not modified. The file is validated
+     * before any parameter is changed.
+     *
+     * @param filename the name of the input file.
+     *
+     * @throws std::runtime_error if the file cannot be opened.
+     * @throws std::invalid_argument if the content of the file is not valid.
+     * @throws unspecified any exception thrown by threading primitives or by memory errors in standard containers.
+     */
+    static void load_parameters(const std::string &filename)
+    {
+        std::ifstream ifile(filename);
+        if (unlikely(!ifile.good())) {
+            piranha_throw(std::runtime_error, "file '" + filename + "' could not be opened for loading");
+        }
+        // Read and validate the whole file first.
+        std::vector<std::pair<std::string, unsigned long>> params;
+        std::string line;
+        while (std::getline(ifile, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            const auto pos = line.rfind(' ');
+            if (unlikely(pos == std::string::npos || pos == 0u)) {
+                piranha_throw(std::invalid_argument, "invalid line '" + line + "' in tuning file '" + filename + "'");
+            }
+            auto key = line.substr(0u, pos);
+            unsigned long value;
+            try {
+                value = boost::lexical_cast<unsigned long>(line.substr(pos + 1u));
+            } catch (...) {
+                piranha_throw(std::invalid_argument, "invalid value in the line '" + line + "' in tuning file '"
+                                                         + filename + "'");
+            }
+            if (key == "parallel_memory_set") {
+                if (unlikely(value > 1u)) {
+                    piranha_throw(std::invalid_argument, "invalid value for the parallel memory set flag");
+                }
+            } else if (key == "multiplication_block_size" || is_type_block_size_key(key)) {
+                check_block_size(value);
+            } else if (key == "multiplication_zone_multiplier") {
+                check_zone_multiplier(value);
+            } else if (key != "estimate_threshold") {
+                piranha_throw(std::invalid_argument, "unknown tuning parameter '" + key + "' in tuning file '"
+                                                         + filename + "'");
+            }
+            params.emplace_back(std::move(key), value);
+        }
+        // Set the parameters.
+        for (const auto &p : params) {
+            if (p.first == "parallel_memory_set") {
+                set_parallel_memory_set(p.second != 0u);
+            } else if (p.first == "multiplication_block_size") {
+                set_multiplication_block_size(p.second);
+            } else if (p.first == "multiplication_zone_multiplier") {
+                set_multiplication_zone_multiplier(p.second);
+            } else if (p.first == "estimate_threshold") {
+                set_estimate_threshold(p.second);
+            } else {
+                std::lock_guard<std::mutex> lock(s_type_block_sizes_mutex);
+                s_type_block_sizes[p.first.substr(26u, p.first.size() - 27u)] = p.second;
+            }
+        }
+    }
+
+private:
+    static void check_block_size(unsigned long size)
+    {
+        if (unlikely(size < 16u || size > 4096u)) {
+            piranha_throw(std::invalid_argument, "invalid block size");
+        }
+    }
+    static void check_zone_multiplier(unsigned long zm)
+    {
+        if (unlikely(zm < 1u || zm > 1000u)) {
+            piranha_throw(std::invalid_argument, "invalid zone multiplier");
+        }
+    }
+    // Keys of the block sizes for specific types in the tuning files, in the form
+    // "multiplication_block_size[<type name>]".
+    static bool is_type_block_size_key(const std::string &key)
+    {
+        return key.size() > 27u && key.compare(0u, 26u, "multiplication_block_size[") == 0 && key.back() == ']';
+    }
 };
 }
 
@@ -0,0 +1,103 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/autotune.hpp"
+
+#define BOOST_TEST_MODULE autotune_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+#include "../src/tuning.hpp"
+
+using namespace piranha;
+
+BOOST_AUTO_TEST_CASE(autotune_block_sizes_test)
+{
+    init();
+    const auto v = autotune_block_sizes<polynomial<integer, k_monomial>::term_type>();
+    BOOST_CHECK(std::is_sorted(v.begin(), v.end()));
+    BOOST_CHECK(std::adjacent_find(v.begin(), v.end()) == v.end());
+    BOOST_CHECK(std::all_of(v.begin(), v.end(), [](unsigned long bs) { return bs >= 16u && bs <= 4096u; }));
+}
+
+BOOST_AUTO_TEST_CASE(autotune_multiplication_test)
+{
+    using p_type = polynomial<integer, k_monomial>;
+    using term_type = p_type::term_type;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    const auto f = math::pow(1 + x + y + z, 6), g = math::pow(1 - x + y - z, 6);
+    const auto cmp = f * g;
+    for (unsigned nt = 1u; nt <= 2u; ++nt) {
+        settings::set_n_threads(nt);
+        BOOST_CHECK_THROW(autotune_multiplication(f, g, 0u), std::invalid_argument);
+        const auto res = autotune_multiplication(f, g, 1u);
+        BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<term_type>(), res.first);
+        BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), res.second);
+        if (nt == 1u) {
+            BOOST_CHECK_EQUAL(res.second, 10u);
+        }
+        // The result of the multiplication does not depend on the tuning.
+        BOOST_CHECK_EQUAL(f * g, cmp);
+        tuning::reset_multiplication_block_size<term_type>();
+        tuning::reset_multiplication_zone_multiplier();
+    }
+    settings::reset_n_threads();
+}
+
+BOOST_AUTO_TEST_CASE(autotune_multiplication_error_test)
+{
+    using p_type = polynomial<integer, monomial<int>>;
+    using term_type = p_type::term_type;
+    p_type x{"x"};
+    // This multiplication overflows the exponent.
+    const auto f = math::pow(x, std::numeric_limits<int>::max());
+    // If no block size was set for the term type, none is left behind by a failed autotuning.
+    BOOST_CHECK(!tuning::has_multiplication_block_size<term_type>());
+    BOOST_CHECK_THROW(autotune_multiplication(f, x, 1u), std::overflow_error);
+    BOOST_CHECK(!tuning::has_multiplication_block_size<term_type>());
+    // Otherwise, the original value is restored.
+    tuning::set_multiplication_block_size<term_type>(64u);
+    tuning::set_multiplication_zone_multiplier(20u);
+    BOOST_CHECK_THROW(autotune_multiplication(f, x, 1u), std::overflow_error);
+    BOOST_CHECK(tuning::has_multiplication_block_size<term_type>());
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<term_type>(), 64u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), 20u);
+    tuning::reset_multiplication_block_size<term_type>();
+    tuning::reset_multiplication_zone_multiplier();
+}
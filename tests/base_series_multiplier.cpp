@@ -158,6 +158,17 @@ struct m_checker : public base_series_multiplier<Series> {
     {
         return base::template estimate_final_series_size<N, MultFunctor>(std::forward<Args>(args)...);
     }
+    template <std::size_t N, typename MultFunctor, typename... Args>
+    typename base::size_estimate estimate_final_series_size_interval(Args &&... args) const
+    {
+        return base::template estimate_final_series_size_interval<N, MultFunctor>(std::forward<Args>(args)...);
+    }
+    // The estimate used to size the result of plain_multiplication().
+    typename Series::size_type plain_estimate_final_series_size() const
+    {
+        return base::template estimate_final_series_size<Series::term_type::key_type::multiply_arity,
+                                                          typename base::template plain_multiplier<false>>();
+    }
     template <typename... Args>
     static void sanitise_series(Args &&... args)
     {
@@ -431,8 +442,11 @@ BOOST_AUTO_TEST_CASE(base_series_multiplier_estimate_final_series_size_test)
             pt x{"x"}, y{"y"};
             auto a = (x + 2 * y + 4), b = (x * x - 2 * y * x - 3 - 4 * y);
             m_checker<pt> m0(a, b);
-            // Here the multiplier functor does nothing, the estimation will exit immediately yielding 1.
-            BOOST_CHECK_EQUAL((m0.estimate_final_series_size<1u, m_functor_0>()), 1u);
+            // Here the multiplier functor does nothing, the estimation will exit immediately yielding 1,
+            // which is then doubled by the safety factor.
+            BOOST_CHECK_EQUAL((m0.estimate_final_series_size_interval<1u, m_functor_0>(l_functor_0{4u}).estimate),
+                              1u);
+            BOOST_CHECK_EQUAL((m0.estimate_final_series_size<1u, m_functor_0>()), 2u);
         }
         // A reduced fateman1 benchmark, just to test a bit more.
         {
@@ -445,6 +459,50 @@ BOOST_AUTO_TEST_CASE(base_series_multiplier_estimate_final_series_size_test)
             auto b = f + 1;
             auto retval = f * b;
             std::cout << "Bucket count vs actual size: " << retval.table_bucket_count() << ',' << retval.size() << '\n';
+            m_checker<pt> m0(f, b);
+            const auto est = m0.estimate_size();
+            std::cout << "Estimated size: " << est.estimate << " [" << est.lower << ',' << est.upper << "]\n";
+            BOOST_CHECK(est.lower <= est.estimate);
+            BOOST_CHECK(est.estimate <= est.upper);
+            // NOTE: the terms of this product are far from equally likely, which biases the estimate
+            // downwards. Just check we are in the right ballpark.
+            BOOST_CHECK(est.estimate >= retval.size() / 2u);
+            BOOST_CHECK(est.estimate <= retval.size() * 2u);
+            // The true size is known: check it against the (conservative) lower bound, and check that the
+            // estimate used to size the result, including the safety factor, is large enough.
+            BOOST_CHECK_EQUAL(retval.size(), 10626u);
+            BOOST_CHECK(est.lower <= retval.size());
+            BOOST_CHECK(est.estimate <= retval.size());
+            const auto sizing_est = m0.plain_estimate_final_series_size();
+            std::cout << "Sizing estimate: " << sizing_est << '\n';
+            BOOST_CHECK(sizing_est >= retval.size());
+            BOOST_CHECK(sizing_est <= 2u * est.estimate);
+            // The table of the result is not overfull.
+            BOOST_CHECK(retval._container().load_factor() <= retval._container().max_load_factor());
+            // The result does not depend on the number of threads.
+            settings::set_n_threads(1u);
+            m_checker<pt> m1(f, b);
+            const auto est1 = m1.estimate_size();
+            BOOST_CHECK_EQUAL(est1.estimate, est.estimate);
+            BOOST_CHECK_EQUAL(est1.lower, est.lower);
+            BOOST_CHECK_EQUAL(est1.upper, est.upper);
+            settings::set_n_threads(nt);
+        }
+        // Estimation of series with no collisions at all.
+        {
+            pt x{"x"}, y{"y"};
+            // NOTE: make sure both operands have the same symbol set.
+            pt a = x + y - x - y, b = a;
+            for (int i = 0; i < 30; ++i) {
+                a += x.pow(i);
+                b += y.pow(i);
+            }
+            m_checker<pt> m0(a, b);
+            const auto est = m0.estimate_size();
+            BOOST_CHECK_EQUAL(est.estimate, 900u);
+            BOOST_CHECK_EQUAL(est.upper, 900u);
+            BOOST_CHECK(est.lower <= 900u);
+            BOOST_CHECK((m0.estimate_final_series_size_interval<1u, m_functor_0>(l_functor_0{0u}).upper == 1u));
         }
     }
     settings::reset_min_work_per_thread();
@@ -515,6 +573,20 @@ BOOST_AUTO_TEST_CASE(base_series_multiplier_sanitise_series_test)
         }
         BOOST_CHECK_THROW(mt::sanitise_series(e, n), std::invalid_argument);
         e._container().clear();
+        // An overfull table is grown.
+        e._container().rehash(4u);
+        for (unsigned i = 0u; i < 100u; ++i) {
+            tmp = term_type{i + 1u, term_type::key_type{int(i)}};
+            e._container()._unique_insert(tmp, e._container()._bucket(tmp));
+        }
+        mt::sanitise_series(e, n);
+        BOOST_CHECK_EQUAL(e.size(), 100u);
+        BOOST_CHECK(e._container().bucket_count() > 4u);
+        BOOST_CHECK(e._container().load_factor() <= e._container().max_load_factor());
+        for (unsigned i = 0u; i < 100u; ++i) {
+            BOOST_CHECK(e._container().find(term_type{1, term_type::key_type{int(i)}}) != e._container().end());
+        }
+        e._container().clear();
     }
     // Reset to the default setup.
     settings::reset_n_threads();
@@ -719,6 +791,13 @@ BOOST_AUTO_TEST_CASE(base_series_multiplier_finalise_test)
             r += 12 * pt{"y"};
             BOOST_CHECK_NO_THROW(m0.finalise_series(r));
             BOOST_CHECK_EQUAL(r, pt{"x"} / 36 + pt{"y"} / 3);
+            // Explicit number of threads.
+            r = pt{"x"};
+            r += pt{"y"} - pt{"y"};
+            BOOST_CHECK_NO_THROW(m0.finalise_series(r, 1u));
+            BOOST_CHECK_EQUAL(r, pt{"x"} / 36);
+            BOOST_CHECK_THROW(m0.finalise_series(r, 0u), std::invalid_argument);
+            BOOST_CHECK_EQUAL(r, pt{"x"} / 36);
         }
     }
     // Reset.
@@ -828,6 +828,54 @@ BOOST_AUTO_TEST_CASE(divisor_multiply_test)
     boost::mpl::for_each<value_types>(multiply_tester());
 }
 
+struct product_tester {
+    template <typename T>
+    void operator()(const T &)
+    {
+        using d_type = divisor<T>;
+        symbol_set v;
+        v.add("x");
+        v.add("y");
+        // Build a few divisors, some of which share terms.
+        std::vector<std::vector<T>> vs = {{T(1), T(-2)}, {T(1), T(1)}, {T(0), T(1)}, {T(3), T(-4)}, {T(1), T(0)}};
+        std::vector<d_type> ds(1u);
+        for (std::size_t i = 0u; i < vs.size(); ++i) {
+            d_type d;
+            for (std::size_t j = i; j < vs.size(); j += 2u) {
+                T exponent(static_cast<T>(j % 3u + 1u));
+                d.insert(vs[j].begin(), vs[j].end(), exponent);
+            }
+            ds.push_back(d);
+            T exponent(2);
+            d.insert(vs[0u].begin(), vs[0u].end(), exponent);
+            ds.push_back(d);
+        }
+        std::array<term<integer, d_type>, 1u> res;
+        term<integer, d_type> t1, t2;
+        for (const auto &a : ds) {
+            for (const auto &b : ds) {
+                t1.m_key = a;
+                t2.m_key = b;
+                d_type::multiply(res, t1, t2, v);
+                const auto &p = res[0u].m_key;
+                BOOST_CHECK_EQUAL(p.hash(), d_type::_product_hash(a, a.hash(), b, b.hash()));
+                BOOST_CHECK(p._is_product(a, b));
+                BOOST_CHECK(p._is_product(b, a));
+                for (const auto &c : ds) {
+                    t2.m_key = c;
+                    d_type::multiply(res, t1, t2, v);
+                    BOOST_CHECK_EQUAL(p._is_product(a, c), p == res[0u].m_key);
+                }
+            }
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(divisor_product_test)
+{
+    boost::mpl::for_each<value_types>(product_tester());
+}
+
 struct trim_identify_tester {
     template <typename T>
     void operator()(const T &)
@@ -52,6 +52,8 @@ see https://www.gnu.org/licenses/. */
 #include "../src/polynomial.hpp"
 #include "../src/pow.hpp"
 #include "../src/real.hpp"
+#include "../src/settings.hpp"
+#include "../src/tuning.hpp"
 #include "../src/type_traits.hpp"
 
 using namespace piranha;
@@ -402,3 +404,29 @@ BOOST_AUTO_TEST_CASE(divisor_series_rational_multiplication_test)
     s_type s1{1 / 2_q}, s2{2 / 3_q};
     BOOST_CHECK_EQUAL(s1 * s2, 1 / 3_q);
 }
+
+BOOST_AUTO_TEST_CASE(divisor_series_multiplier_test)
+{
+    using s_type = divisor_series<polynomial<rational, monomial<short>>, divisor<short>>;
+    s_type x{"x"}, y{"y"}, z{"z"};
+    const auto f = (x * math::invert(x + y) + z / 3 * math::invert(x - y) - y * math::invert(y + 2 * z) + 1).pow(3);
+    const auto g = (math::invert(x + y) - y * math::invert(x + z) + 2 * z * math::invert(x - y) + x).pow(3);
+    // Plain multiplication.
+    tuning::set_estimate_threshold(100000u);
+    const auto cmp = f * g;
+    // The multiplication engine.
+    tuning::set_estimate_threshold(1u);
+    settings::set_min_work_per_thread(1u);
+    // Use a small block size in order to have many rounds of buffering in multi-threaded mode.
+    tuning::set_multiplication_block_size(16u);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        BOOST_CHECK_EQUAL(f * g, cmp);
+        BOOST_CHECK_EQUAL(g * f, cmp);
+        BOOST_CHECK_EQUAL(f * (g - g), 0);
+    }
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+    tuning::reset_multiplication_block_size();
+    tuning::reset_estimate_threshold();
+}
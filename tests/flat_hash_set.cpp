@@ -0,0 +1,534 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/flat_hash_set.hpp"
+
+#define BOOST_TEST_MODULE flat_hash_set_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "../src/base_series_multiplier.hpp"
+#include "../src/config.hpp"
+#include "../src/forwarding.hpp"
+#include "../src/hash_set.hpp"
+#include "../src/init.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/s11n.hpp"
+#include "../src/series.hpp"
+#include "../src/series_multiplier.hpp"
+#include "../src/settings.hpp"
+#include "../src/type_traits.hpp"
+
+static const int ntries = 1000;
+
+using namespace piranha;
+
+static std::mt19937 rng;
+
+using types = std::tuple<int, integer, rational>;
+
+// A hasher mapping everything to a few values, to test collisions.
+struct bad_hasher {
+    std::size_t operator()(int n) const
+    {
+        return static_cast<std::size_t>(n % 3);
+    }
+};
+
+template <typename H>
+static inline bool check_eq(const H &h1, const H &h2)
+{
+    if (h1.size() != h2.size()) {
+        return false;
+    }
+    for (const auto &x : h1) {
+        auto it = h2.find(x);
+        if (it == h2.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct basic_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using h_type = flat_hash_set<T>;
+        BOOST_CHECK(is_container_element<h_type>::value);
+        // Default ctor.
+        h_type h;
+        BOOST_CHECK_EQUAL(h.size(), 0u);
+        BOOST_CHECK_EQUAL(h.bucket_count(), 0u);
+        BOOST_CHECK(h.begin() == h.end());
+        BOOST_CHECK(h.find(T(0)) == h.end());
+        BOOST_CHECK_THROW(h.bucket(T(0)), zero_division_error);
+        // Compare with a hash_set filled with the same values.
+        hash_set<T> hs;
+        std::uniform_int_distribution<int> dist(-1000, 1000);
+        for (int i = 0; i < ntries; ++i) {
+            const T tmp(dist(rng));
+            const auto p1 = h.insert(tmp);
+            const auto p2 = hs.insert(tmp);
+            BOOST_CHECK_EQUAL(p1.second, p2.second);
+            BOOST_CHECK(*p1.first == tmp);
+            BOOST_CHECK(h.load_factor() <= h.max_load_factor());
+        }
+        BOOST_CHECK_EQUAL(h.size(), hs.size());
+        std::size_t count = 0u;
+        for (const auto &x : h) {
+            BOOST_CHECK(hs.find(x) != hs.end());
+            ++count;
+        }
+        BOOST_CHECK_EQUAL(count, h.size());
+        // Copy and move.
+        auto h2(h);
+        BOOST_CHECK(check_eq(h, h2));
+        auto h3(std::move(h2));
+        BOOST_CHECK(check_eq(h, h3));
+        BOOST_CHECK_EQUAL(h2.size(), 0u);
+        BOOST_CHECK_EQUAL(h2.bucket_count(), 0u);
+        h2 = h3;
+        BOOST_CHECK(check_eq(h2, h3));
+        // Erase half of the elements, then re-insert them.
+        std::vector<T> erased;
+        for (auto it = h2.begin(); it != h2.end();) {
+            if (erased.size() < h.size() / 2u) {
+                erased.push_back(*it);
+                it = h2.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        BOOST_CHECK_EQUAL(h2.size(), h.size() - erased.size());
+        for (const auto &x : erased) {
+            BOOST_CHECK(h2.find(x) == h2.end());
+        }
+        for (const auto &x : h2) {
+            BOOST_CHECK(h.find(x) != h.end());
+        }
+        for (const auto &x : erased) {
+            BOOST_CHECK(h2.insert(x).second);
+        }
+        BOOST_CHECK(check_eq(h, h2));
+        // Swap and clear.
+        h_type h4;
+        h4.swap(h2);
+        BOOST_CHECK(check_eq(h, h4));
+        BOOST_CHECK_EQUAL(h2.size(), 0u);
+        h4.clear();
+        BOOST_CHECK_EQUAL(h4.size(), 0u);
+        BOOST_CHECK_EQUAL(h4.bucket_count(), 0u);
+        // Rehash.
+        h4 = h;
+        h4.rehash(h4.bucket_count() * 4u);
+        BOOST_CHECK(check_eq(h, h4));
+        // This must have no effect, as it would exceed the max load factor.
+        const auto old_count = h4.bucket_count();
+        h4.rehash(1u);
+        BOOST_CHECK_EQUAL(h4.bucket_count(), old_count);
+        BOOST_CHECK_THROW(h4.rehash(100u, 0u), std::invalid_argument);
+        // Rehash with multiple threads.
+        settings::set_n_threads(2u);
+        h4.rehash(h4.bucket_count() * 2u, 2u);
+        BOOST_CHECK(check_eq(h, h4));
+        settings::reset_n_threads();
+        // Initializer list.
+        h_type h5{T(1), T(2), T(3), T(1)};
+        BOOST_CHECK_EQUAL(h5.size(), 3u);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_basic_test)
+{
+    init();
+    tuple_for_each(types{}, basic_tester{});
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_collisions_test)
+{
+    // Heavy collisions, with erasures creating tombstones along the probe sequences.
+    flat_hash_set<int, bad_hasher> h;
+    for (int i = 0; i < 300; ++i) {
+        BOOST_CHECK(h.insert(i).second);
+    }
+    BOOST_CHECK_EQUAL(h.size(), 300u);
+    for (int i = 0; i < 300; i += 2) {
+        auto it = h.find(i);
+        BOOST_CHECK(it != h.end());
+        h.erase(it);
+    }
+    BOOST_CHECK_EQUAL(h.size(), 150u);
+    for (int i = 0; i < 300; ++i) {
+        BOOST_CHECK_EQUAL(h.find(i) == h.end(), i % 2 == 0);
+    }
+    for (int i = 0; i < 300; i += 2) {
+        BOOST_CHECK(h.insert(i).second);
+        BOOST_CHECK(!h.insert(i).second);
+    }
+    BOOST_CHECK_EQUAL(h.size(), 300u);
+    // Repeated insertions and erasures must not exhaust the empty slots.
+    for (int n = 0; n < 100; ++n) {
+        for (int i = 0; i < 300; ++i) {
+            h.erase(h.find(i));
+        }
+        BOOST_CHECK(h.empty());
+        for (int i = 0; i < 300; ++i) {
+            BOOST_CHECK(h.insert(i + n).second);
+        }
+        for (int i = 0; i < 300; ++i) {
+            h.erase(h.find(i + n));
+        }
+        for (int i = 0; i < 300; ++i) {
+            BOOST_CHECK(h.insert(i).second);
+        }
+    }
+    BOOST_CHECK_EQUAL(h.size(), 300u);
+    // The tombstones are purged without growing the table.
+    BOOST_CHECK(h.bucket_count() <= 512u);
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_low_level_test)
+{
+    using h_type = flat_hash_set<int>;
+    h_type h(16u);
+    BOOST_CHECK_EQUAL(h.bucket_count(), 16u);
+    BOOST_CHECK_EQUAL(h._bucket_from_hash(17u), 1u);
+    const auto end = h.end();
+    // Insert many more elements than the initial capacity: the table will be grown
+    // by _unique_insert(), while the end iterator stays valid.
+    for (int i = 0; i < 1000; ++i) {
+        BOOST_CHECK(h._find(i, h._bucket(i)) == end);
+        const auto it = h._unique_insert(i, h._bucket(i));
+        BOOST_CHECK_EQUAL(*it, i);
+        BOOST_CHECK(h._find(i, h._bucket(i)) == it);
+    }
+    h._update_size(1000u);
+    BOOST_CHECK(h.bucket_count() > 1000u);
+    BOOST_CHECK(h.load_factor() <= h.max_load_factor());
+    // The buckets contain at most one element each.
+    std::size_t count = 0u;
+    for (h_type::size_type i = 0u; i < h.bucket_count(); ++i) {
+        const auto b = h._get_bucket_list(i);
+        BOOST_CHECK(b.end() - b.begin() <= 1);
+        for (const auto &x : b) {
+            BOOST_CHECK(h.find(x) != h.end());
+            ++count;
+        }
+    }
+    BOOST_CHECK_EQUAL(count, 1000u);
+    // Sparsity.
+    const auto sp = h.evaluate_sparsity();
+    std::size_t n_slots = 0u, n_elements = 0u;
+    for (const auto &p : sp) {
+        n_slots += p.second;
+        n_elements += p.first ? p.second : 0u;
+    }
+    BOOST_CHECK_EQUAL(n_slots, h.bucket_count());
+    BOOST_CHECK_EQUAL(n_elements, 1000u);
+    BOOST_CHECK_EQUAL(sp.find(0u)->second, h.bucket_count() - 1000u);
+    // Low-level erase.
+    for (int i = 0; i < 1000; i += 2) {
+        h._erase(h.find(i));
+    }
+    h._update_size(500u);
+    for (int i = 0; i < 1000; ++i) {
+        BOOST_CHECK_EQUAL(h.find(i) == h.end(), i % 2 == 0);
+    }
+    // Mutable iterators.
+    for (auto it = h._m_begin(); it != h._m_end(); ++it) {
+        BOOST_CHECK(*it % 2 == 1);
+    }
+    // _increase_size().
+    const auto old_count = h.bucket_count();
+    h._increase_size();
+    BOOST_CHECK_EQUAL(h.bucket_count(), old_count * 2u);
+    BOOST_CHECK_EQUAL(h.size(), 500u);
+    for (int i = 1; i < 1000; i += 2) {
+        BOOST_CHECK(h.find(i) != h.end());
+    }
+}
+
+template <typename OArchive, typename IArchive, typename T>
+static inline void boost_roundtrip(const T &x)
+{
+    std::stringstream ss;
+    {
+        OArchive oa(ss);
+        boost_save(oa, x);
+    }
+    T retval;
+    {
+        IArchive ia(ss);
+        boost_load(ia, retval);
+    }
+    BOOST_CHECK(check_eq(x, retval));
+}
+
+struct boost_s11n_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using h_type = flat_hash_set<T>;
+        BOOST_CHECK((has_boost_save<boost::archive::binary_oarchive, h_type>::value));
+        BOOST_CHECK((has_boost_load<boost::archive::binary_iarchive, h_type>::value));
+        using size_type = typename h_type::size_type;
+        std::uniform_int_distribution<size_type> sdist(0, 10);
+        std::uniform_int_distribution<int> vdist(-10, 10);
+        for (int i = 0; i < ntries; ++i) {
+            const auto size = sdist(rng);
+            h_type h;
+            for (size_type j = 0; j < size; ++j) {
+                h.insert(T(vdist(rng)));
+            }
+            boost_roundtrip<boost::archive::binary_oarchive, boost::archive::binary_iarchive>(h);
+            boost_roundtrip<boost::archive::text_oarchive, boost::archive::text_iarchive>(h);
+        }
+        // The archive format is the same as hash_set's.
+        hash_set<T> hs{T(1), T(2), T(3)};
+        std::stringstream ss;
+        {
+            boost::archive::text_oarchive oa(ss);
+            boost_save(oa, hs);
+        }
+        h_type h;
+        {
+            boost::archive::text_iarchive ia(ss);
+            boost_load(ia, h);
+        }
+        BOOST_CHECK_EQUAL(h.size(), 3u);
+        BOOST_CHECK(h.find(T(2)) != h.end());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_boost_s11n_test)
+{
+    tuple_for_each(types{}, boost_s11n_tester{});
+}
+
+#if defined(PIRANHA_WITH_MSGPACK)
+
+struct msgpack_s11n_tester {
+    template <typename T>
+    void operator()(const T &) const
+    {
+        using h_type = flat_hash_set<T>;
+        BOOST_CHECK((has_msgpack_pack<msgpack::sbuffer, h_type>::value));
+        BOOST_CHECK((has_msgpack_convert<h_type>::value));
+        std::uniform_int_distribution<int> sdist(0, 10), vdist(-10, 10);
+        for (auto f : {msgpack_format::portable, msgpack_format::binary}) {
+            for (int i = 0; i < ntries; ++i) {
+                const auto size = sdist(rng);
+                h_type h;
+                for (int j = 0; j < size; ++j) {
+                    h.insert(T(vdist(rng)));
+                }
+                msgpack::sbuffer sbuf;
+                msgpack::packer<msgpack::sbuffer> p(sbuf);
+                msgpack_pack(p, h, f);
+                auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+                h_type retval;
+                msgpack_convert(retval, oh.get(), f);
+                BOOST_CHECK(check_eq(retval, h));
+            }
+        }
+        // Duplicate elements.
+        msgpack::sbuffer sbuf;
+        msgpack::packer<msgpack::sbuffer> p(sbuf);
+        p.pack_array(2);
+        msgpack_pack(p, T(42), msgpack_format::binary);
+        msgpack_pack(p, T(42), msgpack_format::binary);
+        h_type h;
+        auto oh = msgpack::unpack(sbuf.data(), sbuf.size());
+        BOOST_CHECK_EXCEPTION(
+            msgpack_convert(h, oh.get(), msgpack_format::binary), std::invalid_argument,
+            [](const std::invalid_argument &iae) {
+                return boost::contains(iae.what(), "while deserializing a flat_hash_set from a msgpack object "
+                                                   "a duplicate value was encountered");
+            });
+    }
+};
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_msgpack_s11n_test)
+{
+    tuple_for_each(types{}, msgpack_s11n_tester{});
+}
+
+#endif
+
+// Two otherwise identical series types, storing their terms in a hash_set and in a flat_hash_set.
+template <typename Cf, typename Expo>
+class h_series_type : public series<Cf, monomial<Expo>, h_series_type<Cf, Expo>>
+{
+public:
+    template <typename Cf2>
+    using rebind = h_series_type<Cf2, Expo>;
+    typedef series<Cf, monomial<Expo>, h_series_type<Cf, Expo>> base;
+    h_series_type() = default;
+    h_series_type(const h_series_type &) = default;
+    h_series_type(h_series_type &&) = default;
+    explicit h_series_type(const char *name) : base()
+    {
+        typedef typename base::term_type term_type;
+        this->m_symbol_set.add(name);
+        this->insert(term_type(Cf(1), typename term_type::key_type{Expo(1)}));
+    }
+    h_series_type &operator=(const h_series_type &) = default;
+    h_series_type &operator=(h_series_type &&) = default;
+    PIRANHA_FORWARDING_CTOR(h_series_type, base)
+    PIRANHA_FORWARDING_ASSIGNMENT(h_series_type, base)
+};
+
+template <typename Cf, typename Expo>
+class f_series_type : public series<Cf, monomial<Expo>, f_series_type<Cf, Expo>, flat_hash_set>
+{
+public:
+    template <typename Cf2>
+    using rebind = f_series_type<Cf2, Expo>;
+    typedef series<Cf, monomial<Expo>, f_series_type<Cf, Expo>, flat_hash_set> base;
+    f_series_type() = default;
+    f_series_type(const f_series_type &) = default;
+    f_series_type(f_series_type &&) = default;
+    explicit f_series_type(const char *name) : base()
+    {
+        typedef typename base::term_type term_type;
+        this->m_symbol_set.add(name);
+        this->insert(term_type(Cf(1), typename term_type::key_type{Expo(1)}));
+    }
+    f_series_type &operator=(const f_series_type &) = default;
+    f_series_type &operator=(f_series_type &&) = default;
+    PIRANHA_FORWARDING_CTOR(f_series_type, base)
+    PIRANHA_FORWARDING_ASSIGNMENT(f_series_type, base)
+};
+
+namespace piranha
+{
+
+template <typename Cf, typename Expo>
+class series_multiplier<h_series_type<Cf, Expo>, void> : public base_series_multiplier<h_series_type<Cf, Expo>>
+{
+public:
+    using base_series_multiplier<h_series_type<Cf, Expo>>::base_series_multiplier;
+    h_series_type<Cf, Expo> operator()() const
+    {
+        return this->plain_multiplication();
+    }
+};
+
+template <typename Cf, typename Expo>
+class series_multiplier<f_series_type<Cf, Expo>, void> : public base_series_multiplier<f_series_type<Cf, Expo>>
+{
+public:
+    using base_series_multiplier<f_series_type<Cf, Expo>>::base_series_multiplier;
+    unsigned n_threads() const
+    {
+        return this->m_n_threads;
+    }
+    f_series_type<Cf, Expo> operator()() const
+    {
+        return this->plain_multiplication();
+    }
+};
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_series_test)
+{
+    using h_type = h_series_type<integer, int>;
+    using f_type = f_series_type<integer, int>;
+    BOOST_CHECK(is_series<f_type>::value);
+    using f_term_type = f_type::term_type;
+    BOOST_CHECK((std::is_same<decltype(std::declval<const f_type &>()._container()),
+                              const flat_hash_set<f_term_type, detail::term_hasher<f_term_type>> &>::value));
+    h_type hx{"x"}, hy{"y"}, hz{"z"};
+    f_type fx{"x"}, fy{"y"}, fz{"z"};
+    // Check that the two series types produce the same terms.
+    auto check_same = [](const h_type &h, const f_type &f) {
+        BOOST_CHECK_EQUAL(h.size(), f.size());
+        BOOST_CHECK(h.get_symbol_set() == f.get_symbol_set());
+        for (const auto &t : h._container()) {
+            const auto it = f._container().find(f_type::term_type(t.m_cf, t.m_key));
+            BOOST_CHECK(it != f._container().end());
+            if (it != f._container().end()) {
+                BOOST_CHECK_EQUAL(it->m_cf, t.m_cf);
+            }
+        }
+    };
+    check_same(hx + hy - 3 * hz, fx + fy - 3 * fz);
+    // Cancellations during merging.
+    check_same(hx + hy - hx, fx + fy - fx);
+    BOOST_CHECK((fx - fx).empty());
+    auto h1 = hx + hy + hz + 1, h2 = hx - hy + 2 * hz - 3;
+    auto f1 = fx + fy + fz + 1, f2 = fx - fy + 2 * fz - 3;
+    for (int i = 0; i < 4; ++i) {
+        h1 *= h1 + 1;
+        f1 *= f1 + 1;
+    }
+    check_same(h1, f1);
+    check_same(h1 * h2, f1 * f2);
+    check_same(h1 * h1, f1 * f1);
+    // Cancellations during multiplication.
+    check_same((h1 + h2) * (h1 - h2), (f1 + f2) * (f1 - f2));
+    check_same((h1 + h2) * (h1 - h2) - h1 * h1 + h2 * h2, (f1 + f2) * (f1 - f2) - f1 * f1 + f2 * f2);
+    BOOST_CHECK(((f1 + f2) * (f1 - f2) - f1 * f1 + f2 * f2).empty());
+    // The flat table is always filled in a single thread.
+    settings::set_n_threads(4u);
+    settings::set_min_work_per_thread(1u);
+    check_same(h1 * h2, f1 * f2);
+    BOOST_CHECK_EQUAL((series_multiplier<f_type>(f1, f2).n_threads()), 1u);
+    settings::reset_n_threads();
+    settings::reset_min_work_per_thread();
+    // Copy and s11n of the series.
+    const f_type f3(f1);
+    BOOST_CHECK(f3 == f1);
+    std::stringstream ss;
+    {
+        boost::archive::text_oarchive oa(ss);
+        boost_save(oa, f3);
+    }
+    f_type f4;
+    {
+        boost::archive::text_iarchive ia(ss);
+        boost_load(ia, f4);
+    }
+    BOOST_CHECK(f4 == f3);
+}
@@ -0,0 +1,244 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/frozen_term_view.hpp"
+
+#define BOOST_TEST_MODULE frozen_term_view_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/flat_hash_set.hpp"
+#include "../src/forwarding.hpp"
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/series.hpp"
+#include "../src/settings.hpp"
+#include "../src/symbol_set.hpp"
+#include "../src/thread_pool.hpp"
+
+static const int ntries = 100;
+
+using namespace piranha;
+
+static std::mt19937 rng;
+
+// A series type storing its terms in a flat_hash_set.
+template <typename Cf, typename Expo>
+class f_series_type : public series<Cf, monomial<Expo>, f_series_type<Cf, Expo>, flat_hash_set>
+{
+public:
+    template <typename Cf2>
+    using rebind = f_series_type<Cf2, Expo>;
+    typedef series<Cf, monomial<Expo>, f_series_type<Cf, Expo>, flat_hash_set> base;
+    f_series_type() = default;
+    f_series_type(const f_series_type &) = default;
+    f_series_type(f_series_type &&) = default;
+    explicit f_series_type(const char *name) : base()
+    {
+        typedef typename base::term_type term_type;
+        this->m_symbol_set.add(name);
+        this->insert(term_type(Cf(1), typename term_type::key_type{Expo(1)}));
+    }
+    f_series_type &operator=(const f_series_type &) = default;
+    f_series_type &operator=(f_series_type &&) = default;
+    PIRANHA_FORWARDING_CTOR(f_series_type, base)
+    PIRANHA_FORWARDING_ASSIGNMENT(f_series_type, base)
+};
+
+// Random series with up to size terms in the variables x, y and z.
+template <typename S>
+static S random_series(unsigned size)
+{
+    using term_type = typename S::term_type;
+    using cf_type = typename term_type::cf_type;
+    using key_type = typename term_type::key_type;
+    std::uniform_int_distribution<int> edist(0, 20), cdist(-10, 10);
+    S retval;
+    retval.set_symbol_set(symbol_set({symbol{"x"}, symbol{"y"}, symbol{"z"}}));
+    for (unsigned i = 0u; i < size; ++i) {
+        retval.insert(term_type{cf_type(cdist(rng)), key_type{edist(rng), edist(rng), edist(rng)}});
+    }
+    return retval;
+}
+
+// Check that v contains exactly the terms of s.
+template <typename S, typename V>
+static void check_view(const S &s, const V &v)
+{
+    using term_type = typename S::term_type;
+    BOOST_CHECK(v.get_symbol_set() == s.get_symbol_set());
+    BOOST_CHECK_EQUAL(v.size(), s.size());
+    BOOST_CHECK_EQUAL(v.empty(), s.empty());
+    BOOST_CHECK_EQUAL(v.keys().size(), v.cfs().size());
+    S tmp;
+    tmp.set_symbol_set(v.get_symbol_set());
+    for (decltype(v.size()) i = 0u; i < v.size(); ++i) {
+        const auto it = s._container().find(term_type{v.cfs()[i], v.keys()[i]});
+        BOOST_CHECK(it != s._container().end());
+        BOOST_CHECK(it->m_cf == v.cfs()[i]);
+        tmp.insert(term_type{v.cfs()[i], v.keys()[i]});
+    }
+    // No duplicate terms.
+    BOOST_CHECK(tmp == s);
+}
+
+template <typename S>
+static void view_tester()
+{
+    using term_type = typename S::term_type;
+    using view_type = frozen_term_view<typename term_type::cf_type, typename term_type::key_type>;
+    BOOST_CHECK((std::is_same<view_type, typename S::frozen_view_type>::value));
+    settings::set_n_threads(4u);
+    for (int i = 0; i < ntries; ++i) {
+        const auto s = random_series<S>(static_cast<unsigned>(i) * 10u);
+        for (unsigned n_threads = 1u; n_threads <= 4u; ++n_threads) {
+            check_view(s, view_type(s, n_threads));
+        }
+        check_view(s, s.frozen_view());
+    }
+    settings::reset_n_threads();
+    BOOST_CHECK_THROW(view_type(S{}, 0u), std::invalid_argument);
+    BOOST_CHECK(view_type(S{}).empty());
+    BOOST_CHECK(view_type{}.empty());
+    BOOST_CHECK(view_type{}.get_symbol_set() == symbol_set{});
+    BOOST_CHECK(S{}.frozen_view().empty());
+}
+
+BOOST_AUTO_TEST_CASE(frozen_term_view_ctor_test)
+{
+    init();
+    view_tester<polynomial<integer, k_monomial>>();
+    view_tester<polynomial<rational, monomial<int>>>();
+    view_tester<f_series_type<integer, int>>();
+}
+
+template <typename S>
+static void cache_tester()
+{
+    using term_type = typename S::term_type;
+    using cf_type = typename term_type::cf_type;
+    using key_type = typename term_type::key_type;
+    for (int i = 0; i < 10; ++i) {
+        auto s = random_series<S>(100u);
+        // Repeated calls return the cached view.
+        const auto *v = &s.frozen_view();
+        check_view(s, *v);
+        BOOST_CHECK_EQUAL(v, &s.frozen_view());
+        // Copies do not share the cache.
+        auto s2(s);
+        check_view(s2, s2.frozen_view());
+        BOOST_CHECK(&s2.frozen_view() != v);
+        // Modifications drop the cache.
+        s.insert(term_type{cf_type(1), key_type{100, 100, 100}});
+        check_view(s, s.frozen_view());
+        s += s2;
+        check_view(s, s.frozen_view());
+        s.negate();
+        check_view(s, s.frozen_view());
+        // Moving the terms out of a series drops its cache as well.
+        auto s3(s2);
+        s3.frozen_view();
+        s += std::move(s3);
+        check_view(s, s.frozen_view());
+        check_view(s3, s3.frozen_view());
+        s._container().clear();
+        BOOST_CHECK(s.frozen_view().empty());
+        s.set_symbol_set(symbol_set{});
+        BOOST_CHECK(s.frozen_view().get_symbol_set() == symbol_set{});
+        // Assignments.
+        s = s2;
+        check_view(s, s.frozen_view());
+        s2.frozen_view();
+        s = std::move(s2);
+        check_view(s, s.frozen_view());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(frozen_term_view_cache_test)
+{
+    cache_tester<polynomial<integer, k_monomial>>();
+    cache_tester<f_series_type<integer, int>>();
+    // Concurrent access to the cached view.
+    using p_type = polynomial<integer, k_monomial>;
+    using v_type = const p_type::frozen_view_type *;
+    settings::set_n_threads(4u);
+    for (int i = 0; i < 10; ++i) {
+        const auto s = random_series<p_type>(1000u);
+        std::vector<v_type> views(4u, nullptr);
+        future_list<void> f_list;
+        for (unsigned t = 0u; t < 4u; ++t) {
+            f_list.push_back(thread_pool::enqueue(t, [&s, &views, t]() { views[t] = &s.frozen_view(); }));
+        }
+        f_list.wait_all();
+        f_list.get_all();
+        BOOST_CHECK(std::all_of(views.begin(), views.end(), [&views](v_type v) { return v == views[0]; }));
+        check_view(s, *views[0]);
+    }
+    // Parallel build from a large series.
+    settings::set_min_work_per_thread(100u);
+    const auto s = random_series<p_type>(10000u);
+    check_view(s, s.frozen_view());
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
+template <typename S>
+static void evaluate_tester()
+{
+    const std::unordered_map<std::string, integer> dict{{"x", integer(2)}, {"y", integer(-3)}, {"z", integer(5)}};
+    for (int i = 0; i < ntries; ++i) {
+        auto s = random_series<S>(100u);
+        const auto ret = s.evaluate(dict);
+        // Evaluation via the cached view.
+        s.frozen_view();
+        BOOST_CHECK_EQUAL(s.evaluate(dict), ret);
+        // The view is dropped on modification, and the evaluation follows the new terms.
+        s += 1;
+        BOOST_CHECK_EQUAL(s.evaluate(dict), ret + 1);
+        s.frozen_view();
+        BOOST_CHECK_EQUAL(s.evaluate(dict), ret + 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(frozen_term_view_evaluate_test)
+{
+    evaluate_tester<polynomial<integer, k_monomial>>();
+    evaluate_tester<polynomial<rational, monomial<int>>>();
+    evaluate_tester<f_series_type<integer, int>>();
+}
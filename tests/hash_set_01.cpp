@@ -55,6 +55,7 @@ see https://www.gnu.org/licenses/. */
 #include "../src/init.hpp"
 #include "../src/mp_integer.hpp"
 #include "../src/s11n.hpp"
+#include "../src/settings.hpp"
 #include "../src/thread_pool.hpp"
 #include "../src/type_traits.hpp"
 
@@ -685,6 +686,123 @@ BOOST_AUTO_TEST_CASE(hash_set_mt_test)
     }
 }
 
+// A hasher mapping the integers to a few values, so that most items end up in the overflow nodes.
+struct few_hasher {
+    std::size_t operator()(const integer &n) const
+    {
+        return static_cast<std::size_t>(n % 64);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(hash_set_node_pool_test)
+{
+    using h_type = hash_set<integer, few_hasher>;
+    thread_pool::resize(4u);
+    for (int i = 0; i < 10; ++i) {
+        // Concurrent insertion of colliding items in disjoint ranges of buckets.
+        h_type h(64u);
+        BOOST_CHECK_EQUAL(h.bucket_count(), 64u);
+        future_list<void> f_list;
+        for (unsigned t = 0u; t < 4u; ++t) {
+            f_list.push_back(thread_pool::enqueue(t, [&h, t]() {
+                for (int n = 0; n < 2000; ++n) {
+                    // The bucket of the item is in the [16 * t, 16 * (t + 1)[ range.
+                    const integer item(n / 16 * 64 + n % 16 + static_cast<int>(16u * t));
+                    h._unique_insert(item, h._bucket(item));
+                }
+            }));
+        }
+        f_list.wait_all();
+        f_list.get_all();
+        h._update_size(8000u);
+        BOOST_CHECK_EQUAL(h.size(), 8000u);
+        BOOST_CHECK(h.evaluate_sparsity().count(125u) == 1u);
+        // Erase half of the items, and reinsert them so that the freed nodes are reused.
+        for (int n = 0; n < 8000; n += 2) {
+            BOOST_CHECK(h.find(integer(n)) != h.end());
+            h.erase(h.find(integer(n)));
+        }
+        BOOST_CHECK_EQUAL(h.size(), 4000u);
+        for (int n = 0; n < 8000; n += 2) {
+            BOOST_CHECK(h.insert(integer(n)).second);
+        }
+        BOOST_CHECK_EQUAL(h.size(), 8000u);
+        // Copy, move, swap.
+        h_type h2(h);
+        BOOST_CHECK_EQUAL(h2.size(), 8000u);
+        for (int n = 0; n < 8000; ++n) {
+            BOOST_CHECK(h2.find(integer(n)) != h2.end());
+        }
+        h_type h3(std::move(h));
+        BOOST_CHECK_EQUAL(h3.size(), 8000u);
+        BOOST_CHECK(h.empty());
+        h = h3;
+        h2.clear();
+        h2.swap(h3);
+        BOOST_CHECK(h3.empty());
+        BOOST_CHECK_EQUAL(h2.size(), 8000u);
+        BOOST_CHECK_EQUAL(h.size(), 8000u);
+        // Reuse after clear.
+        h3 = std::move(h2);
+        h3.clear();
+        for (int n = 0; n < 1000; ++n) {
+            h3.insert(integer(n));
+        }
+        BOOST_CHECK_EQUAL(h3.size(), 1000u);
+        h3.rehash(2048u);
+        BOOST_CHECK_EQUAL(h3.size(), 1000u);
+        for (int n = 0; n < 1000; ++n) {
+            BOOST_CHECK(h3.find(integer(n)) != h3.end());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hash_set_parallel_bulk_test)
+{
+    using h_type = hash_set<integer>;
+    // Lower the minimum work per thread so that copy, rehash and destruction
+    // go through the thread pool.
+    settings::set_n_threads(4u);
+    settings::set_min_work_per_thread(100u);
+    for (int i = 0; i < 10; ++i) {
+        h_type h;
+        // Insertion with rehashes on growth.
+        for (int n = 0; n < 20000; ++n) {
+            BOOST_CHECK(h.insert(integer(n)).second);
+        }
+        BOOST_CHECK_EQUAL(h.size(), 20000u);
+        for (int n = 0; n < 20000; ++n) {
+            BOOST_CHECK(h.find(integer(n)) != h.end());
+        }
+        // Copy.
+        h_type h2(h);
+        BOOST_CHECK_EQUAL(h2.size(), 20000u);
+        BOOST_CHECK_EQUAL(h2.bucket_count(), h.bucket_count());
+        for (int n = 0; n < 20000; ++n) {
+            BOOST_CHECK(h2.find(integer(n)) != h2.end());
+        }
+        // Explicit rehash, growing and shrinking.
+        for (unsigned n_threads = 1u; n_threads <= 4u; ++n_threads) {
+            h2.rehash(h2.bucket_count() * 2u, n_threads);
+            BOOST_CHECK_EQUAL(h2.size(), 20000u);
+            h2.rehash(h2.bucket_count() / 2u, n_threads);
+            BOOST_CHECK_EQUAL(h2.size(), 20000u);
+            for (int n = 0; n < 20000; n += 7) {
+                BOOST_CHECK(h2.find(integer(n)) != h2.end());
+            }
+        }
+        BOOST_CHECK(h2.find(integer(20000)) == h2.end());
+        // Copy assignment and clear.
+        h2 = h;
+        BOOST_CHECK_EQUAL(h2.size(), 20000u);
+        h.clear();
+        BOOST_CHECK(h.empty());
+        BOOST_CHECK_EQUAL(h.bucket_count(), 0u);
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
 BOOST_AUTO_TEST_CASE(hash_set_serialization_test)
 {
     {
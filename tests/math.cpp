@@ -44,6 +44,7 @@ see https://www.gnu.org/licenses/. */
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <list>
 #include <random>
 #include <stdexcept>
 #include <string>
@@ -252,6 +253,51 @@ BOOST_AUTO_TEST_CASE(math_multiply_accumulate_test)
     BOOST_CHECK(!has_multiply_accumulate<no_fma &>::value);
 }
 
+template <typename T>
+using multiply_all_t = decltype(math::multiply_all(std::declval<const std::vector<T> &>()));
+
+template <typename S, typename Range>
+using series_product_t = decltype(S::product(std::declval<const Range &>()));
+
+BOOST_AUTO_TEST_CASE(math_multiply_all_test)
+{
+    BOOST_CHECK((is_detected<multiply_all_t, int>::value));
+    BOOST_CHECK((is_detected<multiply_all_t, double>::value));
+    BOOST_CHECK((!is_detected<multiply_all_t, no_fma>::value));
+    BOOST_CHECK((!is_detected<multiply_all_t, std::string>::value));
+    BOOST_CHECK_EQUAL(math::multiply_all(std::vector<int>{}), 1);
+    BOOST_CHECK_EQUAL(math::multiply_all(std::vector<int>{7}), 7);
+    BOOST_CHECK_EQUAL(math::multiply_all(std::vector<int>{2, 3, 4, 5}), 120);
+    const std::vector<double> vd{1.5, 2., -4.};
+    BOOST_CHECK_EQUAL(math::multiply_all(vd.begin(), vd.end()), -12.);
+    BOOST_CHECK_EQUAL(math::multiply_all(vd.begin(), vd.begin()), 1.);
+    // Series.
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x{"x"}, y{"y"}, z{"z"};
+    std::vector<p_type> vp{x + 1, (x + y + z + 1).pow(3), y - 1, x * y + z, 1 + x + y + z, x - 2 * z};
+    p_type cmp(1);
+    for (const auto &p : vp) {
+        cmp *= p;
+    }
+    BOOST_CHECK_EQUAL(math::multiply_all(vp), cmp);
+    BOOST_CHECK_EQUAL(math::multiply_all(vp.rbegin(), vp.rend()), cmp);
+    BOOST_CHECK_EQUAL(p_type::product(vp), cmp);
+    // The operands are not modified.
+    BOOST_CHECK_EQUAL(vp[0u], x + 1);
+    BOOST_CHECK_EQUAL(p_type::product(std::vector<p_type>{}), 1);
+    BOOST_CHECK_EQUAL(p_type::product(std::vector<p_type>{x - y}), x - y);
+    BOOST_CHECK((std::is_same<decltype(p_type::product(vp)), p_type>::value));
+    // The range must contain series of the calling type.
+    BOOST_CHECK((is_detected<series_product_t, p_type, std::vector<p_type>>::value));
+    BOOST_CHECK((is_detected<series_product_t, p_type, std::list<p_type>>::value));
+    BOOST_CHECK((!is_detected<series_product_t, p_type, std::vector<int>>::value));
+    BOOST_CHECK((!is_detected<series_product_t, p_type, std::vector<polynomial<double, k_monomial>>>::value));
+    BOOST_CHECK((!is_detected<series_product_t, p_type, int>::value));
+    // Including empty series.
+    vp.push_back(p_type{});
+    BOOST_CHECK_EQUAL(p_type::product(vp), 0);
+}
+
 BOOST_AUTO_TEST_CASE(math_pow_test)
 {
     BOOST_CHECK(math::pow(2., 2.) == std::pow(2., 2.));
@@ -34,6 +34,7 @@ see https://www.gnu.org/licenses/. */
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <iterator>
 #include <limits>
@@ -45,6 +46,7 @@ see https://www.gnu.org/licenses/. */
 
 #include "../src/config.hpp"
 #include "../src/init.hpp"
+#include "../src/runtime_info.hpp"
 #include "../src/settings.hpp"
 
 // Helper to def-init as an array of T the raw storage returned by the memory alloc function.
@@ -220,3 +222,26 @@ BOOST_AUTO_TEST_CASE(memory_parallel_init_destroy_test)
         BOOST_CHECK(std::equal(ptr7.get(), ptr7.get() + small_alloc_size, ptr_cmp.get()));
     }
 }
+
+BOOST_AUTO_TEST_CASE(memory_parallel_range_test)
+{
+    const auto page_size = runtime_info::get_page_size();
+    std::vector<double> v(100000u);
+    for (std::size_t size : {std::size_t(0u), std::size_t(1u), std::size_t(10u), std::size_t(1000u), v.size()}) {
+        for (unsigned n_threads = 1u; n_threads <= 8u; ++n_threads) {
+            const auto wpt = static_cast<std::size_t>(size / n_threads);
+            BOOST_CHECK_EQUAL(detail::parallel_range_begin(v.data(), size, 0u, n_threads), 0u);
+            BOOST_CHECK_EQUAL(detail::parallel_range_begin(v.data(), size, n_threads, n_threads), size);
+            for (unsigned i = 1u; i < n_threads; ++i) {
+                const auto b = detail::parallel_range_begin(v.data(), size, i, n_threads);
+                // The boundaries are ordered and close to the ideal ones.
+                BOOST_CHECK(b >= i * wpt && b <= (i + 1u) * wpt);
+                BOOST_CHECK(b >= detail::parallel_range_begin(v.data(), size, i - 1u, n_threads));
+                // If the ranges span more than one page, the boundaries are on page boundaries.
+                if (page_size && wpt * sizeof(double) >= 2u * page_size && page_size % sizeof(double) == 0u) {
+                    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(v.data() + b) % page_size, 0u);
+                }
+            }
+        }
+    }
+}
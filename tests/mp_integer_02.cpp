@@ -241,6 +241,143 @@ BOOST_AUTO_TEST_CASE(mp_integer_addmul_test)
     boost::mpl::for_each<size_types>(addmul_tester());
 }
 
+struct accumulator_tester {
+    template <typename T>
+    void operator()(const T &)
+    {
+        using int_type = mp_integer<T::value>;
+        using acc_type = detail::mp_integer_accumulator<T::value>;
+        using limb_t = typename detail::integer_union<T::value>::s_storage::limb_t;
+        const auto limb_bits = detail::integer_union<T::value>::s_storage::limb_bits;
+        BOOST_CHECK(acc_type::can_accumulate(1000u));
+        acc_type acc;
+        BOOST_CHECK(acc.is_zero());
+        BOOST_CHECK_EQUAL(acc.get(), 0);
+        // Eligibility.
+        int_type one(1), big(1);
+        big <<= limb_bits;
+        BOOST_CHECK(acc_type::is_eligible(int_type{}));
+        BOOST_CHECK(acc_type::is_eligible(one));
+        BOOST_CHECK(acc_type::is_eligible(-one));
+        BOOST_CHECK(!acc_type::is_eligible(big));
+        BOOST_CHECK(acc_type::is_eligible(big - 1));
+        BOOST_CHECK(acc_type::is_eligible(1 - big));
+        // Random accumulations, including values close to the limb limits in order to have wraparounds,
+        // checked against multiply_accumulate().
+        std::uniform_int_distribution<unsigned> sdist(0u, 3u);
+        const limb_t lmax = std::numeric_limits<limb_t>::max();
+        std::uniform_int_distribution<unsigned long long> ldist(0u, lmax);
+        for (int i = 0; i < ntries / 10; ++i) {
+            acc_type a;
+            int_type cmp;
+            for (int j = 0; j < 50; ++j) {
+                const auto s = sdist(rng);
+                int_type x(s < 2u ? lmax - ldist(rng) % 16u : ldist(rng)), y(s % 2u ? lmax : ldist(rng));
+                BOOST_CHECK(acc_type::is_eligible(x) && acc_type::is_eligible(y));
+                // Skew the signs differently in each run.
+                if (sdist(rng) < 1u + static_cast<unsigned>(i % 3)) {
+                    x.negate();
+                }
+                if (sdist(rng) == 0u) {
+                    y.negate();
+                }
+                a.multiply_accumulate(x, y);
+                cmp.multiply_accumulate(x, y);
+                BOOST_CHECK_EQUAL(a.get(), cmp);
+                BOOST_CHECK_EQUAL(a.is_zero(), cmp.sign() == 0);
+            }
+        }
+        // Back to zero.
+        acc_type a;
+        a.multiply_accumulate(big - 1, big - 1);
+        a.multiply_accumulate(big - 1, big - 1);
+        BOOST_CHECK_EQUAL(a.get(), 2 * (big - 1) * (big - 1));
+        a.multiply_accumulate(1 - big, big - 1);
+        a.multiply_accumulate(big - 1, 1 - big);
+        BOOST_CHECK(a.is_zero());
+        BOOST_CHECK_EQUAL(a.get(), 0);
+        a.multiply_accumulate(-one, big - 1);
+        BOOST_CHECK_EQUAL(a.get(), 1 - big);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(mp_integer_accumulator_test)
+{
+    boost::mpl::for_each<size_types>(accumulator_tester());
+}
+
+#if defined(PIRANHA_UINT128_T)
+
+struct crt_accumulator_tester {
+    template <typename T>
+    void operator()(const T &)
+    {
+        check<T::value, 1u>();
+        check<T::value, 4u>();
+        check<T::value, 16u>();
+    }
+    template <int NBits, std::size_t K>
+    static void check()
+    {
+        using IntType = mp_integer<NBits>;
+        using acc_type = detail::mp_integer_crt_accumulator<NBits, K>;
+        BOOST_CHECK_EQUAL(acc_type::max_bits(), 50u * K - 2u);
+        BOOST_CHECK(acc_type::can_accumulate(1u << 28u));
+        BOOST_CHECK(!acc_type::can_accumulate((1u << 28u) + 1u));
+        acc_type acc;
+        BOOST_CHECK(acc.is_zero());
+        BOOST_CHECK_EQUAL(acc.get(), 0);
+        // Random accumulations of factors of up to max_bits() / 2 - 4 bits, so that the sums of up to 16 products
+        // are within the bounds. Check against multiply_accumulate().
+        const unsigned fbits = acc_type::max_bits() / 2u - 4u;
+        std::uniform_int_distribution<unsigned> bdist(0u, fbits), sdist(0u, 3u);
+        std::uniform_int_distribution<unsigned long long> ldist;
+        auto random_int = [&]() {
+            const auto nbits = bdist(rng);
+            IntType retval;
+            for (unsigned b = 0u; b < nbits; b += 16u) {
+                retval <<= 16;
+                retval += ldist(rng) % (1u << 16u);
+            }
+            retval >>= (nbits + 15u) / 16u * 16u - nbits;
+            if (sdist(rng) == 0u) {
+                retval.negate();
+            }
+            return retval;
+        };
+        for (int i = 0; i < ntries / 10; ++i) {
+            acc_type a;
+            IntType cmp;
+            for (int j = 0; j < 16; ++j) {
+                const auto x = random_int(), y = random_int();
+                a.multiply_accumulate(acc_type::reduce(x), acc_type::reduce(y));
+                cmp.multiply_accumulate(x, y);
+                BOOST_CHECK_EQUAL(a.get(), cmp);
+                BOOST_CHECK_EQUAL(a.is_zero(), cmp.sign() == 0);
+            }
+        }
+        // The extremes of the representable range, and cancellation.
+        IntType max(1);
+        max <<= acc_type::max_bits();
+        max -= 1;
+        acc_type a;
+        a.multiply_accumulate(acc_type::reduce(max), acc_type::reduce(IntType(1)));
+        BOOST_CHECK_EQUAL(a.get(), max);
+        a.multiply_accumulate(acc_type::reduce(-max), acc_type::reduce(IntType(2)));
+        BOOST_CHECK_EQUAL(a.get(), -max);
+        a.multiply_accumulate(acc_type::reduce(max), acc_type::reduce(IntType(1)));
+        BOOST_CHECK(a.is_zero());
+        BOOST_CHECK_EQUAL(a.get(), 0);
+    }
+};
+
+BOOST_AUTO_TEST_CASE(mp_integer_crt_accumulator_test)
+{
+    boost::mpl::for_each<size_types>(crt_accumulator_tester());
+}
+
+#endif
+
 struct in_place_mp_integer_div_tester {
     template <typename T>
     void operator()(const T &)
@@ -0,0 +1,103 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/detail/parallel_radix_sort.hpp"
+
+#define BOOST_TEST_MODULE parallel_radix_sort_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../src/init.hpp"
+#include "../src/settings.hpp"
+
+using namespace piranha;
+using namespace piranha::detail;
+
+static std::mt19937 rng;
+
+BOOST_AUTO_TEST_CASE(prs_test_00)
+{
+    init();
+    std::vector<unsigned> v;
+    BOOST_CHECK_THROW(parallel_radix_sort(0u, v, [](unsigned n) { return n; }), std::invalid_argument);
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        // Empty and small vectors.
+        v.clear();
+        parallel_radix_sort(nt, v, [](unsigned n) { return n; });
+        BOOST_CHECK(v.empty());
+        v = {3u, 1u, 2u};
+        parallel_radix_sort(nt, v, [](unsigned n) { return n; });
+        BOOST_CHECK((v == std::vector<unsigned>{1u, 2u, 3u}));
+        // Large vectors with keys of different widths, compared to std::stable_sort(). The values are pairs
+        // (key, original position), so that stability is checked as well.
+        for (unsigned long max_key : {0ul, 1ul, 255ul, 256ul, 1000ul, 100000ul, 4294967295ul}) {
+            for (std::size_t size : {std::size_t(511u), std::size_t(512u), std::size_t(10000u), std::size_t(100000u)}) {
+                std::uniform_int_distribution<unsigned long> dist(0u, max_key);
+                std::vector<std::pair<unsigned long, std::size_t>> w;
+                for (std::size_t i = 0u; i < size; ++i) {
+                    w.emplace_back(dist(rng), i);
+                }
+                auto cmp = w;
+                std::stable_sort(cmp.begin(), cmp.end(),
+                                 [](const std::pair<unsigned long, std::size_t> &a,
+                                    const std::pair<unsigned long, std::size_t> &b) { return a.first < b.first; });
+                parallel_radix_sort(nt, w, [](const std::pair<unsigned long, std::size_t> &p) { return p.first; });
+                BOOST_CHECK(w == cmp);
+            }
+        }
+        // Small key types.
+        std::vector<unsigned char> vc;
+        std::uniform_int_distribution<unsigned> dist(0u, 255u);
+        for (std::size_t i = 0u; i < 50000u; ++i) {
+            vc.push_back(static_cast<unsigned char>(dist(rng)));
+        }
+        auto vc_cmp = vc;
+        std::sort(vc_cmp.begin(), vc_cmp.end());
+        parallel_radix_sort(nt, vc, [](unsigned char c) { return c; });
+        BOOST_CHECK(vc == vc_cmp);
+        // Throwing key functor.
+        std::vector<unsigned> vt(100000u, 1u);
+        vt[50000u] = 0u;
+        BOOST_CHECK_THROW(parallel_radix_sort(nt, vt,
+                                              [](unsigned n) -> unsigned {
+                                                  if (n == 0u) {
+                                                      throw std::invalid_argument("");
+                                                  }
+                                                  return n;
+                                              }),
+                          std::invalid_argument);
+    }
+    settings::reset_n_threads();
+}
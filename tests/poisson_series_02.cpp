@@ -53,6 +53,8 @@ see https://www.gnu.org/licenses/. */
 #include "../src/real.hpp"
 #include "../src/s11n.hpp"
 #include "../src/series.hpp"
+#include "../src/settings.hpp"
+#include "../src/tuning.hpp"
 
 using namespace piranha;
 
@@ -429,4 +431,77 @@ BOOST_AUTO_TEST_CASE(poisson_series_multiplier_test)
         settings::reset_n_threads();
         settings::reset_min_work_per_thread();
     }
+    {
+        // Squaring.
+        using ps = poisson_series<polynomial<rational, monomial<short>>>;
+        using math::cos;
+        using math::sin;
+        settings::set_min_work_per_thread(1u);
+        ps x{"x"}, y{"y"}, z{"z"};
+        const auto f = (x * cos(x) + y * sin(x) / 3 + z * cos(x - 2 * y) + 2 * sin(y + z) - x * y / 5 + 1).pow(4);
+        const auto f_copy(f);
+        const auto g = sin(x), g_copy(g);
+        for (unsigned nt = 1u; nt <= 4u; ++nt) {
+            settings::set_n_threads(nt);
+            BOOST_CHECK_EQUAL(f * f, f * f_copy);
+            BOOST_CHECK_EQUAL(g * g, g * g_copy);
+            BOOST_CHECK_EQUAL(g * g, (1 - cos(2 * x)) / 2);
+        }
+        settings::reset_n_threads();
+        settings::reset_min_work_per_thread();
+    }
+    {
+        // Zoned multi-threaded multiplication, with the factor 1/2 folded into the operands (exact
+        // halving) or applied at the end (integral coefficients). Use a small block size in order to have
+        // many rounds of buffering.
+        using math::cos;
+        using math::sin;
+        settings::set_min_work_per_thread(1u);
+        tuning::set_multiplication_block_size(16u);
+        {
+            using ps = poisson_series<polynomial<rational, monomial<short>>>;
+            ps x{"x"}, y{"y"}, z{"z"};
+            const auto f = (x * cos(x) + y * sin(x) / 3 + z * cos(x - 2 * y) + 2 * sin(y + z) - 1).pow(3);
+            const auto g = (y * sin(x + y) - z * cos(2 * y) / 7 + x + sin(z)).pow(3);
+            settings::set_n_threads(1u);
+            const auto cmp = f * g, cmp_sq = f * f;
+            for (unsigned nt = 2u; nt <= 4u; ++nt) {
+                settings::set_n_threads(nt);
+                BOOST_CHECK_EQUAL(f * g, cmp);
+                BOOST_CHECK_EQUAL(g * f, cmp);
+                BOOST_CHECK_EQUAL(f * f, cmp_sq);
+            }
+        }
+        {
+            using ps = poisson_series<polynomial<double, monomial<short>>>;
+            ps x{"x"}, y{"y"};
+            const auto f = (cos(x) + sin(x + y) / 4. + cos(3 * y) * 2. - 1.).pow(4);
+            const auto g = (sin(x) - cos(x - y) / 8. + 3.).pow(3);
+            settings::set_n_threads(1u);
+            const auto cmp = f * g, cmp_sq = f * f;
+            for (unsigned nt = 2u; nt <= 4u; ++nt) {
+                settings::set_n_threads(nt);
+                BOOST_CHECK_EQUAL(f * g, cmp);
+                BOOST_CHECK_EQUAL(f * f, cmp_sq);
+            }
+            BOOST_CHECK_EQUAL(cos(x) * cos(x), .5 + cos(2 * x) / 2.);
+        }
+        {
+            using ps = poisson_series<polynomial<integer, monomial<short>>>;
+            ps x{"x"}, y{"y"};
+            const auto f = (3 * cos(x) + sin(x + y) - 5 * cos(2 * y) + 1).pow(3);
+            const auto g = (7 * sin(x) - cos(x - y) + 2).pow(3);
+            settings::set_n_threads(1u);
+            const auto cmp = f * g;
+            for (unsigned nt = 2u; nt <= 4u; ++nt) {
+                settings::set_n_threads(nt);
+                BOOST_CHECK_EQUAL(f * g, cmp);
+            }
+            // The division by two truncates the integral coefficients.
+            BOOST_CHECK_EQUAL(3 * cos(x) * cos(x), 1 + cos(2 * x));
+        }
+        tuning::reset_multiplication_block_size();
+        settings::reset_n_threads();
+        settings::reset_min_work_per_thread();
+    }
 }
@@ -33,17 +33,21 @@ see https://www.gnu.org/licenses/. */
 
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/vector.hpp>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <type_traits>
+#include <vector>
 
 #include "../src/init.hpp"
 #include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
 #include "../src/monomial.hpp"
 #include "../src/mp_integer.hpp"
 #include "../src/mp_rational.hpp"
 #include "../src/settings.hpp"
+#include "../src/tuning.hpp"
 
 using namespace piranha;
 
@@ -154,3 +158,509 @@ BOOST_AUTO_TEST_CASE(polynomial_multiplier_multiplier_finalise_test)
     }
     settings::reset_n_threads();
 }
+
+// Check that the univariate polynomials a (with Kronecker monomials) and b (with monomials) are equal.
+template <typename P1, typename P2>
+static bool univariate_equal(const P1 &a, const P2 &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (const auto &t : b._container()) {
+        if (a.find_cf({t.m_key[0u]}) != t.m_cf) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct dense_tester {
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        if (std::is_same<Cf, double>::value
+            && (!std::numeric_limits<double>::is_iec559 || std::numeric_limits<double>::digits < 53)) {
+            return;
+        }
+        // Univariate polynomials with Kronecker monomials span a range of codes small enough
+        // to trigger the dense accumulator. Check the results against the plain multiplication
+        // with monomials.
+        using p_type1 = polynomial<Cf, k_monomial>;
+        using p_type2 = polynomial<Cf, monomial<int>>;
+        for (unsigned nt = 1u; nt <= 4u; ++nt) {
+            settings::set_n_threads(nt);
+            p_type1 x1{"x"};
+            p_type2 x2{"x"};
+            // Dense operands, with cancellations.
+            auto f1 = (1 + x1).pow(40), g1 = (1 - x1).pow(50);
+            auto f2 = (1 + x2).pow(40), g2 = (1 - x2).pow(50);
+            BOOST_CHECK(univariate_equal(f1 * g1, f2 * g2));
+            BOOST_CHECK(univariate_equal(g1 * f1, g2 * f2));
+            // Negative exponents.
+            f1 = (x1.pow(-10) + 2 * x1.pow(-3) - 3 * x1.pow(5)).pow(10);
+            f2 = (x2.pow(-10) + 2 * x2.pow(-3) - 3 * x2.pow(5)).pow(10);
+            BOOST_CHECK(univariate_equal(f1 * (f1 + x1), f2 * (f2 + x2)));
+            // Complete cancellation.
+            f1 = (1 + x1).pow(20);
+            BOOST_CHECK_EQUAL(f1 * (1 - x1) - (1 - x1) * f1, 0);
+            BOOST_CHECK_EQUAL((f1 - f1) * f1, 0);
+            BOOST_CHECK_EQUAL((f1 * (1 - x1)).size(), 22u);
+            BOOST_CHECK_EQUAL((f1 * (1 - x1)).pow(2).size(), 43u);
+            // Operands which are too sparse for the dense accumulator.
+            f1 = 1 + x1.pow(10000);
+            f2 = 1 + x2.pow(10000);
+            BOOST_CHECK(univariate_equal(f1 * (1 + x1), f2 * (1 + x2)));
+            // Rational scaling.
+            f1 = (1 + x1).pow(30);
+            f2 = (1 + x2).pow(30);
+            BOOST_CHECK(univariate_equal((f1 / 3) * (f1 + 1) / 5, (f2 / 3) * (f2 + 1) / 5));
+            if (!std::is_same<Cf, double>::value) {
+                // Coefficients close to the limb limit, so that the accumulation overflows the static storage.
+                // The last case includes a coefficient wider than a limb.
+                const auto lb = detail::integer_union<0>::s_storage::limb_bits;
+                const Cf big = Cf((integer(1) << lb) - 1);
+                f1 = 0;
+                f2 = 0;
+                for (int i = 0; i < 30; ++i) {
+                    f1 += (big - i) * x1.pow(i);
+                    f2 += (big - i) * x2.pow(i);
+                }
+                g1 = f1 - 3 * big * x1.pow(7);
+                g2 = f2 - 3 * big * x2.pow(7);
+                BOOST_CHECK(univariate_equal(f1 * f1, f2 * f2));
+                BOOST_CHECK(univariate_equal(f1 * g1, f2 * g2));
+                BOOST_CHECK(univariate_equal((f1 / 7) * (g1 / 3), (f2 / 7) * (g2 / 3)));
+                BOOST_CHECK_EQUAL(f1 * (-f1) + f1 * f1, 0);
+                g1 = f1 + big * big * x1;
+                g2 = f2 + big * big * x2;
+                BOOST_CHECK(univariate_equal(f1 * g1, f2 * g2));
+                // Multi-limb coefficients of increasing size, so that the multimodular accumulation
+                // is used with all the available numbers of moduli, and then not used any more.
+                for (unsigned n = 2u; n <= 9u; ++n) {
+                    const Cf large = math::pow(Cf(big), n);
+                    f1 = 0;
+                    f2 = 0;
+                    for (int i = 0; i < 30; ++i) {
+                        f1 += (i % 3 == 0 ? -large + i : large - i) * x1.pow(i);
+                        f2 += (i % 3 == 0 ? -large + i : large - i) * x2.pow(i);
+                    }
+                    g1 = f1 + x1.pow(3) - large * x1.pow(5);
+                    g2 = f2 + x2.pow(3) - large * x2.pow(5);
+                    BOOST_CHECK(univariate_equal(f1 * f1, f2 * f2));
+                    BOOST_CHECK(univariate_equal(f1 * g1, f2 * g2));
+                    BOOST_CHECK(univariate_equal((f1 / 11) * g1, (f2 / 11) * g2));
+                    BOOST_CHECK(univariate_equal(f1 * (big * x1 + 1), f2 * (big * x2 + 1)));
+                    BOOST_CHECK_EQUAL(f1 * (-g1) + g1 * f1, 0);
+                }
+                // Operands large and dense enough for the Kronecker substitution, with coefficients
+                // of both signs and of different sizes.
+                f1 = (1 + x1).pow(100);
+                f2 = (1 + x2).pow(100);
+                g1 = (1 - x1).pow(90);
+                g2 = (1 - x2).pow(90);
+                BOOST_CHECK(univariate_equal(f1 * g1, f2 * g2));
+                BOOST_CHECK(univariate_equal(g1 * g1, g2 * g2));
+                BOOST_CHECK(univariate_equal((-f1) * g1, (-f2) * g2));
+                BOOST_CHECK(univariate_equal((f1 / 3) * (g1 / 5), (f2 / 3) * (g2 / 5)));
+                BOOST_CHECK_EQUAL(f1 * (-g1) + g1 * f1, 0);
+                BOOST_CHECK_EQUAL((f1 * g1).size(), 191u);
+                f1 = (big * x1 - big * big + 1).pow(70);
+                f2 = (big * x2 - big * big + 1).pow(70);
+                BOOST_CHECK(univariate_equal(f1 * f1, f2 * f2));
+                BOOST_CHECK(univariate_equal(f1 * g1, f2 * g2));
+                // Empty slots in the packed operands, and nonzero minimum codes.
+                f1 = 0;
+                f2 = 0;
+                g1 = 0;
+                g2 = 0;
+                for (int i = 0; i < 80; ++i) {
+                    f1 += (i % 2 ? -big + i : Cf(i)) * x1.pow(3 * i - 50);
+                    f2 += (i % 2 ? -big + i : Cf(i)) * x2.pow(3 * i - 50);
+                    g1 += (i % 5 ? Cf(-i) : big * big) * x1.pow(2 * i + 7);
+                    g2 += (i % 5 ? Cf(-i) : big * big) * x2.pow(2 * i + 7);
+                }
+                BOOST_CHECK(univariate_equal(f1 * g1, f2 * g2));
+                BOOST_CHECK(univariate_equal(f1 * f1, f2 * f2));
+                BOOST_CHECK(univariate_equal((f1 / 7) * g1, (f2 / 7) * g2));
+            }
+        }
+        settings::reset_n_threads();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_dense_test)
+{
+    boost::mpl::for_each<cf_types>(dense_tester());
+}
+
+// Check that the polynomials a (with Kronecker monomials) and b (with monomials) are equal.
+template <typename P1, typename P2>
+static bool multivariate_equal(const P1 &a, const P2 &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (const auto &t : b._container()) {
+        if (a.find_cf(std::vector<int>(t.m_key.begin(), t.m_key.end())) != t.m_cf) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct sparse_acc_tester {
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        // Multivariate polynomials with Kronecker monomials are multiplied with the sparse Kronecker
+        // multiplication, which accumulates the coefficients via the side accumulators. Check the results
+        // against the plain multiplication with monomials.
+        using p_type1 = polynomial<Cf, k_monomial>;
+        using p_type2 = polynomial<Cf, monomial<int>>;
+        const auto lb = detail::integer_union<0>::s_storage::limb_bits;
+        const Cf big = Cf((integer(1) << lb) - 1);
+        settings::set_min_work_per_thread(1u);
+        for (unsigned nt = 1u; nt <= 4u; ++nt) {
+            settings::set_n_threads(nt);
+            p_type1 x1{"x"}, y1{"y"}, z1{"z"};
+            p_type2 x2{"x"}, y2{"y"}, z2{"z"};
+            // Single-limb coefficients, with cancellations.
+            auto f1 = (1 + x1 + y1 - z1).pow(8), g1 = (1 - x1 + 2 * y1 + z1).pow(7);
+            auto f2 = (1 + x2 + y2 - z2).pow(8), g2 = (1 - x2 + 2 * y2 + z2).pow(7);
+            BOOST_CHECK(multivariate_equal(f1 * g1, f2 * g2));
+            BOOST_CHECK(multivariate_equal((f1 / 3) * (g1 / 5), (f2 / 3) * (g2 / 5)));
+            BOOST_CHECK_EQUAL(f1 * (-g1) + g1 * f1, 0);
+            // Coefficients close to the limb limit, whose sums overflow a single limb.
+            f1 = (big * x1 - (big - 1) * y1 + big * z1 + big).pow(6);
+            f2 = (big * x2 - (big - 1) * y2 + big * z2 + big).pow(6);
+            BOOST_CHECK(multivariate_equal(f1 * f1, f2 * f2));
+            BOOST_CHECK(multivariate_equal(f1 * g1, f2 * g2));
+            // Multi-limb coefficients of increasing size, so that the multimodular accumulation is used
+            // with all the available numbers of moduli, and then not used any more.
+            for (unsigned n = 2u; n <= 9u; n += 3u) {
+                const Cf large = math::pow(big, n);
+                f1 = (large * x1 - (large - 1) * y1 + z1 + large).pow(4);
+                f2 = (large * x2 - (large - 1) * y2 + z2 + large).pow(4);
+                g1 = (1 - large * x1 + y1 - large * z1).pow(4);
+                g2 = (1 - large * x2 + y2 - large * z2).pow(4);
+                BOOST_CHECK(multivariate_equal(f1 * g1, f2 * g2));
+                BOOST_CHECK(multivariate_equal(f1 * f1, f2 * f2));
+                BOOST_CHECK(multivariate_equal((f1 / 7) * g1, (f2 / 7) * g2));
+                BOOST_CHECK_EQUAL(f1 * (-g1) + g1 * f1, 0);
+            }
+            // Accumulation into a series with existing terms.
+            f1 = (1 + x1 - big * y1 + z1).pow(5);
+            f2 = (1 + x2 - big * y2 + z2).pow(5);
+            g1 = (1 - x1 + y1 - big * z1).pow(5);
+            g2 = (1 - x2 + y2 - big * z2).pow(5);
+            auto h1 = f1 + g1, h2 = f2 + g2;
+            math::multiply_accumulate(h1, f1, g1);
+            math::multiply_accumulate(h2, f2, g2);
+            BOOST_CHECK(multivariate_equal(h1, h2));
+            h1 = -(f1 * g1);
+            math::multiply_accumulate(h1, f1, g1);
+            BOOST_CHECK_EQUAL(h1, 0);
+        }
+        settings::reset_min_work_per_thread();
+        settings::reset_n_threads();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_sparse_acc_test)
+{
+    boost::mpl::for_each<boost::mpl::vector<integer, rational>>(sparse_acc_tester());
+}
+
+// Check that the univariate polynomials a (with Kronecker monomials) and b (with monomials) with
+// floating-point coefficients are equal within the absolute tolerance tol. Missing terms count as zero.
+template <typename P1, typename P2>
+static bool univariate_close(const P1 &a, const P2 &b, double tol)
+{
+    for (const auto &t : b._container()) {
+        if (std::abs(a.find_cf({t.m_key[0u]}) - t.m_cf) > tol) {
+            return false;
+        }
+    }
+    for (const auto &t : a._container()) {
+        if (std::abs(b.find_cf({t.m_key.unpack(a.get_symbol_set())[0u]}) - t.m_cf) > tol) {
+            return false;
+        }
+    }
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_fft_test)
+{
+    if (!std::numeric_limits<double>::is_iec559 || std::numeric_limits<double>::digits < 53) {
+        return;
+    }
+    using p_type1 = polynomial<double, k_monomial>;
+    using p_type2 = polynomial<double, monomial<int>>;
+    for (unsigned nt = 1u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        p_type1 x1{"x"};
+        p_type2 x2{"x"};
+        // Operands large and dense enough for the FFT, with small integral coefficients, so that the
+        // exact result is computed exactly by the plain multiplication.
+        p_type1 f1, g1, h1;
+        p_type2 f2, g2, h2;
+        for (int i = 0; i < 400; ++i) {
+            f1 += (1 + i % 3) * x1.pow(i);
+            f2 += (1 + i % 3) * x2.pow(i);
+            g1 += (i % 4 - 1.5) * x1.pow(i - 20);
+            g2 += (i % 4 - 1.5) * x2.pow(i - 20);
+            // h(x) = f(-x).
+            h1 += (i % 2 ? -1 : 1) * (1 + i % 3) * x1.pow(i);
+            h2 += (i % 2 ? -1 : 1) * (1 + i % 3) * x2.pow(i);
+        }
+        BOOST_CHECK(univariate_close(f1 * g1, f2 * g2, 1E-8));
+        BOOST_CHECK(univariate_close(g1 * f1, g2 * f2, 1E-8));
+        BOOST_CHECK(univariate_close(f1 * f1, f2 * f2, 1E-8));
+        BOOST_CHECK(univariate_close((f1 / 3) * (g1 * 1E10), (f2 / 3) * (g2 * 1E10), 1E3));
+        BOOST_CHECK_EQUAL((f1 * g1).size(), (f2 * g2).size());
+        // f(x) * f(-x) is even: the odd coefficients cancel out exactly.
+        BOOST_CHECK_EQUAL((f1 * h1).size(), 400u);
+        BOOST_CHECK(univariate_close(f1 * h1, f2 * h2, 1E-8));
+        // Coefficients spanning too many orders of magnitude for the FFT.
+        f1 += 1E-30 * x1.pow(400);
+        f2 += 1E-30 * x2.pow(400);
+        BOOST_CHECK(univariate_close(f1 * g1, f2 * g2, 1E-8));
+        BOOST_CHECK_EQUAL((f1 * g1).find_cf({779}), 1E-30 * 1.5);
+    }
+    settings::reset_n_threads();
+}
+
+struct no_estimate_tester {
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        if (std::is_same<Cf, double>::value
+            && (!std::numeric_limits<double>::is_iec559 || std::numeric_limits<double>::digits < 53)) {
+            return;
+        }
+        settings::set_n_threads(1u);
+        using p_type = polynomial<Cf, k_monomial>;
+        p_type x("x"), y("y"), z("z"), t("t");
+        auto f = (1 + x + y + z + t).pow(10), g = f + 1, h = (1 - x + y + z + t).pow(10);
+        // Force the estimation first.
+        tuning::set_estimate_threshold(0u);
+        const auto cmp1 = f * g, cmp2 = f * h, cmp3 = (x + y) * (x - y);
+        // Then disable it, so that the output will be grown on the fly.
+        tuning::set_estimate_threshold(10000u);
+        BOOST_CHECK_EQUAL(f * g, cmp1);
+        BOOST_CHECK_EQUAL((f * g).size(), 10626u);
+        BOOST_CHECK_EQUAL(f * h, cmp2);
+        BOOST_CHECK_EQUAL((f * h).size(), 5786u);
+        BOOST_CHECK_EQUAL((x + y) * (x - y), cmp3);
+        BOOST_CHECK_EQUAL((x + y) * (x - y), x * x - y * y);
+        BOOST_CHECK_EQUAL(f * (f - f), 0);
+        tuning::reset_estimate_threshold();
+        settings::reset_n_threads();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_no_estimate_test)
+{
+    boost::mpl::for_each<cf_types>(no_estimate_tester());
+}
+
+struct sorted_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            using p_type = polynomial<Cf, Key>;
+            // Multiply a and b with the sorted multiplication, check the ordering of the output
+            // and compare it to the standard multiplication.
+            p_type x("x"), y("y"), z("z");
+            // NOTE: the multiplier requires operands with the same symbol set.
+            const auto e = (x + y + z) - (x + y + z);
+            auto checker = [&e](const p_type &a, const p_type &b) {
+                // NOTE: the multiplier stores pointers to the terms of the operands.
+                const auto a1 = a + e, b1 = b + e;
+                series_multiplier<p_type> sm(a1, b1);
+                const auto v = sm._sorted_multiplication();
+                p_type res;
+                res.set_symbol_set(a1.get_symbol_set());
+                for (decltype(v.size()) i = 0u; i < v.size(); ++i) {
+                    BOOST_CHECK(!math::is_zero(v[i].m_cf));
+                    if (i) {
+                        BOOST_CHECK(v[i].m_key < v[i - 1u].m_key);
+                    }
+                    res.insert(v[i]);
+                }
+                BOOST_CHECK_EQUAL(res.size(), v.size());
+                BOOST_CHECK_EQUAL(res, a * b);
+            };
+            checker(x, y);
+            checker(x + y, x - y);
+            checker(x + y - z, x - y + z);
+            checker(x - x, y);
+            checker(1 + x, (1 - x).pow(3));
+            const auto f = (1 + x + y + z).pow(6), g = (1 - x + 2 * y - z).pow(5) + x * y;
+            checker(f, g);
+            checker(g, f);
+            checker(f, f);
+            checker(f / 3, g / 5);
+            checker(f * 2 / 7, x / 3 + 5 * z / 11);
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<k_types>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_sorted_test)
+{
+    boost::mpl::for_each<boost::mpl::vector<integer, rational>>(sorted_tester());
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_zone_stats_test)
+{
+    // Check the work-stealing zone scheduler with skewed operands.
+    using p_type = polynomial<integer, k_monomial>;
+    p_type x("x"), y("y"), z("z");
+    p_type f, g;
+    // Most of the term-by-term products here will end up in few zones.
+    for (int i = 0; i < 200; ++i) {
+        f += x.pow(i);
+        g += (i + 1) * x.pow(i);
+    }
+    f += y.pow(1000) + z.pow(100);
+    g += y.pow(1000) - z.pow(300);
+    settings::set_n_threads(1u);
+    const auto cmp = f * g;
+    {
+        series_multiplier<p_type> sm(f, g);
+        BOOST_CHECK_EQUAL(sm(), cmp);
+        BOOST_CHECK(sm._get_zone_stats().empty());
+    }
+    settings::set_min_work_per_thread(1u);
+    for (unsigned nt = 2u; nt <= 4u; ++nt) {
+        settings::set_n_threads(nt);
+        series_multiplier<p_type> sm(f, g);
+        BOOST_CHECK_EQUAL(sm(), cmp);
+        const auto &stats = sm._get_zone_stats();
+        BOOST_CHECK_EQUAL(stats.size(), nt);
+        std::size_t tot = 0u;
+        for (const auto &p : stats) {
+            tot += p.first + p.second;
+        }
+        // There are at least 10 zones per thread, and oversized zones get split.
+        BOOST_CHECK(tot >= nt * 10u);
+    }
+    settings::reset_min_work_per_thread();
+    settings::reset_n_threads();
+}
+
+struct square_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            using p_type = polynomial<Cf, Key>;
+            p_type x("x"), y("y"), z("z");
+            const auto f = (1 + x + y + z).pow(8) + x * y * y / 3, g = (x - y).pow(5) / 7;
+            // A copy is not detected as a squaring.
+            const auto f_copy(f), g_copy(g);
+            for (unsigned nt = 1u; nt <= 4u; ++nt) {
+                settings::set_n_threads(nt);
+                for (unsigned e_thr : {0u, 10000u}) {
+                    tuning::set_estimate_threshold(e_thr);
+                    BOOST_CHECK_EQUAL(f * f, f * f_copy);
+                    BOOST_CHECK_EQUAL(g * g, g * g_copy);
+                    BOOST_CHECK_EQUAL((f - f) * (f - f), 0);
+                    BOOST_CHECK_EQUAL(x * x, x.pow(2));
+                    p_type::set_auto_truncate_degree(9);
+                    BOOST_CHECK_EQUAL(f * f, f * f_copy);
+                    BOOST_CHECK_EQUAL(g * g, 0);
+                    p_type::set_auto_truncate_degree(11, {"x", "y"});
+                    BOOST_CHECK_EQUAL(f * f, f * f_copy);
+                    BOOST_CHECK_EQUAL(g * g, g * g_copy);
+                    p_type::unset_auto_truncate_degree();
+                }
+            }
+            tuning::reset_estimate_threshold();
+            settings::reset_n_threads();
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<boost::mpl::vector<monomial<int>, k_monomial>>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_square_test)
+{
+    settings::set_min_work_per_thread(1u);
+    boost::mpl::for_each<boost::mpl::vector<rational>>(square_tester());
+    settings::reset_min_work_per_thread();
+}
+
+struct macc_tester {
+    template <typename Cf>
+    struct runner {
+        template <typename Key>
+        void operator()(const Key &)
+        {
+            using p_type = polynomial<Cf, Key>;
+            p_type x("x"), y("y"), z("z");
+            const auto f = (1 + x + y + z).pow(6), g = (1 - x + 2 * y).pow(5), h = x * y - z * z + 3;
+            auto check = [](p_type acc, const p_type &a, const p_type &b) {
+                auto cmp = acc + a * b;
+                math::multiply_accumulate(acc, a, b);
+                return acc == cmp;
+            };
+            for (unsigned nt = 1u; nt <= 4u; ++nt) {
+                settings::set_n_threads(nt);
+                for (unsigned e_thr : {0u, 10000u}) {
+                    tuning::set_estimate_threshold(e_thr);
+                    BOOST_CHECK(check(p_type{}, f, g));
+                    BOOST_CHECK(check(h, f, g));
+                    BOOST_CHECK(check(f, f, f));
+                    BOOST_CHECK(check(-f * g, f, g));
+                    BOOST_CHECK(check(f - 1, f, p_type{}));
+                    BOOST_CHECK(check(x + y + z, x, y));
+                    // Different symbol sets.
+                    BOOST_CHECK(check(p_type{"a"}, f, g));
+                    BOOST_CHECK(check(h, p_type{"a"}, g));
+                    // Aliasing.
+                    auto acc(f), cmp(f + f * g);
+                    math::multiply_accumulate(acc, acc, g);
+                    BOOST_CHECK_EQUAL(acc, cmp);
+                    acc = g;
+                    cmp = g + f * g;
+                    math::multiply_accumulate(acc, f, acc);
+                    BOOST_CHECK_EQUAL(acc, cmp);
+                    acc = g;
+                    cmp = g + g * g;
+                    math::multiply_accumulate(acc, acc, acc);
+                    BOOST_CHECK_EQUAL(acc, cmp);
+                    // Truncation.
+                    p_type::set_auto_truncate_degree(4);
+                    BOOST_CHECK(check(h, f, g));
+                    p_type::unset_auto_truncate_degree();
+                }
+            }
+            tuning::reset_estimate_threshold();
+            settings::reset_n_threads();
+        }
+    };
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        boost::mpl::for_each<boost::mpl::vector<monomial<int>, k_monomial>>(runner<Cf>());
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_multiply_accumulate_test)
+{
+    settings::set_min_work_per_thread(1u);
+    boost::mpl::for_each<cf_types>(macc_tester());
+    settings::reset_min_work_per_thread();
+}
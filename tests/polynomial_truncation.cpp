@@ -46,6 +46,7 @@ see https://www.gnu.org/licenses/. */
 #include "../src/mp_rational.hpp"
 #include "../src/real.hpp"
 #include "../src/settings.hpp"
+#include "../src/tuning.hpp"
 
 using namespace piranha;
 
@@ -211,3 +212,41 @@ BOOST_AUTO_TEST_CASE(polynomial_truncation_recursive_test)
     BOOST_CHECK(x * x * x * x * x * y * z == 0);
     p1::unset_auto_truncate_degree();
 }
+
+struct kronecker_tester {
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        using pt = polynomial<Cf, k_monomial>;
+        pt x{"x"}, y{"y"}, z{"z"}, t{"t"};
+        const auto f = (1 + x + y + z + t).pow(8), g = (1 - x + 2 * y - z + t).pow(8) + x * y * y;
+        // The untruncated results.
+        const auto fg = f * g, ff = f * f;
+        for (unsigned nt = 1u; nt <= 4u; ++nt) {
+            settings::set_n_threads(nt);
+            // Check with and without the estimation of the size of the result.
+            for (unsigned e_thr : {0u, 10000u}) {
+                tuning::set_estimate_threshold(e_thr);
+                for (int deg : {-1, 0, 1, 5, 10, 15, 17}) {
+                    pt::set_auto_truncate_degree(deg);
+                    BOOST_CHECK_EQUAL(f * g, fg.truncate_degree(deg));
+                    BOOST_CHECK_EQUAL(f * f, ff.truncate_degree(deg));
+                    pt::set_auto_truncate_degree(deg, {"x", "z"});
+                    BOOST_CHECK_EQUAL(f * g, fg.truncate_degree(deg, {"x", "z"}));
+                    BOOST_CHECK_EQUAL(f * f, ff.truncate_degree(deg, {"x", "z"}));
+                }
+                pt::set_auto_truncate_degree(40);
+                BOOST_CHECK_EQUAL(f * g, fg);
+                pt::unset_auto_truncate_degree();
+            }
+        }
+        tuning::reset_estimate_threshold();
+        settings::reset_n_threads();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_truncation_kronecker_test)
+{
+    // Truncated multiplication with Kronecker monomials, compared to the truncation of the untruncated result.
+    boost::mpl::for_each<boost::mpl::vector<integer, rational>>(kronecker_tester());
+}
@@ -31,7 +31,11 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE runtime_info_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "../src/init.hpp"
 #include "../src/memory.hpp"
@@ -44,6 +48,19 @@ BOOST_AUTO_TEST_CASE(runtime_info_print_test)
     init();
     std::cout << "Concurrency: " << runtime_info::get_hardware_concurrency() << '\n';
     std::cout << "Cache line size: " << runtime_info::get_cache_line_size() << '\n';
+    std::cout << "Page size: " << runtime_info::get_page_size() << '\n';
+    for (unsigned level = 1u; level <= 3u; ++level) {
+        std::cout << "L" << level << " cache size: " << runtime_info::get_cache_size(level) << '\n';
+    }
+    const auto topology = runtime_info::get_numa_topology();
+    std::cout << "NUMA nodes: " << topology.size() << '\n';
+    for (decltype(topology.size()) i = 0u; i < topology.size(); ++i) {
+        std::cout << "  node " << i << ':';
+        for (const auto &cpu : topology[i]) {
+            std::cout << ' ' << cpu;
+        }
+        std::cout << '\n';
+    }
     std::cout << "Memory alignment primitives: "
               <<
 #if defined(PIRANHA_HAVE_MEMORY_ALIGNMENT_PRIMITIVES)
@@ -59,3 +76,28 @@ BOOST_AUTO_TEST_CASE(runtime_info_settings_test)
                 || runtime_info::get_hardware_concurrency() == 0u);
     BOOST_CHECK_EQUAL(runtime_info::get_cache_line_size(), settings::get_cache_line_size());
 }
+
+BOOST_AUTO_TEST_CASE(runtime_info_numa_test)
+{
+    // Each CPU belongs to at most one node, and the CPU lists are sorted.
+    const auto topology = runtime_info::get_numa_topology();
+    std::set<unsigned> cpus;
+    for (const auto &node : topology) {
+        BOOST_CHECK(std::is_sorted(node.begin(), node.end()));
+        for (const auto &cpu : node) {
+            BOOST_CHECK(cpus.insert(cpu).second);
+        }
+    }
+    // Parsing of CPU lists.
+    using v_type = std::vector<unsigned>;
+    BOOST_CHECK(parse_index_list("").first);
+    BOOST_CHECK(parse_index_list("").second.empty());
+    BOOST_CHECK(parse_index_list("0").second == v_type{0u});
+    BOOST_CHECK((parse_index_list("0-3").second == v_type{0u, 1u, 2u, 3u}));
+    BOOST_CHECK((parse_index_list("0-1,4,6-7").second == v_type{0u, 1u, 4u, 6u, 7u}));
+    BOOST_CHECK(!parse_index_list("a").first);
+    BOOST_CHECK(!parse_index_list("1-").first);
+    BOOST_CHECK(!parse_index_list("3-1").first);
+    BOOST_CHECK(!parse_index_list("1,,2").first);
+    BOOST_CHECK(!parse_index_list("-1").first);
+}
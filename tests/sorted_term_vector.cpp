@@ -0,0 +1,224 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/sorted_term_vector.hpp"
+
+#define BOOST_TEST_MODULE sorted_term_vector_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../src/flat_hash_set.hpp"
+#include "../src/forwarding.hpp"
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/series.hpp"
+#include "../src/settings.hpp"
+#include "../src/symbol_set.hpp"
+
+static const int ntries = 100;
+
+using namespace piranha;
+
+static std::mt19937 rng;
+
+// A series type storing its terms in a flat_hash_set.
+template <typename Cf, typename Expo>
+class f_series_type : public series<Cf, monomial<Expo>, f_series_type<Cf, Expo>, flat_hash_set>
+{
+public:
+    template <typename Cf2>
+    using rebind = f_series_type<Cf2, Expo>;
+    typedef series<Cf, monomial<Expo>, f_series_type<Cf, Expo>, flat_hash_set> base;
+    f_series_type() = default;
+    f_series_type(const f_series_type &) = default;
+    f_series_type(f_series_type &&) = default;
+    explicit f_series_type(const char *name) : base()
+    {
+        typedef typename base::term_type term_type;
+        this->m_symbol_set.add(name);
+        this->insert(term_type(Cf(1), typename term_type::key_type{Expo(1)}));
+    }
+    f_series_type &operator=(const f_series_type &) = default;
+    f_series_type &operator=(f_series_type &&) = default;
+    PIRANHA_FORWARDING_CTOR(f_series_type, base)
+    PIRANHA_FORWARDING_ASSIGNMENT(f_series_type, base)
+};
+
+// Random series with up to size terms in the variables x, y and z.
+template <typename S>
+static S random_series(unsigned size)
+{
+    using term_type = typename S::term_type;
+    using cf_type = typename term_type::cf_type;
+    using key_type = typename term_type::key_type;
+    std::uniform_int_distribution<int> edist(0, 20), cdist(-10, 10);
+    S retval;
+    retval.set_symbol_set(symbol_set({symbol{"x"}, symbol{"y"}, symbol{"z"}}));
+    for (unsigned i = 0u; i < size; ++i) {
+        retval.insert(term_type{cf_type(cdist(rng)), key_type{edist(rng), edist(rng), edist(rng)}});
+    }
+    return retval;
+}
+
+template <typename S, typename V>
+static void check_sorted_vector(const S &s, const V &v)
+{
+    BOOST_CHECK(v.get_symbol_set() == s.get_symbol_set());
+    BOOST_CHECK_EQUAL(v.size(), s.size());
+    BOOST_CHECK(std::is_sorted(v.begin(), v.end(), [](const typename V::term_type &t1,
+                                                       const typename V::term_type &t2) { return t1.m_key < t2.m_key; }));
+    for (const auto &t : v) {
+        const auto it = s._container().find(t);
+        BOOST_CHECK(it != s._container().end());
+        BOOST_CHECK(it->m_cf == t.m_cf);
+        BOOST_CHECK(v.find(t.m_key) != v.end());
+        BOOST_CHECK(v.find(t.m_key)->m_cf == t.m_cf);
+    }
+}
+
+template <typename S>
+static void conversion_tester()
+{
+    using term_type = typename S::term_type;
+    using stv_type = sorted_term_vector<typename term_type::cf_type, typename term_type::key_type>;
+    settings::set_n_threads(4u);
+    for (int i = 0; i < ntries; ++i) {
+        const auto s = random_series<S>(static_cast<unsigned>(i) * 10u);
+        for (unsigned n_threads = 1u; n_threads <= 4u; ++n_threads) {
+            stv_type v(s, n_threads);
+            check_sorted_vector(s, v);
+            if (s.size()) {
+                BOOST_CHECK(v.leading_term().m_key == detail::poly_lterm(s)->m_key);
+            }
+            for (unsigned m = 1u; m <= 4u; ++m) {
+                BOOST_CHECK(v.template to_series<S>(m) == s);
+            }
+        }
+    }
+    settings::reset_n_threads();
+    BOOST_CHECK_THROW(stv_type(S{}, 0u), std::invalid_argument);
+    BOOST_CHECK_THROW(stv_type{}.template to_series<S>(0u), std::invalid_argument);
+    BOOST_CHECK(stv_type(S{}).empty());
+    BOOST_CHECK(stv_type{}.template to_series<S>().empty());
+    BOOST_CHECK_THROW(stv_type{}.leading_term(), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(sorted_term_vector_conversion_test)
+{
+    init();
+    conversion_tester<polynomial<integer, k_monomial>>();
+    conversion_tester<polynomial<rational, monomial<int>>>();
+    conversion_tester<f_series_type<integer, int>>();
+}
+
+BOOST_AUTO_TEST_CASE(sorted_term_vector_terms_ctor_test)
+{
+    using p_type = polynomial<integer, monomial<int>>;
+    using term_type = p_type::term_type;
+    using key_type = term_type::key_type;
+    using stv_type = sorted_term_vector<integer, key_type>;
+    symbol_set args({symbol{"x"}, symbol{"y"}});
+    // Unsorted terms, with duplicates and cancellations.
+    std::vector<term_type> terms{term_type{integer(1), key_type{2, 0}}, term_type{integer(3), key_type{0, 1}},
+                                 term_type{integer(2), key_type{2, 0}}, term_type{integer(-3), key_type{0, 1}},
+                                 term_type{integer(5), key_type{1, 1}}, term_type{integer(0), key_type{0, 0}}};
+    stv_type v(args, terms);
+    BOOST_CHECK_EQUAL(v.size(), 2u);
+    BOOST_CHECK(v.begin()->m_key == (key_type{1, 1}));
+    BOOST_CHECK(v.begin()->m_cf == 5);
+    BOOST_CHECK(v.leading_term().m_key == (key_type{2, 0}));
+    BOOST_CHECK(v.leading_term().m_cf == 3);
+    BOOST_CHECK(v.find(key_type{0, 1}) == v.end());
+    BOOST_CHECK(v.find(key_type{2, 0}) != v.end());
+    p_type x{"x"}, y{"y"};
+    BOOST_CHECK(v.to_series<p_type>() == 5 * x * y + 3 * x * x);
+    // Parallel sorting of a large vector.
+    settings::set_n_threads(4u);
+    std::uniform_int_distribution<int> edist(0, 30), cdist(-10, 10);
+    terms.clear();
+    p_type cmp;
+    cmp.set_symbol_set(args);
+    for (int i = 0; i < 10000; ++i) {
+        terms.push_back(term_type{integer(cdist(rng)), key_type{edist(rng), edist(rng)}});
+        cmp.insert(terms.back());
+    }
+    for (unsigned n_threads = 1u; n_threads <= 4u; ++n_threads) {
+        stv_type v2(cmp.get_symbol_set(), terms, n_threads);
+        check_sorted_vector(cmp, v2);
+        BOOST_CHECK(v2.to_series<p_type>(n_threads) == cmp);
+    }
+    settings::reset_n_threads();
+    // Error handling.
+    BOOST_CHECK_THROW(stv_type(args, terms, 0u), std::invalid_argument);
+    BOOST_CHECK_THROW(stv_type(symbol_set{}, terms), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(sorted_term_vector_add_sub_test)
+{
+    using p_type = polynomial<integer, k_monomial>;
+    using term_type = p_type::term_type;
+    using stv_type = sorted_term_vector<term_type::cf_type, term_type::key_type>;
+    for (int i = 0; i < ntries; ++i) {
+        const auto a = random_series<p_type>(static_cast<unsigned>(i)), b = random_series<p_type>(10u);
+        stv_type va(a), vb(b);
+        auto tmp(va);
+        tmp.add(vb);
+        check_sorted_vector(a + b, tmp);
+        tmp = va;
+        tmp.sub(vb);
+        check_sorted_vector(a - b, tmp);
+        tmp = vb;
+        tmp.sub(va);
+        check_sorted_vector(b - a, tmp);
+        tmp.add(tmp);
+        check_sorted_vector(2 * (b - a), tmp);
+        tmp.sub(tmp);
+        BOOST_CHECK(tmp.empty());
+        tmp = va;
+        tmp.add(stv_type{va.get_symbol_set(), {}});
+        check_sorted_vector(a, tmp);
+    }
+    // Subtraction touching only the tail.
+    p_type x{"x"};
+    stv_type v(x.pow(4) + x.pow(3) + x + 1);
+    v.sub(stv_type(x.pow(4) + 2 * x.pow(3) + x.pow(2)));
+    BOOST_CHECK(v.to_series<p_type>() == -x.pow(3) - x.pow(2) + x + 1);
+    BOOST_CHECK(v.leading_term().m_cf == -1);
+    // Incompatible symbol sets.
+    BOOST_CHECK_THROW(v.add(stv_type(p_type{"y"})), std::invalid_argument);
+    BOOST_CHECK_THROW(v.sub(stv_type(p_type{"y"})), std::invalid_argument);
+}
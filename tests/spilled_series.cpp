@@ -0,0 +1,198 @@
+/* Copyright 2009-2016 Francesco Biscani (bluescarni@gmail.com)
+
+This file is part of the Piranha library.
+
+The Piranha library is free software; you can redistribute it and/or modify
+it under the terms of either:
+
+  * the GNU Lesser General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your
+    option) any later version.
+
+or
+
+  * the GNU General Public License as published by the Free Software
+    Foundation; either version 3 of the License, or (at your option) any
+    later version.
+
+or both in parallel, as here.
+
+The Piranha library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received copies of the GNU General Public License and the
+GNU Lesser General Public License along with the Piranha library.  If not,
+see https://www.gnu.org/licenses/. */
+
+#include "../src/spilled_series.hpp"
+
+#define BOOST_TEST_MODULE spilled_series_test
+#include <boost/test/included/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/vector.hpp>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/init.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/s11n.hpp"
+#include "../src/settings.hpp"
+
+using namespace piranha;
+
+namespace bfs = boost::filesystem;
+
+using cf_types = boost::mpl::vector<double, integer, rational>;
+
+// Unique prefix for the files of a spilled series in the tmp directory.
+static inline std::string tmp_prefix()
+{
+    return (bfs::temp_directory_path() / bfs::unique_path()).string();
+}
+
+struct zoned_tester {
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        using p_type = polynomial<Cf, k_monomial>;
+        using size_type = typename p_type::size_type;
+        p_type x("x"), y("y"), z("z");
+        const auto f = (1 + x + y + z).pow(8) + x * y / 2, g = (1 - x + 2 * y - z).pow(7);
+        const auto cmp = f * g;
+        for (unsigned nt = 1u; nt <= 4u; ++nt) {
+            settings::set_n_threads(nt);
+            std::mutex m;
+            for (size_type max_size : {size_type(1u), size_type(37u), size_type(1000u), size_type(1000000u)}) {
+                series_multiplier<p_type> sm(f, g);
+                std::vector<std::pair<size_type, p_type>> zones;
+                sm._zoned_multiplication(max_size, [&m, &zones](const size_type &idx, p_type &&zone) {
+                    std::lock_guard<std::mutex> lock(m);
+                    zones.emplace_back(idx, std::move(zone));
+                });
+                p_type res;
+                size_type tot = 0u;
+                for (const auto &p : zones) {
+                    BOOST_CHECK(!p.second.empty());
+                    BOOST_CHECK(p.second.size() <= cmp.size());
+                    res += p.second;
+                    tot += p.second.size();
+                }
+                // The zones are disjoint.
+                BOOST_CHECK_EQUAL(res, cmp);
+                BOOST_CHECK_EQUAL(tot, cmp.size());
+                if (max_size == 1u) {
+                    BOOST_CHECK(zones.size() > 1u);
+                }
+                if (max_size == 1000000u) {
+                    BOOST_CHECK_EQUAL(zones.size(), 1u);
+                }
+            }
+            // Cancellations and empty operands.
+            // NOTE: the multiplier stores pointers to the terms of the operands.
+            const p_type zero = f - f, a = (x - y) * (x + y), b = x * x + y * y;
+            series_multiplier<p_type> sm0(zero, g);
+            bool called = false;
+            sm0._zoned_multiplication(10u, [&called](const size_type &, p_type &&) { called = true; });
+            BOOST_CHECK(!called);
+            series_multiplier<p_type> sm1(a, b);
+            p_type res;
+            sm1._zoned_multiplication(1u, [&res, &m](const size_type &, p_type &&zone) {
+                std::lock_guard<std::mutex> lock(m);
+                res += zone;
+            });
+            BOOST_CHECK_EQUAL(res, x.pow(4) - y.pow(4));
+            BOOST_CHECK_THROW(sm1._zoned_multiplication(0u, [](const size_type &, p_type &&) {}),
+                              std::invalid_argument);
+        }
+        settings::reset_n_threads();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(spilled_series_zoned_multiplication_test)
+{
+    init();
+    settings::set_min_work_per_thread(1u);
+    boost::mpl::for_each<cf_types>(zoned_tester());
+    settings::reset_min_work_per_thread();
+}
+
+struct spill_tester {
+    template <typename Cf>
+    void operator()(const Cf &)
+    {
+        using p_type = polynomial<Cf, k_monomial>;
+        p_type x("x"), y("y"), z("z");
+        const auto f = (1 + x + y + z).pow(6) + x * y / 2, g = (1 - x + 2 * y - z).pow(5);
+        const auto cmp = f * g;
+        for (unsigned nt = 1u; nt <= 2u; ++nt) {
+            settings::set_n_threads(nt);
+            std::vector<std::string> files;
+            {
+                spilled_series<p_type> ss(f, g, tmp_prefix(), 50u);
+                BOOST_CHECK(ss.size() > 1u);
+                BOOST_CHECK_EQUAL(ss.get_files().size(), ss.size());
+                files = ss.get_files();
+                for (const auto &file : files) {
+                    BOOST_CHECK(bfs::exists(file));
+                }
+                BOOST_CHECK_EQUAL(ss.to_series(), cmp);
+                p_type res;
+                ss.for_each([&res](p_type &&zone) { res += zone; });
+                BOOST_CHECK_EQUAL(res, cmp);
+                BOOST_CHECK(!ss.load(0u).empty());
+                BOOST_CHECK_THROW(ss.load(ss.size()), std::out_of_range);
+                // Move semantics.
+                spilled_series<p_type> ss2(std::move(ss));
+                BOOST_CHECK_EQUAL(ss.size(), 0u);
+                BOOST_CHECK_EQUAL(ss.to_series(), 0);
+                BOOST_CHECK_EQUAL(ss2.to_series(), cmp);
+                ss = std::move(ss2);
+                BOOST_CHECK_EQUAL(ss.to_series(), cmp);
+                spilled_series<p_type> ss3(x + y, x - y, tmp_prefix(), 1u, data_format::boost_portable);
+                BOOST_CHECK(ss3.size() > 0u);
+                BOOST_CHECK_EQUAL(ss3.to_series(), x * x - y * y);
+                ss3 = std::move(ss);
+                BOOST_CHECK_EQUAL(ss3.to_series(), cmp);
+            }
+            // The files are removed on destruction.
+            for (const auto &file : files) {
+                BOOST_CHECK(!bfs::exists(file));
+            }
+            // Empty result.
+            spilled_series<p_type> ss(f - f, g, tmp_prefix(), 10u);
+            BOOST_CHECK_EQUAL(ss.size(), 0u);
+            BOOST_CHECK_EQUAL(ss.to_series(), 0);
+            // Incompatible symbol sets.
+            BOOST_CHECK_THROW(spilled_series<p_type>(x, p_type{"a"}, tmp_prefix(), 10u), std::invalid_argument);
+            // Auto-truncation is applied to the stored result.
+            p_type::set_auto_truncate_degree(5);
+            const auto tcmp = f * g;
+            BOOST_CHECK_EQUAL(tcmp, cmp.truncate_degree(5));
+            BOOST_CHECK_EQUAL((spilled_series<p_type>(f, g, tmp_prefix(), 50u).to_series()), tcmp);
+            p_type::set_auto_truncate_degree(3, {"x", "z"});
+            BOOST_CHECK_EQUAL((spilled_series<p_type>(f, g, tmp_prefix(), 50u).to_series()),
+                              cmp.truncate_degree(3, {"x", "z"}));
+            p_type::unset_auto_truncate_degree();
+            BOOST_CHECK_EQUAL((spilled_series<p_type>(f, g, tmp_prefix(), 50u).to_series()), cmp);
+        }
+        settings::reset_n_threads();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(spilled_series_spill_test)
+{
+    settings::set_min_work_per_thread(1u);
+    boost::mpl::for_each<cf_types>(spill_tester());
+    settings::reset_min_work_per_thread();
+}
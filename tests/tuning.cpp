@@ -31,7 +31,10 @@ see https://www.gnu.org/licenses/. */
 #define BOOST_TEST_MODULE tuning_test
 #include <boost/test/included/unit_test.hpp>
 
+#include <boost/filesystem.hpp>
+#include <fstream>
 #include <stdexcept>
+#include <string>
 #include <thread>
 
 #include "../src/init.hpp"
@@ -92,3 +95,95 @@ BOOST_AUTO_TEST_CASE(tuning_estimation_threshold_test)
     tuning::reset_estimate_threshold();
     BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 200u);
 }
+
+BOOST_AUTO_TEST_CASE(tuning_type_block_size_test)
+{
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<int>(), 256u);
+    tuning::set_multiplication_block_size<int>(512u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<int>(), 512u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<double>(), 256u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 256u);
+    BOOST_CHECK_THROW(tuning::set_multiplication_block_size<int>(8u), std::invalid_argument);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<int>(), 512u);
+    // Changing the global value does not affect the types with their own block size.
+    tuning::set_multiplication_block_size(128u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<int>(), 512u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<double>(), 128u);
+    BOOST_CHECK(tuning::has_multiplication_block_size<int>());
+    BOOST_CHECK(!tuning::has_multiplication_block_size<double>());
+    tuning::reset_multiplication_block_size<int>();
+    BOOST_CHECK(!tuning::has_multiplication_block_size<int>());
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<int>(), 128u);
+    tuning::reset_multiplication_block_size();
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<int>(), 256u);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_zone_multiplier_test)
+{
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), 10u);
+    tuning::set_multiplication_zone_multiplier(20u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), 20u);
+    BOOST_CHECK_THROW(tuning::set_multiplication_zone_multiplier(0u), std::invalid_argument);
+    BOOST_CHECK_THROW(tuning::set_multiplication_zone_multiplier(10000u), std::invalid_argument);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), 20u);
+    tuning::reset_multiplication_zone_multiplier();
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_save_load_test)
+{
+    const auto filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    tuning::set_parallel_memory_set(false);
+    tuning::set_multiplication_block_size(512u);
+    tuning::set_multiplication_block_size<int>(64u);
+    tuning::set_multiplication_zone_multiplier(5u);
+    tuning::set_estimate_threshold(100u);
+    tuning::save_parameters(filename);
+    tuning::reset_parallel_memory_set();
+    tuning::reset_multiplication_block_size();
+    tuning::reset_multiplication_block_size<int>();
+    tuning::reset_multiplication_zone_multiplier();
+    tuning::reset_estimate_threshold();
+    tuning::load_parameters(filename);
+    BOOST_CHECK(!tuning::get_parallel_memory_set());
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 512u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<int>(), 64u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size<double>(), 512u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), 5u);
+    BOOST_CHECK_EQUAL(tuning::get_estimate_threshold(), 100u);
+    tuning::reset_parallel_memory_set();
+    tuning::reset_multiplication_block_size();
+    tuning::reset_multiplication_block_size<int>();
+    tuning::reset_multiplication_zone_multiplier();
+    tuning::reset_estimate_threshold();
+    // Invalid files are rejected without modifying the parameters.
+    auto check_invalid = [&filename](const std::string &content) {
+        {
+            std::ofstream ofile(filename, std::ios::out | std::ios::trunc);
+            ofile << content;
+        }
+        BOOST_CHECK_THROW(tuning::load_parameters(filename), std::invalid_argument);
+        BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 256u);
+        BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), 10u);
+    };
+    check_invalid("multiplication_block_size 512\nfoo 1\n");
+    check_invalid("multiplication_block_size 512\nmultiplication_zone_multiplier 0\n");
+    check_invalid("multiplication_block_size 8\n");
+    check_invalid("multiplication_block_size[] 512\n");
+    check_invalid("multiplication_block_size abc\n");
+    check_invalid("parallel_memory_set 2\n");
+    check_invalid("estimate_threshold\n");
+    // Partial files only change the parameters they contain.
+    {
+        std::ofstream ofile(filename, std::ios::out | std::ios::trunc);
+        ofile << "multiplication_zone_multiplier 40\n";
+    }
+    tuning::load_parameters(filename);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_zone_multiplier(), 40u);
+    BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(), 256u);
+    tuning::reset_multiplication_zone_multiplier();
+    boost::filesystem::remove(filename);
+    BOOST_CHECK_THROW(tuning::load_parameters(filename), std::runtime_error);
+    BOOST_CHECK_THROW(tuning::save_parameters((boost::filesystem::path(filename) / "foo").string()),
+                      std::runtime_error);
+}